@@ -0,0 +1,32 @@
+#ifndef ICARUSPYRO_APPS_OPTIONS_H
+#define ICARUSPYRO_APPS_OPTIONS_H
+
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+
+// Command line options of the table tools, given as `--name value` pairs 
+// anywhere after the positional arguments.
+
+// Checks if an option is present
+inline bool optionExists(int argc, char** argv, const std::string& option)
+{
+    return (std::find(argv, argv + argc, option) != argv + argc);
+}
+
+// Value following an option, or `value` if the option or its value is missing
+inline std::string getOption(int argc, char** argv, const std::string& option, const std::string& value = "")
+{
+    char** ptr = std::find(argv, argv + argc, option);
+    if (ptr == argv + argc || ptr + 1 == argv + argc) return value;
+    return *(ptr + 1);
+}
+
+// Numeric value following an option, or `value` if it is missing
+inline double getOption(int argc, char** argv, const std::string& option, double value)
+{
+    std::string text = getOption(argc, argv, option, std::string());
+    return text.empty() ? value : atof(text.c_str());
+}
+
+#endif
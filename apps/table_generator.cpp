@@ -1,18 +1,29 @@
 #include <stdlib.h> 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 #include "icaruspyro.h"
-
-bool optionExists(int argc, char** argv, const std::string& option);
-std::string getOption(int argc, char** argv, const std::string& option);
+#include "options.h"
 
 int main(int argc, char** argv) {
     if (!(argc > 1)) {
-        std::cout << "Must provide the name of the pyrolysis gas mixture." << std::endl; 
+        std::cout << "Must provide the name of the pyrolysis gas mixture or a --jobs list." << std::endl; 
         return -1;
     }
     std::string pyrogas_mixture(argv[1]);
 
-    double T_low = 200.0;
+    // With a job list, the mixtures and grids are read from the list and the 
+    // options below only provide the defaults.
+    std::string job_list;
+    if (optionExists(argc, argv, "--jobs")) { 
+        job_list = getOption(argc, argv, "--jobs");
+    }
+
+    // In B' mode the mixture is the gas-surface interaction mixture.
+    bool bprime = optionExists(argc, argv, "--bprime");
+
+    double T_low = bprime ? 300.0 : 200.0;
     double T_high = 4000.0;
     int nT = 76;
     double p_low = 1.01325;
@@ -25,6 +36,25 @@ int main(int argc, char** argv) {
 
     std::string mu_algorithm("Wilke");
     std::string k_algorithm("Wilke");
+    int n_threads = 0;
+    double species_threshold = -1.0;
+    std::string cache_directory;
+    int first_row = 0;
+    int last_row = -1;
+    std::string checkpoint_file;
+    bool resume = optionExists(argc, argv, "--resume");
+    bool stream = optionExists(argc, argv, "--stream");
+    // Leave tables whose database already holds them, with the same 
+    // provenance, as they are.
+    bool skip_up_to_date = optionExists(argc, argv, "--skip-up-to-date");
+    std::string profile_file;
+
+    double Bg_low = 0.0;
+    double Bg_high = 10.0;
+    int nBg = 21;
+    std::string Bg_scale("linear");
+    std::string edge_composition("BLedge");
+    std::string pyrolysis_composition("Pyrolysis");
 
     if (optionExists(argc, argv, "--T_low")) { 
         T_low = atof(getOption(argc, argv, "--T_low").c_str());
@@ -58,29 +88,136 @@ int main(int argc, char** argv) {
     if (optionExists(argc, argv, "--database-file")) { 
         database = getOption(argc, argv, "--database-file");
     }
+    if (optionExists(argc, argv, "--threads")) { 
+        n_threads = atoi(getOption(argc, argv, "--threads").c_str());
+    }
+    if (optionExists(argc, argv, "--species-threshold")) { 
+        species_threshold = atof(getOption(argc, argv, "--species-threshold").c_str());
+    }
+    if (optionExists(argc, argv, "--cache-dir")) { 
+        cache_directory = getOption(argc, argv, "--cache-dir");
+    }
+    if (optionExists(argc, argv, "--first-row")) { 
+        first_row = atoi(getOption(argc, argv, "--first-row").c_str());
+    }
+    if (optionExists(argc, argv, "--last-row")) { 
+        last_row = atoi(getOption(argc, argv, "--last-row").c_str());
+    }
+    if (optionExists(argc, argv, "--checkpoint")) { 
+        checkpoint_file = getOption(argc, argv, "--checkpoint");
+    } else if (resume) { 
+        checkpoint_file = database + ".checkpoint";
+    }
+    if (optionExists(argc, argv, "--profile")) { 
+        profile_file = getOption(argc, argv, "--profile");
+    }
+    if (optionExists(argc, argv, "--Bg_low")) { 
+        Bg_low = atof(getOption(argc, argv, "--Bg_low").c_str());
+    }
+    if (optionExists(argc, argv, "--Bg_high")) { 
+        Bg_high = atof(getOption(argc, argv, "--Bg_high").c_str());
+    }
+    if (optionExists(argc, argv, "--nBg")) { 
+        nBg = atoi(getOption(argc, argv, "--nBg").c_str());
+    }
+    if (optionExists(argc, argv, "--Bg_scale")) { 
+        Bg_scale = getOption(argc, argv, "--Bg_scale");
+    }
+    if (optionExists(argc, argv, "--edge-composition")) { 
+        edge_composition = getOption(argc, argv, "--edge-composition");
+    }
+    if (optionExists(argc, argv, "--pyrolysis-composition")) { 
+        pyrolysis_composition = getOption(argc, argv, "--pyrolysis-composition");
+    }
+
+    if (!job_list.empty()) { 
+        IcarusPyro::GenerationJob defaults;
+        defaults.database = database;
+        defaults.T_low = T_low;
+        defaults.T_high = T_high;
+        defaults.nT = nT;
+        defaults.T_scale = T_scale;
+        defaults.p_low = p_low;
+        defaults.p_high = p_high;
+        defaults.nP = nP;
+        defaults.p_scale = p_scale;
+        defaults.species_threshold = species_threshold;
+        int block_size = 16;
+        if (optionExists(argc, argv, "--block")) { 
+            block_size = atoi(getOption(argc, argv, "--block").c_str());
+        }
+        std::vector<IcarusPyro::GenerationJob> jobs = IcarusPyro::readJobList(job_list, defaults);
+        IcarusPyro::runJobs(jobs, mu_algorithm, k_algorithm, n_threads, block_size, cache_directory, 
+                            skip_up_to_date);
+        return 0;
+    }
+
+    // Ensemble mode: perturbed compositions and a comma separated list of
+    // viscosity algorithms, written as subgroups of the mixture group.
+    if (optionExists(argc, argv, "--ensemble")) {
+        int n_perturbed = atoi(getOption(argc, argv, "--ensemble").c_str());
+        double sigma = 0.05;
+        unsigned seed = 1;
+        std::vector<std::string> mu_algorithms;
+        if (optionExists(argc, argv, "--sigma")) {
+            sigma = atof(getOption(argc, argv, "--sigma").c_str());
+        }
+        if (optionExists(argc, argv, "--seed")) {
+            seed = atoi(getOption(argc, argv, "--seed").c_str());
+        }
+        std::string algorithms(mu_algorithm);
+        if (optionExists(argc, argv, "--mu-algorithms")) {
+            algorithms = getOption(argc, argv, "--mu-algorithms");
+        }
+        std::stringstream list(algorithms);
+        std::string algorithm;
+        while (std::getline(list, algorithm, ',')) {
+            if (!algorithm.empty()) mu_algorithms.push_back(algorithm);
+        }
+        IcarusPyro::GasEnsemble ensemble(pyrogas_mixture,
+                                         T_low, T_high, nT, T_scale,
+                                         p_low, p_high, nP, p_scale,
+                                         mu_algorithms, k_algorithm,
+                                         n_perturbed, sigma, seed, n_threads);
+        ensemble.compute();
+        ensemble.write(database, gas_mixture_name);
+        return 0;
+    }
+
+    if (bprime) { 
+        IcarusPyro::SurfaceMixture surface(pyrogas_mixture, 
+                                           T_low, T_high, nT, T_scale, 
+                                           p_low, p_high, nP, p_scale, 
+                                           Bg_low, Bg_high, nBg, Bg_scale, 
+                                           edge_composition, pyrolysis_composition, 
+                                           n_threads);
+        surface.write(database, gas_mixture_name);
+        return 0;
+    }
 
     IcarusPyro::GasMixture gas(pyrogas_mixture, 
                                T_low, T_high, nT, T_scale, 
                                p_low, p_high, nP, p_scale, 
-                               mu_algorithm, k_algorithm);
-    gas.write(database, gas_mixture_name);
-
-    return 0;
-}
-
- // Checks if an option is present
- bool optionExists(int argc, char** argv, const std::string& option)
- {
-    return (std::find(argv, argv+argc, option) != argv+argc);
- }
+                               mu_algorithm, k_algorithm, 
+                               n_threads, species_threshold, 
+                               cache_directory, first_row, last_row, 
+                               checkpoint_file, resume, false);
+    if (skip_up_to_date && IcarusPyro::tableUpToDate(database, gas_mixture_name, gas.provenance())) { 
+        std::cout << database << " already holds " << gas_mixture_name << " with the same provenance." << std::endl;
+        return 0;
+    }
+    if (stream) { 
+        gas.stream(database, gas_mixture_name);
+    } else { 
+        gas.computeProperties();
+        gas.write(database, gas_mixture_name);
+    }
 
-std::string getOption(int argc, char** argv, const std::string& option) { 
-    std::string value;
-    char** ptr = std::find(argv, argv+argc, option);
+    if (!profile_file.empty()) { 
+        gas.profile().print(std::cout);
+        std::ofstream report(profile_file.c_str());
+        gas.profile().writeJson(report, gas_mixture_name);
+    }
 
-    if (ptr == argv+argc || ptr+1 == argv+argc)
-        value = "";
-    else
-        value = *(ptr+1);
-    return value;
+    return 0;
 }
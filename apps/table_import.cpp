@@ -0,0 +1,36 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "icaruspyro.h"
+
+// Convert a legacy Icarus gas table file (gas_table.db) into a gas table 
+// database, in double precision.
+//
+//     table_import <gas_table.db> [<database>] [--gas-mixture-name <name>]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cout << "Usage: table_import <gas_table.db> [<database>] [--gas-mixture-name <name>]" << std::endl;
+        return -1;
+    }
+    std::string legacy_file(argv[1]);
+    std::string database("gas_table.h5");
+    std::string gas_mixture_name;
+
+    if (argc > 2 && std::string(argv[2]).compare(0, 2, "--") != 0) {
+        database = argv[2];
+    }
+    char** option = std::find(argv, argv + argc, std::string("--gas-mixture-name"));
+    if (option != argv + argc && option + 1 != argv + argc) {
+        gas_mixture_name = *(option + 1);
+    }
+
+    try {
+        IcarusPyro::convertLegacyTable(legacy_file, database, gas_mixture_name);
+    } catch (const std::runtime_error& error) {
+        std::cout << "Import failed: " << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "icaruspyro.h"
+
+// Assemble the shards written by `table_generator --first-row i --last-row j`
+// into a single gas table database.
+//
+//     table_merge <database> <shard> [<shard> ...]
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout << "Usage: table_merge <database> <shard> [<shard> ...]" << std::endl;
+        return -1;
+    }
+    std::string database(argv[1]);
+    std::vector<std::string> shards(argv + 2, argv + argc);
+
+    try {
+        IcarusPyro::mergeShards(shards, database);
+    } catch (const std::runtime_error& error) {
+        std::cout << "Merge failed: " << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "icaruspyro.h"
+#include "grid.h"
+#include "options.h"
+
+// Resample a gas table onto uniform temperature and pressure axes, on which
+// lookups locate cells without searching, report the error of each property
+// and write the resampled table to a new database. With --pow2 the number of
+// points of each axis is rounded up to 2^k + 1. The range defaults to that of
+// the source table. Exits with 1 if the maximum relative error of any
+// property exceeds the tolerance.
+//
+//     table_resample <mixture> <output> [--database-file <database>] [--gas-mixture-name <name>]
+//                    [--nT <n>] [--T_low <T>] [--T_high <T>] [--T_scale linear|log10]
+//                    [--nP <n>] [--p_low <p>] [--p_high <p>] [--p_scale linear|log10]
+//                    [--pow2] [--tolerance <tol>]
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout << "Usage: table_resample <mixture> <output> [--database-file <database>] "
+                  << "[--gas-mixture-name <name>] [--nT <n>] [--T_low <T>] [--T_high <T>] "
+                  << "[--T_scale <scale>] [--nP <n>] [--p_low <p>] [--p_high <p>] [--p_scale <scale>] "
+                  << "[--pow2] [--tolerance <tol>]" << std::endl;
+        return -1;
+    }
+    std::string mixture(argv[1]);
+    std::string output(argv[2]);
+    std::string database = getOption(argc, argv, "--database-file", "gas_table.h5");
+    std::string gas_mixture_name = getOption(argc, argv, "--gas-mixture-name", mixture);
+    std::string T_scale = getOption(argc, argv, "--T_scale", "linear");
+    std::string p_scale = getOption(argc, argv, "--p_scale", "log10");
+    bool pow2 = optionExists(argc, argv, "--pow2");
+    double tolerance = getOption(argc, argv, "--tolerance", 0.01);
+
+    try {
+        IcarusPyro::GasTable source(mixture, database);
+        const IcarusPyro::TableEntry<double>* h = source.enthalpy;
+        if (!h || h->nx < 2 || h->ny < 2) {
+            throw std::runtime_error("The gas table of " + mixture + " has no enthalpy table.");
+        }
+        int nT = atoi(getOption(argc, argv, "--nT", std::to_string(h->nx)).c_str());
+        int nP = atoi(getOption(argc, argv, "--nP", std::to_string(h->ny)).c_str());
+        if (pow2) {
+            nT = IcarusPyro::powerOfTwoPoints(nT);
+            nP = IcarusPyro::powerOfTwoPoints(nP);
+        }
+        std::vector<double> temperature, pressure;
+        IcarusPyro::makeRange(getOption(argc, argv, "--T_low", h->x[0]),
+                              getOption(argc, argv, "--T_high", h->x[h->nx-1]), nT, T_scale, temperature);
+        IcarusPyro::makeRange(getOption(argc, argv, "--p_low", h->y[0]),
+                              getOption(argc, argv, "--p_high", h->y[h->ny-1]), nP, p_scale, pressure);
+
+        std::cout << "Resampling " << mixture << " from " << h->nx << " x " << h->ny
+                  << " to " << nT << " x " << nP << " points" << std::endl;
+        IcarusPyro::ValidationReport report;
+        IcarusPyro::GasTable table = IcarusPyro::resampleTable(source, temperature, T_scale,
+                                                               pressure, p_scale, report);
+        report.print(std::cout, tolerance);
+        table.write(output, gas_mixture_name);
+        if (!report.passed(tolerance)) {
+            std::cout << "Resampling error above tolerance " << tolerance << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& error) {
+        std::cout << "Resampling failed: " << error.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
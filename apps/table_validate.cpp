@@ -0,0 +1,51 @@
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "icaruspyro.h"
+#include "options.h"
+
+// Check the interpolation error of a gas table against direct Mutation++
+// equilibrium at the cell midpoints and at random points. Exits with 1 if
+// the maximum relative error of any property exceeds the tolerance, so it
+// can gate the release of a table.
+//
+//     table_validate <mixture> [--database-file <database>] [--gas-mixture-name <name>]
+//                    [--random <n>] [--seed <n>] [--threads <n>] [--tolerance <tol>]
+//                    [--mu <algorithm>] [--k <algorithm>]
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cout << "Usage: table_validate <mixture> [--database-file <database>] "
+                  << "[--gas-mixture-name <name>] [--random <n>] [--seed <n>] [--threads <n>] "
+                  << "[--tolerance <tol>] [--mu <algorithm>] [--k <algorithm>]" << std::endl;
+        return -1;
+    }
+    std::string mixture(argv[1]);
+    std::string database = getOption(argc, argv, "--database-file", "gas_table.h5");
+    std::string gas_mixture_name = getOption(argc, argv, "--gas-mixture-name", mixture);
+    int n_random = atoi(getOption(argc, argv, "--random", "1000").c_str());
+    unsigned seed = atoi(getOption(argc, argv, "--seed", "1").c_str());
+    int n_threads = atoi(getOption(argc, argv, "--threads", "0").c_str());
+    double tolerance = getOption(argc, argv, "--tolerance", 0.01);
+    std::string mu_algorithm = getOption(argc, argv, "--mu", "Wilke");
+    std::string k_algorithm = getOption(argc, argv, "--k", "Wilke");
+
+    try {
+        IcarusPyro::GasTable table(gas_mixture_name, database);
+        IcarusPyro::ValidationReport report =
+            IcarusPyro::validateTable(table, mixture, mu_algorithm, k_algorithm,
+                                      n_random, n_threads, seed);
+        report.print(std::cout, tolerance);
+        if (!report.passed(tolerance)) {
+            std::cout << "Validation failed: tolerance " << tolerance << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& error) {
+        std::cout << "Validation failed: " << error.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -1,17 +1,27 @@
 #include <string>
+#include <vector>
+
+#include "icaruspyro.h"
 
 int main() {
 
-    const std::string material = 'TACOT';
-    const std::string pyrolysis_gas_mixture = 'TACOT-Pyro';
-    const std::string gas_surface_mixture = 'TACOT-Pyro-GSI';
+    const std::string material = "tacot.yaml";
+    const std::string pyrolysis_gas_mixture = "24sp-tacot-pyro";
+    const std::string gas_surface_mixture = "TACOT-Pyro-GSI";
 
     // Initialize a Pyro object. 
 
-    Pyro = IcarusPyro(material, pyrolysis_gas_mixture, gas_surface_mixture);
+    IcarusPyro::Pyro pyro(material, pyrolysis_gas_mixture, gas_surface_mixture, "gas_table.h5");
+
+    // Evaluate the solid and gas properties of a batch of cells in one pass.
+
+    std::vector<double> T(100, 1000.0);
+    std::vector<double> p(100, 101325.0);
+    std::vector<double> rho_s(100, 250.0);
+    IcarusPyro::PyroState state;
+    pyro.evaluate(T, p, rho_s, state);
 
-    double rho_s = Pyro->Material.get_density();
-    double rho_g = Pyro->GasMixture.get_density();
-    double b_prime = Pyro->GSI.get_bprime();
-   
-}
\ No newline at end of file
+    double rho_v = pyro.get_material().get_virgin_density();
+    double rho_g = state.gas_density[0];
+    // double b_prime = Pyro->GSI.get_bprime();
+}
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include "gas_table.h"
+#include "parallel.h"
+#include "pyrolysis_gas.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+using namespace IcarusPyro;
+
+namespace {
+
+// Float64 arrays in C order are viewed in place; anything else is converted
+// once on the way in.
+typedef py::array_t<double, py::array::c_style | py::array::forcecast> DoubleArray;
+
+// Points per task of a batched lookup.
+const py::ssize_t LOOKUP_CHUNK = 4096;
+
+std::vector<py::ssize_t> shapeOf(const py::buffer_info& info)
+{
+    return std::vector<py::ssize_t>(info.shape.begin(), info.shape.end());
+}
+
+/**
+ * Look up every point of the arrays `temperature` and `pressure` into the
+ * arrays out[q] of property q (see GasTable::properties), skipping the null
+ * ones, in chunks spread over `threads` threads with the GIL released. Each
+ * point is looked up exactly as GasTable::lookup does in the solver.
+ */
+void lookupPoints(const GasTable& table, const DoubleArray& temperature, const DoubleArray& pressure, 
+                  double* const* out, int threads)
+{
+    const double* T = temperature.data();
+    const double* p = pressure.data();
+    py::ssize_t n = temperature.size();
+
+    py::gil_scoped_release release;
+    int chunks = static_cast<int>((n + LOOKUP_CHUNK - 1) / LOOKUP_CHUNK);
+    int nthreads = std::max(1, std::min(numThreads(threads), chunks));
+    parallelFor(chunks, nthreads, [&](int t, int c) {
+        py::ssize_t end = std::min(n, (c + 1) * LOOKUP_CHUNK);
+        GasProperties props;
+        for (py::ssize_t k = c * LOOKUP_CHUNK; k < end; k++) {
+            table.lookup(T[k], p[k], props);
+            for (int q = 0; q < GasTable::N_PROPERTIES; q++) {
+                if (out[q]) out[q][k] = props.*GasTable::properties[q];
+            }
+        }
+    });
+}
+
+std::vector<py::ssize_t> pointsShape(const DoubleArray& temperature, const DoubleArray& pressure)
+{
+    std::vector<py::ssize_t> shape = shapeOf(temperature.request());
+    if (shape != shapeOf(pressure.request())) {
+        throw std::runtime_error("Temperature and pressure arrays must have the same shape.");
+    }
+    return shape;
+}
+
+/**
+ * Gas table properties of every point of the arrays `temperature` and
+ * `pressure` (of any, but the same, shape) as a dict of new arrays of that 
+ * shape, see lookupPoints.
+ */
+py::dict lookup(const GasTable& table, DoubleArray temperature, DoubleArray pressure, int threads)
+{
+    std::vector<py::ssize_t> shape = pointsShape(temperature, pressure);
+    std::vector<DoubleArray> outputs;
+    double* out[GasTable::N_PROPERTIES];
+    for (int q = 0; q < GasTable::N_PROPERTIES; q++) {
+        outputs.push_back(DoubleArray(shape));
+        out[q] = outputs.back().mutable_data();
+    }
+    lookupPoints(table, temperature, pressure, out, threads);
+
+    py::dict result;
+    for (int q = 0; q < GasTable::N_PROPERTIES; q++) result[GasTable::propertyName(q).c_str()] = outputs[q];
+    return result;
+}
+
+/**
+ * As lookup, but writing the properties named in `out` into its arrays,
+ * which must be writable float64 arrays in C order of the shape of the
+ * points: they are never converted, so that the results land in the
+ * caller's buffers. The other properties are not computed into anything.
+ *
+ * @return `out`.
+ */
+py::dict lookupInto(const GasTable& table, DoubleArray temperature, DoubleArray pressure, 
+                    py::dict out, int threads)
+{
+    std::vector<py::ssize_t> shape = pointsShape(temperature, pressure);
+    double* buffers[GasTable::N_PROPERTIES] = {};
+    for (auto item : out) {
+        std::string name = item.first.cast<std::string>();
+        int q = 0;
+        while (q < GasTable::N_PROPERTIES && GasTable::propertyName(q) != name) q++;
+        if (q == GasTable::N_PROPERTIES) {
+            throw std::runtime_error("Unknown gas table property " + name + ".");
+        }
+        if (!py::isinstance<py::array_t<double>>(item.second)) {
+            throw std::runtime_error("The output array of " + name + " must be a float64 array.");
+        }
+        py::array array = py::reinterpret_borrow<py::array>(item.second);
+        if (!(array.flags() & py::array::c_style)) {
+            throw std::runtime_error("The output array of " + name + " must be C contiguous.");
+        }
+        if (!array.writeable()) {
+            throw std::runtime_error("The output array of " + name + " is read-only.");
+        }
+        if (std::vector<py::ssize_t>(array.shape(), array.shape() + array.ndim()) != shape) {
+            throw std::runtime_error("The output array of " + name + " must have the shape of the points.");
+        }
+        buffers[q] = static_cast<double*>(array.mutable_data());
+    }
+    lookupPoints(table, temperature, pressure, buffers, threads);
+    return out;
+}
+
+/**
+ * Properties at a single point, from GasTable::lookup.
+ */
+py::dict lookupPoint(const GasTable& table, double temperature, double pressure)
+{
+    GasProperties props;
+    table.lookup(temperature, pressure, props);
+    py::dict result;
+    for (int q = 0; q < GasTable::N_PROPERTIES; q++) {
+        result[GasTable::propertyName(q).c_str()] = props.*GasTable::properties[q];
+    }
+    return result;
+}
+
+/**
+ * Read-only view of an axis of the enthalpy table, kept alive by the table.
+ */
+DoubleArray axis(py::object self, bool temperature)
+{
+    const GasTable& table = self.cast<const GasTable&>();
+    const TableEntry<double>* h = table.enthalpy;
+    if (!h) throw std::runtime_error("The gas table has no enthalpy table.");
+    DoubleArray view(temperature ? h->nx : h->ny, temperature ? h->x : h->y, self);
+    view.attr("setflags")("write"_a = false);
+    return view;
+}
+
+} // namespace
+
+PYBIND11_MODULE(icaruspyro, m) {
+    m.doc() = "Pyrolysis gas tables of the IcarusPyro library.";
+
+    py::class_<GasTable>(m, "GasTable")
+        .def(py::init<const std::string&, const std::string&>(),
+             "mixture"_a, "database"_a = "gas_table.h5",
+             "Load the gas table of a mixture from an HDF5 database.")
+        .def("lookup", &lookup, "temperature"_a, "pressure"_a, "threads"_a = 0,
+             "Properties at arrays of temperatures and pressures, as a dict of arrays.")
+        .def("lookup", &lookupInto, "temperature"_a, "pressure"_a, "out"_a, "threads"_a = 0,
+             "Write the properties named in the dict `out` into its arrays (float64, C order, "
+             "writable, of the shape of the points) and return it.")
+        .def("lookup_point", &lookupPoint, "temperature"_a, "pressure"_a,
+             "Properties at a single temperature and pressure, as a dict of floats.")
+        .def("in_range", &GasTable::inRange, "temperature"_a, "pressure"_a)
+        .def("species_index", &GasTable::speciesIndex, "name"_a)
+        .def_readonly("mixture", &GasTable::pyrolysis_gas)
+        .def_readonly("species_names", &GasTable::species_names)
+        .def_property_readonly("shared_axes", &GasTable::sharedAxes)
+        .def_property_readonly("temperature", [](py::object self) { return axis(self, true); })
+        .def_property_readonly("pressure", [](py::object self) { return axis(self, false); });
+
+    py::class_<GasMixture>(m, "GasMixture")
+        .def(py::init([](std::string mixture,
+                         double T_low, double T_high, int nT, const std::string& T_scale,
+                         double p_low, double p_high, int nP, const std::string& p_scale,
+                         const std::string& mu_algorithm, const std::string& k_algorithm,
+                         int threads, double species_threshold, const std::string& cache_directory) {
+                 py::gil_scoped_release release;
+                 return new GasMixture(mixture, T_low, T_high, nT, T_scale, p_low, p_high, nP, p_scale,
+                                       mu_algorithm, k_algorithm, threads, species_threshold,
+                                       cache_directory);
+             }),
+             "mixture"_a, "T_low"_a = 200.0, "T_high"_a = 4000.0, "nT"_a = 76, "T_scale"_a = "linear",
+             "p_low"_a = 1.01325, "p_high"_a = 1013250.0, "nP"_a = 6, "p_scale"_a = "log10",
+             "mu_algorithm"_a = "Chapmann-Enskog_CG", "k_algorithm"_a = "Wilke", "threads"_a = 0,
+             "species_threshold"_a = -1.0, "cache_directory"_a = "",
+             "Generate the gas table of a Mutation++ mixture on a temperature and pressure grid.")
+        .def("write", [](GasMixture& gas, const std::string& database, const std::string& name) {
+                 py::gil_scoped_release release;
+                 gas.write(database, name);
+             },
+             "database"_a = "gas_table.h5", "gas_mixture_name"_a = "",
+             "Write the table to an HDF5 database, to be loaded as a GasTable.");
+}
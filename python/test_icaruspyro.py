@@ -0,0 +1,66 @@
+# Tests of the icaruspyro module, run by ctest (see CMakeLists.txt) with the
+# module on PYTHONPATH.
+import os
+
+import numpy as np
+import pytest
+
+import icaruspyro
+
+DATABASE = os.path.join(os.path.dirname(__file__), "..", "data", "gas_table.h5")
+MIXTURE = "24sp-tacot-pyro"
+PROPERTIES = ["cp", "cv", "eint", "enthalpy", "mw", "density",
+              "viscosity", "conductivity", "reactive_conductivity"]
+
+
+@pytest.fixture(scope="module")
+def table():
+    return icaruspyro.GasTable(MIXTURE, DATABASE)
+
+
+@pytest.fixture(scope="module")
+def points(table):
+    rng = np.random.default_rng(1)
+    T = rng.uniform(table.temperature[0], table.temperature[-1], (50, 41))
+    p = np.exp(rng.uniform(np.log(table.pressure[0]), np.log(table.pressure[-1]), T.shape))
+    return T, p
+
+
+def test_lookup_matches_the_library(table, points):
+    T, p = points
+    props = table.lookup(T, p, threads=2)
+    assert sorted(props) == sorted(PROPERTIES)
+    for i, j in np.ndindex(T.shape):
+        reference = table.lookup_point(T[i, j], p[i, j])
+        for name in PROPERTIES:
+            assert props[name].shape == T.shape
+            assert props[name][i, j] == reference[name]
+
+
+def test_lookup_writes_into_out(table, points):
+    T, p = points
+    expected = table.lookup(T, p)
+    out = {"enthalpy": np.empty_like(T), "density": np.empty_like(T)}
+    buffers = {name: array.ctypes.data for name, array in out.items()}
+    assert table.lookup(T, p, out=out, threads=3) is out
+    for name, array in out.items():
+        assert array.ctypes.data == buffers[name]
+        np.testing.assert_array_equal(array, expected[name])
+
+
+def test_lookup_rejects_invalid_out(table, points):
+    T, p = points
+    with pytest.raises(RuntimeError, match="float64"):
+        table.lookup(T, p, out={"enthalpy": np.empty(T.shape, dtype=np.float32)})
+    with pytest.raises(RuntimeError, match="contiguous"):
+        table.lookup(T, p, out={"enthalpy": np.empty(T.shape[::-1]).T})
+    with pytest.raises(RuntimeError, match="shape"):
+        table.lookup(T, p, out={"enthalpy": np.empty(T.size)})
+    read_only = np.empty_like(T)
+    read_only.setflags(write=False)
+    with pytest.raises(RuntimeError, match="read-only"):
+        table.lookup(T, p, out={"enthalpy": read_only})
+    with pytest.raises(RuntimeError, match="Unknown"):
+        table.lookup(T, p, out={"entropy": np.empty_like(T)})
+    with pytest.raises(RuntimeError, match="same shape"):
+        table.lookup(T, p[:10])
@@ -0,0 +1,162 @@
+#include <string>
+#include <iostream>
+#include <stdexcept>
+
+#include "bprime_table.h"
+
+using namespace H5;
+
+namespace IcarusPyro { 
+
+BprimeTable::BprimeTable(const std::string& surface_gas_mixture, const std::string& database) 
+    : surface_gas(surface_gas_mixture),
+      bg_scale("linear")
+{
+    H5std_string FILE_NAME(database);
+    H5File* file(nullptr);
+    Group* surface(nullptr);
+    DataSet* bg_data(nullptr);
+    try { 
+        Exception::dontPrint();
+        file = new H5File(FILE_NAME, H5F_ACC_RDONLY);
+        surface = new Group(file->openGroup(surface_gas));
+        bg_data = new DataSet(surface->openDataSet(H5Names.bprime_g));
+    } catch (const Exception&) { 
+        delete surface;
+        delete file;
+        throw std::runtime_error("Could not find B' data for " + surface_gas + " in the database.");
+    }
+
+    Attribute attr = bg_data->openAttribute(H5Names.bprime_g_scale);
+    H5std_string buffer("");
+    attr.read(attr.getDataType(), buffer);
+    bg_scale = buffer;
+
+    hsize_t dims[1];
+    DataSpace bg_dataspace = bg_data->getSpace();
+    bg_dataspace.getSimpleExtentDims(dims, nullptr);
+    bg.resize(dims[0]);
+    bg_data->read(bg.data(), PredType::NATIVE_DOUBLE);
+    delete bg_data;
+
+    for (size_t k = 0; k < bg.size(); k++) { 
+        bc.push_back(readTableEntry(surface, H5Names.slice(H5Names.bprime_c, k)));
+        wall_enthalpy.push_back(readTableEntry(surface, H5Names.slice(H5Names.wall_enthalpy, k)));
+    }
+
+    delete surface;
+    delete file;
+}
+
+void BprimeTable::clear()
+{
+    for (size_t k = 0; k < bc.size(); k++) delete bc[k];
+    for (size_t k = 0; k < wall_enthalpy.size(); k++) delete wall_enthalpy[k];
+    bc.clear();
+    wall_enthalpy.clear();
+}
+
+void BprimeTable::load(std::string T_scale, 
+                       std::string p_scale, 
+                       std::string Bg_scale,
+                       std::vector<double>& T, 
+                       std::vector<double>& p, 
+                       std::vector<double>& Bg,
+                       std::vector<std::vector<std::vector<double>>>& Bc,
+                       std::vector<std::vector<std::vector<double>>>& hw)
+{
+    clear();
+    bg = Bg;
+    bg_scale = Bg_scale;
+
+    int nx = T.size();
+    int ny = p.size();
+    for (size_t k = 0; k < bg.size(); k++) { 
+        TableEntry<double>* c = new TableEntry<double>(nx, ny, "temperature", "pressure", T_scale, p_scale);
+        TableEntry<double>* h = new TableEntry<double>(nx, ny, "temperature", "pressure", T_scale, p_scale);
+        for (int i = 0; i < nx; i++) { 
+            c->x[i] = T[i];
+            h->x[i] = T[i];
+        }
+        for (int j = 0; j < ny; j++) { 
+            c->y[j] = p[j];
+            h->y[j] = p[j];
+        }
+        for (int j = 0; j < ny; j++) { 
+            for (int i = 0; i < nx; i++) { 
+                (*c->z)(i,j) = Bc[k][j][i];
+                (*h->z)(i,j) = hw[k][j][i];
+            }
+        }
+        bc.push_back(c);
+        wall_enthalpy.push_back(h);
+    }
+}
+
+void BprimeTable::write(std::string database, std::string surface_mixture_name)
+{
+    std::string surface_name(surface_gas);
+    if (!(surface_mixture_name.empty())) { 
+        surface_name = surface_mixture_name;
+    } 
+    std::cout << "Writing database file : " << database 
+              << " for surface mixture : " << surface_name << std::endl;
+
+    H5File* file = openDatabase(database);
+    if (!file) return;
+    Group* root = new Group(file->openGroup("/"));
+    Group* surface = replaceGroup(root, surface_name);
+    delete root;
+
+    hsize_t dims[1];
+    dims[0] = bg.size();
+    DataSpace bg_dataspace(1, dims);
+    DataSet* bg_data = new DataSet(surface->createDataSet(H5Names.bprime_g, PredType::NATIVE_DOUBLE, bg_dataspace));
+    bg_data->write(bg.data(), PredType::NATIVE_DOUBLE);
+
+    StrType stype(PredType::C_S1, H5T_VARIABLE);
+    stype.setCset(H5T_CSET_ASCII);
+    Attribute attr = bg_data->createAttribute(H5Names.bprime_g_scale, stype, DataSpace(H5S_SCALAR));
+    H5std_string buffer(bg_scale);
+    attr.write(stype, buffer);
+    delete bg_data;
+
+    std::cout << "   Writing B'c and wall enthalpy data " << std::endl;
+    for (size_t k = 0; k < bg.size(); k++) { 
+        writeTableEntry(surface, H5Names.slice(H5Names.bprime_c, k), bc[k]);
+        writeTableEntry(surface, H5Names.slice(H5Names.wall_enthalpy, k), wall_enthalpy[k]);
+    }
+
+    delete surface;
+    delete file;
+}
+
+void BprimeTable::lookup(const std::vector<double>& temperature, 
+                         const std::vector<double>& pressure,
+                         const std::vector<double>& Bg,
+                         std::vector<double>& Bc, 
+                         std::vector<double>& hw) const
+{
+    size_t n = temperature.size();
+    Bc.resize(n);
+    hw.resize(n);
+    if (bg.empty()) return;
+
+    int nbg = bg.size();
+    bool log_scale = (bg_scale == "log10");
+    for (size_t f = 0; f < n; f++) { 
+        TableIndex idx = bc[0]->locate(temperature[f], pressure[f]);
+
+        int k;
+        double w, dw;
+        TableEntry<double>::locateAxis(bg.data(), nbg, log_scale, Bg[f], k, w, dw);
+        int k1 = (nbg > 1) ? k + 1 : k;
+
+        double c0 = bc[k]->interpolate(idx);
+        double h0 = wall_enthalpy[k]->interpolate(idx);
+        Bc[f] = c0 + w * (bc[k1]->interpolate(idx) - c0);
+        hw[f] = h0 + w * (wall_enthalpy[k1]->interpolate(idx) - h0);
+    }
+}
+
+} // namespace IcarusPyro
@@ -0,0 +1,112 @@
+#ifndef ICARUSPYRO_BPRIME_TABLE_H
+#define ICARUSPYRO_BPRIME_TABLE_H
+
+#include <string>
+#include <vector>
+
+#include "table_entry.h"
+#include "gas_table.h"
+
+namespace IcarusPyro {
+
+/**
+ * Tabulated B' surface ablation data: the char ablation rate B'_c and the 
+ * wall enthalpy h_w as functions of wall temperature, pressure and the 
+ * pyrolysis gas blowing rate B'_g. Each B'_g value is stored as a 
+ * temperature-pressure TableEntry, using the same layout as the GasTable.
+ */
+class BprimeTable { 
+public:
+    /** 
+     * Object constructor used for generating a B' table database.
+     * 
+     * @param surface_gas_mixture The name of the gas-surface interaction mixture.
+     */
+    BprimeTable(const std::string& surface_gas_mixture)
+        : surface_gas(surface_gas_mixture),
+          bg_scale("linear") {}
+
+    /** 
+     * A constructor that will initialize the object from a previous B' table
+     * database.
+     * 
+     * @param surface_gas_mixture The name of the gas-surface interaction mixture.
+     * @param database The name (and/or full path) of the database.
+     */
+    BprimeTable(const std::string& surface_gas_mixture, const std::string& database);
+
+    /**
+     * B' tables own their table entries: they can be moved but not copied.
+     */
+    BprimeTable(const BprimeTable&) = delete;
+    BprimeTable& operator=(const BprimeTable&) = delete;
+    BprimeTable(BprimeTable&&) = default;
+
+    /**
+     * Object deconstructor.
+     */
+    ~BprimeTable() { 
+        clear();
+    }
+
+    /** 
+     * Write the B' data to an HDF5 database file. Other mixtures already in
+     * the database are kept.
+     * 
+     * @param[in] database Name or full path of the database file. Default is gas_table.h5.
+     */
+    void write(std::string database="gas_table.h5", std::string surface_mixture_name="");
+
+    /**
+     * Set the B' table data.
+     * 
+     * @param[in] T_scale Scale of the wall temperature, linear or log10.
+     * @param[in] p_scale Scale of the pressure, linear or log10.
+     * @param[in] Bg_scale Scale of the pyrolysis gas blowing rate, linear or log10.
+     * @param[in] T Wall temperatures.
+     * @param[in] p Pressures.
+     * @param[in] Bg Pyrolysis gas blowing rates, B'_g.
+     * @param[in] Bc Char ablation rates indexed as [B'_g][pressure][temperature].
+     * @param[in] hw Wall enthalpies indexed as [B'_g][pressure][temperature].
+     */
+    void load(std::string T_scale, 
+              std::string p_scale, 
+              std::string Bg_scale,
+              std::vector<double>& T, 
+              std::vector<double>& p, 
+              std::vector<double>& Bg,
+              std::vector<std::vector<std::vector<double>>>& Bc,
+              std::vector<std::vector<std::vector<double>>>& hw);
+
+    /**
+     * Interpolate B'_c and the wall enthalpy for a batch of surface faces. The
+     * (T, p) cell is located once per face and shared by both properties and
+     * by the two bracketing B'_g slices.
+     * 
+     * @param[in] temperature Wall temperature of each face.
+     * @param[in] pressure Pressure of each face.
+     * @param[in] Bg Pyrolysis gas blowing rate, B'_g, of each face.
+     * @param[out] Bc Char ablation rate, B'_c, of each face.
+     * @param[out] hw Wall enthalpy of each face.
+     */
+    void lookup(const std::vector<double>& temperature, 
+                const std::vector<double>& pressure,
+                const std::vector<double>& Bg,
+                std::vector<double>& Bc, 
+                std::vector<double>& hw) const;
+
+    std::string surface_gas;
+    std::string bg_scale;
+    std::vector<double> bg;
+    std::vector<TableEntry<double>*> bc;
+    std::vector<TableEntry<double>*> wall_enthalpy;
+
+private:
+
+    HDF5Names H5Names;
+
+    void clear();
+};
+
+} // end namespace IcarusPyro
+#endif
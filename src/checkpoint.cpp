@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "checkpoint.h"
+
+namespace IcarusPyro { 
+
+namespace { 
+
+const char CHECKPOINT_MAGIC[8] = {'I', 'P', 'C', 'K', 'P', 'T', '1', '\0'};
+
+} // namespace
+
+RowCheckpoint::RowCheckpoint(const std::string& file_name, uint64_t fingerprint, size_t row_size, bool resume)
+    : file_name(file_name),
+      fingerprint(fingerprint),
+      row_size(row_size)
+{
+    if (resume) { 
+        std::ifstream file(file_name.c_str(), std::ios::binary);
+        char magic[8];
+        uint64_t stored_fingerprint = 0;
+        uint64_t stored_size = 0;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&stored_fingerprint), sizeof(stored_fingerprint));
+        file.read(reinterpret_cast<char*>(&stored_size), sizeof(stored_size));
+        if (file && std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) == 0 && 
+            stored_fingerprint == fingerprint && stored_size == row_size) { 
+            // A row cut short by an interrupted run is ignored.
+            int32_t j;
+            std::vector<double> values(row_size);
+            while (file.read(reinterpret_cast<char*>(&j), sizeof(j)) && 
+                   file.read(reinterpret_cast<char*>(values.data()), row_size * sizeof(double))) { 
+                rows[j] = values;
+            }
+        } else if (file) { 
+            std::cout << "Checkpoint " << file_name << " does not match this run and is discarded." << std::endl;
+        }
+    }
+
+    // Rewrite the file with the rows kept, which also drops a partial last row.
+    std::ofstream file(file_name.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file) { 
+        throw std::runtime_error("Could not open checkpoint file " + file_name + ".");
+    }
+    uint64_t stored_size = row_size;
+    file.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    file.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+    file.write(reinterpret_cast<const char*>(&stored_size), sizeof(stored_size));
+    for (auto it = rows.begin(); it != rows.end(); ++it) { 
+        int32_t j = it->first;
+        file.write(reinterpret_cast<const char*>(&j), sizeof(j));
+        file.write(reinterpret_cast<const char*>(it->second.data()), row_size * sizeof(double));
+    }
+}
+
+const double* RowCheckpoint::row(int j) const
+{
+    auto it = rows.find(j);
+    return (it == rows.end()) ? nullptr : it->second.data();
+}
+
+void RowCheckpoint::save(int j, const double* values)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ofstream file(file_name.c_str(), std::ios::binary | std::ios::app);
+    if (!file) return;
+    int32_t row = j;
+    file.write(reinterpret_cast<const char*>(&row), sizeof(row));
+    file.write(reinterpret_cast<const char*>(values), row_size * sizeof(double));
+}
+
+void RowCheckpoint::remove()
+{
+    std::remove(file_name.c_str());
+}
+
+} // namespace IcarusPyro
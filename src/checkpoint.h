@@ -0,0 +1,73 @@
+#ifndef ICARUSPYRO_CHECKPOINT_H
+#define ICARUSPYRO_CHECKPOINT_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace IcarusPyro {
+
+/**
+ * Checkpoint of the completed rows of a table generation run.
+ * 
+ * Each completed row is appended to the checkpoint file (and flushed) as soon
+ * as it is finished, so an interrupted run loses at most the rows in flight.
+ * The file starts with a fingerprint of the run (mixture, composition, 
+ * algorithms, grid and species threshold); a file with a different 
+ * fingerprint or row size is never resumed.
+ */
+class RowCheckpoint { 
+public:
+    /**
+     * @param[in] file_name Name of the checkpoint file.
+     * @param[in] fingerprint Hash identifying the run, see MemoCache::makeKey.
+     * @param[in] row_size Number of values stored per row.
+     * @param[in] resume Load the completed rows of an existing checkpoint 
+     *     file. Otherwise the file is started over.
+     */
+    RowCheckpoint(const std::string& file_name, uint64_t fingerprint, size_t row_size, bool resume);
+
+    /**
+     * True if row `j` was completed by a previous run.
+     */
+    bool completed(int j) const { 
+        return rows.count(j) > 0;
+    }
+
+    /**
+     * Values of a completed row, or nullptr.
+     */
+    const double* row(int j) const;
+
+    /**
+     * Number of rows completed by previous runs.
+     */
+    size_t completedRows() const { 
+        return rows.size();
+    }
+
+    /**
+     * Append a completed row to the checkpoint file. Thread safe.
+     */
+    void save(int j, const double* values);
+
+    /**
+     * Delete the checkpoint file, once its results are safely written.
+     */
+    void remove();
+
+    std::string path() const { return file_name; }
+
+private:
+    std::string file_name;
+    uint64_t fingerprint;
+    size_t row_size;
+    std::map<int, std::vector<double>> rows;
+    std::mutex mutex;
+};
+
+} // namespace IcarusPyro
+
+#endif
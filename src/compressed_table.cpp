@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <Eigen/Dense>
+
+#include "compressed_table.h"
+
+namespace IcarusPyro {
+
+namespace {
+
+/**
+ * Chebyshev series sum_k c[k] T_k(u) by Clenshaw's recurrence.
+ */
+double chebyshev(const double* c, int n, double u)
+{
+    double b1 = 0.0, b2 = 0.0;
+    for (int k = n - 1; k > 0; k--) {
+        double b0 = 2.0 * u * b1 - b2 + c[k];
+        b2 = b1;
+        b1 = b0;
+    }
+    return u * b1 - b2 + c[0];
+}
+
+double mapToUnit(double s, double low, double high)
+{
+    return (high > low) ? (2.0 * s - low - high) / (high - low) : 0.0;
+}
+
+// Fractions of each cell at which a fit is also compared with the linear
+// interpolant of the dense table.
+const double CELL_CHECKS[] = {0.25, 0.5, 0.75};
+
+/**
+ * Least squares Chebyshev fit of degree `degree` to the points (s, z) of
+ * [low, high]; returns the largest error at the points and, inside each 
+ * cell, against the linear interpolant of the points. Fits of the points
+ * alone may swing far from the table between them.
+ */
+double fitSegment(const double* s, const double* z, int n, int degree, std::vector<double>& c)
+{
+    double low = s[0], high = s[n-1];
+    Eigen::MatrixXd A(n, degree + 1);
+    Eigen::VectorXd b(n);
+    for (int i = 0; i < n; i++) {
+        double u = mapToUnit(s[i], low, high);
+        A(i, 0) = 1.0;
+        if (degree > 0) A(i, 1) = u;
+        for (int k = 2; k <= degree; k++) A(i, k) = 2.0 * u * A(i, k-1) - A(i, k-2);
+        b(i) = z[i];
+    }
+    Eigen::VectorXd x = A.colPivHouseholderQr().solve(b);
+    c.assign(x.data(), x.data() + degree + 1);
+
+    double error = 0.0;
+    for (int i = 0; i < n; i++) {
+        error = std::max(error, std::abs(chebyshev(c.data(), degree + 1, mapToUnit(s[i], low, high)) - z[i]));
+        if (i == n - 1) break;
+        for (double f : CELL_CHECKS) {
+            double sp = s[i] + f * (s[i+1] - s[i]);
+            double zp = z[i] + f * (z[i+1] - z[i]);
+            error = std::max(error, std::abs(chebyshev(c.data(), degree + 1, mapToUnit(sp, low, high)) - zp));
+        }
+    }
+    return error;
+}
+
+} // namespace
+
+CompressedEntry::CompressedEntry(const TableEntry<double>& table, double tolerance, int max_degree)
+    : nx(table.nx),
+      ny(table.ny),
+      x_variable(table.x_variable),
+      y_variable(table.y_variable),
+      x_scale(table.x_scale),
+      y_scale(table.y_scale),
+      x_log(table.x_scale == "log10"),
+      y_log(table.y_scale == "log10"),
+      max_degree(max_degree),
+      x_low(table.x[0]),
+      x_high(table.x[table.nx-1]),
+      y(table.y, table.y + table.ny),
+      max_error(0.0)
+{
+    if (!(tolerance >= 0.0) || this->max_degree < 1) {
+        throw std::runtime_error("Invalid tolerance or degree for compressing " + x_variable + " table.");
+    }
+
+    std::vector<double> s(nx);
+    std::vector<double> z(nx);
+    for (int i = 0; i < nx; i++) {
+        s[i] = x_log ? std::log10(table.x[i]) : table.x[i];
+    }
+
+    row_start.push_back(0);
+    coefficient_start.push_back(0);
+    for (int j = 0; j < ny; j++) {
+        double largest = 0.0;
+        for (int i = 0; i < nx; i++) {
+            z[i] = (*table.z)(i, j);
+            largest = std::max(largest, std::abs(z[i]));
+        }
+        double bound = tolerance * largest;
+        size_t first_segment = lower.size();
+        size_t first_coefficient = coefficients.size();
+        double error = fitRow(s.data(), z.data(), nx, bound);
+
+        // Rows that need more than their dense values, e.g. those of short 
+        // segments between kinks, are kept dense and exact.
+        size_t n_segments = lower.size() - first_segment;
+        size_t fitted_bytes = sizeof(double) * (2 * n_segments + coefficients.size() - first_coefficient)
+                            + sizeof(int) * n_segments;
+        if (fitted_bytes >= sizeof(double) * nx) {
+            lower.resize(first_segment);
+            upper.resize(first_segment);
+            coefficients.resize(first_coefficient);
+            coefficient_start.resize(first_segment + 1);
+            if (grid.empty()) grid = s;
+            row_values.push_back(static_cast<int>(values.size()));
+            values.insert(values.end(), z.begin(), z.end());
+            error = 0.0;
+        } else {
+            row_values.push_back(-1);
+        }
+        if (largest > 0.0) max_error = std::max(max_error, error / largest);
+        row_start.push_back(static_cast<int>(lower.size()));
+    }
+}
+
+double CompressedEntry::fitRow(const double* s, const double* z, int n, double bound)
+{
+    std::vector<double> c, best;
+    double row_error = 0.0;
+    if (n == 1) {
+        lower.push_back(s[0]);
+        upper.push_back(s[0]);
+        coefficients.push_back(z[0]);
+        coefficient_start.push_back(static_cast<int>(coefficients.size()));
+        return 0.0;
+    }
+
+    // Grow each segment from grid point a while a fit within the bound
+    // exists. The degree grows with the number of points (keeping the fit
+    // overdetermined) up to max_degree, after which the first failure ends
+    // the segment. Two points are always joined exactly by a line.
+    int a = 0;
+    while (a < n - 1) {
+        int b_best = a + 1;
+        best.assign(2, 0.0);
+        best[0] = 0.5 * (z[a] + z[a+1]);
+        best[1] = 0.5 * (z[a+1] - z[a]);
+        double best_error = 0.0;
+        for (int b = a + 2; b < n; b++) {
+            int m = b - a + 1;
+            int degree = std::min(max_degree, m - 2);
+            double error = fitSegment(s + a, z + a, m, degree, c);
+            if (error <= bound) {
+                b_best = b;
+                best = c;
+                best_error = error;
+            } else if (degree == max_degree) {
+                break;
+            }
+        }
+        lower.push_back(s[a]);
+        upper.push_back(s[b_best]);
+        coefficients.insert(coefficients.end(), best.begin(), best.end());
+        coefficient_start.push_back(static_cast<int>(coefficients.size()));
+        row_error = std::max(row_error, best_error);
+        a = b_best;
+    }
+    return row_error;
+}
+
+double CompressedEntry::evaluateRow(int j, double s) const
+{
+    if (row_values[j] >= 0) {
+        const double* z = &values[row_values[j]];
+        if (nx < 2) return z[0];
+        int i = static_cast<int>(std::upper_bound(grid.begin(), grid.end(), s) - grid.begin()) - 1;
+        i = std::min(std::max(i, 0), nx - 2);
+        return z[i] + (s - grid[i]) / (grid[i+1] - grid[i]) * (z[i+1] - z[i]);
+    }
+    int first = row_start[j];
+    int last = row_start[j+1];
+    int k = static_cast<int>(std::upper_bound(lower.begin() + first, lower.begin() + last, s) - lower.begin()) - 1;
+    k = std::max(k, first);
+    int c0 = coefficient_start[k];
+    return chebyshev(&coefficients[c0], coefficient_start[k+1] - c0, mapToUnit(s, lower[k], upper[k]));
+}
+
+double CompressedEntry::interpolate(double xp, double yp) const
+{
+    int j;
+    double wy, dwy;
+    TableEntry<double>::locateAxis(y.data(), ny, y_log, yp, j, wy, dwy);
+    double s = scaledX(xp);
+    double z0 = evaluateRow(j, s);
+    if (ny < 2) return z0;
+    return z0 + wy * (evaluateRow(j + 1, s) - z0);
+}
+
+size_t CompressedEntry::memoryBytes() const
+{
+    return sizeof(double) * (y.size() + lower.size() + upper.size() + coefficients.size() 
+                             + grid.size() + values.size())
+         + sizeof(int) * (row_start.size() + coefficient_start.size() + row_values.size());
+}
+
+size_t CompressedEntry::denseBytes() const
+{
+    return sizeof(double) * TableEntry<double>::storageSize(nx, ny);
+}
+
+CompressedGasTable::CompressedGasTable(const GasTable& table, double tolerance, int max_degree)
+    : pyrolysis_gas(table.pyrolysis_gas)
+{
+    auto compress = [&](const TableEntry<double>* var) {
+        return var ? new CompressedEntry(*var, tolerance, max_degree) : nullptr;
+    };
+    cp.reset(compress(table.cp));
+    cv.reset(compress(table.cv));
+    eint.reset(compress(table.eint));
+    enthalpy.reset(compress(table.enthalpy));
+    mw.reset(compress(table.mw));
+    density.reset(compress(table.density));
+    viscosity.reset(compress(table.viscosity));
+    conductivity.reset(compress(table.conductivity));
+    reactive_conductivity.reset(compress(table.reactive_conductivity));
+}
+
+void CompressedGasTable::lookup(double temperature, double pressure, GasProperties& props) const
+{
+    auto value = [&](const std::unique_ptr<CompressedEntry>& var) {
+        return var ? var->interpolate(temperature, pressure) : 0.0;
+    };
+    props.cp = value(cp);
+    props.cv = value(cv);
+    props.eint = value(eint);
+    props.enthalpy = value(enthalpy);
+    props.mw = value(mw);
+    props.density = value(density);
+    props.viscosity = value(viscosity);
+    props.conductivity = value(conductivity);
+    props.reactive_conductivity = value(reactive_conductivity);
+}
+
+size_t CompressedGasTable::memoryBytes() const
+{
+    size_t bytes = 0;
+    const std::unique_ptr<CompressedEntry>* vars[] = {&cp, &cv, &eint, &enthalpy, &mw, &density,
+                                                      &viscosity, &conductivity, &reactive_conductivity};
+    for (int k = 0; k < 9; k++) {
+        if (*vars[k]) bytes += (*vars[k])->memoryBytes();
+    }
+    return bytes;
+}
+
+size_t CompressedGasTable::denseBytes() const
+{
+    size_t bytes = 0;
+    const std::unique_ptr<CompressedEntry>* vars[] = {&cp, &cv, &eint, &enthalpy, &mw, &density,
+                                                      &viscosity, &conductivity, &reactive_conductivity};
+    for (int k = 0; k < 9; k++) {
+        if (*vars[k]) bytes += (*vars[k])->denseBytes();
+    }
+    return bytes;
+}
+
+} // namespace IcarusPyro
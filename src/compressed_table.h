@@ -0,0 +1,145 @@
+#ifndef ICARUSPYRO_COMPRESSED_TABLE_H
+#define ICARUSPYRO_COMPRESSED_TABLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gas_table.h"
+#include "table_entry.h"
+
+namespace IcarusPyro {
+
+/**
+ * Compressed form of a TableEntry: each y row is replaced by adaptive
+ * piecewise Chebyshev fits in x (in the scale of the x axis), and rows are
+ * blended linearly in y as in the dense table.
+ *
+ * Segments are grown greedily along each row and cover the grid points of
+ * the row with the fewest segments of degree up to `max_degree` such that
+ * the dense table is reproduced within tolerance * max |z| of its row, at
+ * every grid point and at points inside every cell (where the dense table
+ * interpolates linearly). Smooth properties (mw, viscosity, ...) need a few
+ * segments per row; kinks and steps fall back to short, low degree 
+ * segments, down to linear interpolation between two grid points, which is
+ * exact. A row whose segments would take more memory than its dense values
+ * is kept dense.
+ */
+class CompressedEntry {
+public:
+    /**
+     * @param[in] table Dense table to compress.
+     * @param[in] tolerance Bound of the error against the dense table 
+     *     relative to the largest magnitude of each row.
+     * @param[in] max_degree Highest degree of the Chebyshev fits.
+     */
+    CompressedEntry(const TableEntry<double>& table, double tolerance, int max_degree = 8);
+
+    /**
+     * Value at (xp, yp). Points outside of the table range are clamped to
+     * the nearest edge.
+     */
+    double interpolate(double xp, double yp) const;
+
+    /**
+     * Number of fitted segments over all rows.
+     */
+    size_t segments() const {
+        return coefficient_start.size() - 1;
+    }
+
+    /**
+     * Largest error of the fits against the dense table at the points where
+     * they are checked, relative to the largest magnitude of the row.
+     */
+    double maxError() const {
+        return max_error;
+    }
+
+    /**
+     * Bytes held by the compressed table, and by the dense table it was
+     * built from.
+     */
+    size_t memoryBytes() const;
+    size_t denseBytes() const;
+
+    int nx, ny;
+    std::string x_variable, y_variable;
+    std::string x_scale, y_scale;
+
+private:
+    bool x_log, y_log;
+    int max_degree;
+    double x_low, x_high;
+    std::vector<double> y;
+
+    // Segments of row j are row_start[j], ..., row_start[j+1]-1, in x order.
+    // Segment s spans [lower[s], upper[s]] in scaled x, and its Chebyshev
+    // coefficients are coefficients[coefficient_start[s], coefficient_start[s+1]).
+    std::vector<int> row_start;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<int> coefficient_start;
+    std::vector<double> coefficients;
+    double max_error;
+
+    // Rows kept dense: the values of row j start at values[row_values[j]],
+    // or row_values[j] is -1 if the row is fitted. grid holds the scaled x
+    // axis if any row is dense.
+    std::vector<int> row_values;
+    std::vector<double> values;
+    std::vector<double> grid;
+
+    double scaledX(double xp) const {
+        xp = std::min(std::max(xp, x_low), x_high);
+        return x_log ? std::log10(xp) : xp;
+    }
+
+    double evaluateRow(int j, double s) const;
+
+    /**
+     * Append the segments of a row of n grid points (s, z); returns the
+     * largest error at the points.
+     */
+    double fitRow(const double* s, const double* z, int n, double bound);
+};
+
+/**
+ * Gas table whose properties are held as CompressedEntry fits, built from a
+ * dense GasTable which may then be released. Lookups evaluate the local
+ * polynomials of the two enclosing pressure rows.
+ */
+class CompressedGasTable {
+public:
+    /**
+     * @param[in] table Dense gas table to compress.
+     * @param[in] tolerance See CompressedEntry.
+     */
+    CompressedGasTable(const GasTable& table, double tolerance, int max_degree = 8);
+
+    /**
+     * Properties of the gas mixture at a temperature and pressure, clamped
+     * to the table range. Missing tables give zero.
+     */
+    void lookup(double temperature, double pressure, GasProperties& props) const;
+
+    size_t memoryBytes() const;
+    size_t denseBytes() const;
+
+    std::string pyrolysis_gas;
+    std::unique_ptr<CompressedEntry> cp;
+    std::unique_ptr<CompressedEntry> cv;
+    std::unique_ptr<CompressedEntry> eint;
+    std::unique_ptr<CompressedEntry> enthalpy;
+    std::unique_ptr<CompressedEntry> mw;
+    std::unique_ptr<CompressedEntry> density;
+    std::unique_ptr<CompressedEntry> viscosity;
+    std::unique_ptr<CompressedEntry> conductivity;
+    std::unique_ptr<CompressedEntry> reactive_conductivity;
+};
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+#include "ensemble.h"
+#include "gas_table.h"
+#include "grid.h"
+#include "parallel.h"
+#include "pyrolysis_gas.h"
+
+namespace IcarusPyro {
+
+std::vector< std::vector<double> > perturbComposition(const std::vector<double>& Xe,
+                                                      int n,
+                                                      double sigma,
+                                                      unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector< std::vector<double> > compositions;
+    for (int s = 0; s < n; s++) {
+        std::vector<double> X(Xe);
+        double sum = 0.0;
+        for (size_t e = 0; e < X.size(); e++) {
+            if (X[e] > 0.0) X[e] = std::max(0.0, X[e] * (1.0 + sigma * normal(generator)));
+            sum += X[e];
+        }
+        if (!(sum > 0.0)) {
+            throw std::runtime_error("Perturbed composition has no elements.");
+        }
+        for (size_t e = 0; e < X.size(); e++) X[e] /= sum;
+        compositions.push_back(X);
+    }
+    return compositions;
+}
+
+GasEnsemble::GasEnsemble(const std::string& pyrolysis_gas_mixture,
+                         double T_low, double T_high, int nT, const std::string& T_scale,
+                         double p_low, double p_high, int nP, const std::string& p_scale,
+                         const std::vector<std::string>& mu_algorithms,
+                         const std::string& k_algorithm,
+                         int n_perturbed,
+                         double sigma,
+                         unsigned seed,
+                         int n_threads)
+    : pyrolysis_gas(pyrolysis_gas_mixture),
+      mu(mu_algorithms),
+      k(k_algorithm),
+      threads(n_threads),
+      temperature_scale(T_scale),
+      pressure_scale(p_scale)
+{
+    if (mu.empty()) {
+        throw std::runtime_error("An ensemble needs at least one viscosity algorithm.");
+    }
+    makeRange(T_low, T_high, nT, T_scale, temperature);
+    makeRange(p_low, p_high, nP, p_scale, pressure);
+
+    Mutation::Thermodynamics::Thermodynamics* th;
+    Mutation::Transport::Transport* tr;
+    createMutation(pyrolysis_gas, mu[0], k, th, tr);
+    thermo.reset(th);
+    transport.reset(tr);
+    std::vector<double> nominal = pyrolysisElementFractions(*thermo);
+    Xe.push_back(nominal);
+    std::vector< std::vector<double> > perturbed = perturbComposition(nominal, n_perturbed, sigma, seed);
+    Xe.insert(Xe.end(), perturbed.begin(), perturbed.end());
+}
+
+void GasEnsemble::setCompositions(const std::vector< std::vector<double> >& compositions)
+{
+    for (size_t c = 0; c < compositions.size(); c++) {
+        if (static_cast<int>(compositions[c].size()) != thermo->nElements()) {
+            throw std::runtime_error("Composition " + std::to_string(c) + " does not match the elements of "
+                                     + pyrolysis_gas + ".");
+        }
+    }
+    Xe = compositions;
+    tables.clear();
+}
+
+std::string GasEnsemble::variantName(int v) const
+{
+    int n_mu = mu.size();
+    return "xe" + std::to_string(v / n_mu) + "_" + mu[v % n_mu];
+}
+
+void GasEnsemble::compute()
+{
+    int n_mu = mu.size();
+    int T_size = temperature.size();
+    int p_size = pressure.size();
+
+    tables.clear();
+    for (int v = 0; v < variants(); v++) {
+        for (int p = 0; p < GasTable::N_PROPERTIES; p++) {
+            tables.emplace_back(new TableEntry<double>(T_size, p_size, "temperature", "pressure",
+                                                       temperature_scale, pressure_scale));
+            TableEntry<double>& var = *tables.back();
+            std::copy(temperature.begin(), temperature.end(), var.x);
+            std::copy(pressure.begin(), pressure.end(), var.y);
+        }
+    }
+
+    // Each thread gets its own mixture (see createMutation), with the first
+    // viscosity algorithm, and a Transport object per other algorithm sharing
+    // its Thermodynamics, all created serially before the threads start.
+    int nthreads = std::min(numThreads(threads), p_size);
+    std::vector< std::unique_ptr<Mutation::Thermodynamics::Thermodynamics> > thermos;
+    std::vector< std::unique_ptr<Mutation::Transport::Transport> > transports;
+    std::vector<Mutation::Thermodynamics::Thermodynamics*> thread_thermo(1, thermo.get());
+    std::vector<Mutation::Transport::Transport*> thread_transport;
+    for (int t = 0; t < nthreads; t++) {
+        if (t == 0) {
+            thread_transport.push_back(transport.get());
+        } else {
+            Mutation::Thermodynamics::Thermodynamics* th;
+            Mutation::Transport::Transport* tr;
+            createMutation(pyrolysis_gas, mu[0], k, th, tr);
+            thermos.emplace_back(th);
+            transports.emplace_back(tr);
+            thread_thermo.push_back(th);
+            thread_transport.push_back(tr);
+        }
+        for (int a = 1; a < n_mu; a++) {
+            transports.emplace_back(new Mutation::Transport::Transport(*thread_thermo[t], mu[a], k));
+            thread_transport.push_back(transports.back().get());
+        }
+    }
+
+    std::cout << "Computing " << variants() << " ensemble variants of " << pyrolysis_gas << std::endl;
+    parallelFor(p_size, nthreads, [&](int t, int j) {
+        Mutation::Thermodynamics::Thermodynamics& th = *thread_thermo[t];
+        GasProperties props;
+        for (int i = 0; i < T_size; i++) {
+            for (size_t c = 0; c < Xe.size(); c++) {
+                for (int a = 0; a < n_mu; a++) {
+                    Mutation::Transport::Transport& tr = *thread_transport[t * n_mu + a];
+                    if (a == 0) {
+                        equilibriumProperties(th, tr, temperature[i], pressure[j], Xe[c].data(), props);
+                    } else {
+                        transportProperties(tr, props);
+                    }
+                    int v = c * n_mu + a;
+                    for (int p = 0; p < GasTable::N_PROPERTIES; p++) {
+                        (*tables[v * GasTable::N_PROPERTIES + p]->z)(i, j) = props.*GasTable::properties[p];
+                    }
+                }
+            }
+        }
+    });
+}
+
+void GasEnsemble::write(const std::string& database, const std::string& gas_mixture_name)
+{
+    HDF5Names H5Names;
+    if (tables.empty()) {
+        throw std::runtime_error("The ensemble of " + pyrolysis_gas + " has not been computed.");
+    }
+    std::string gas_name = gas_mixture_name.empty() ? pyrolysis_gas : gas_mixture_name;
+    std::cout << "Writing database file : " << database
+              << " for the ensemble of gas mixture : " << gas_name << std::endl;
+
+    std::unique_ptr<H5File> file(openDatabase(database));
+    if (!file) {
+        throw std::runtime_error("Could not open database " + database + ".");
+    }
+    std::unique_ptr<Group> root(new Group(file->openGroup("/")));
+    std::unique_ptr<Group> gas(replaceGroup(root.get(), gas_name));
+
+    StrType stype(PredType::C_S1, H5T_VARIABLE);
+    stype.setCset(H5T_CSET_ASCII);
+    DataSpace scalar(H5S_SCALAR);
+    int n_mu = mu.size();
+    for (int v = 0; v < variants(); v++) {
+        std::unique_ptr<Group> variant(new Group(gas->createGroup(variantName(v))));
+        for (int p = 0; p < GasTable::N_PROPERTIES; p++) {
+            writeTableEntry(variant.get(), GasTable::propertyName(p), 
+                            tables[v * GasTable::N_PROPERTIES + p].get());
+        }
+
+        const std::vector<double>& X = Xe[v / n_mu];
+        hsize_t dims[1] = {X.size()};
+        DataSpace space(1, dims);
+        Attribute fractions = variant->createAttribute(H5Names.elemental_fractions, PredType::NATIVE_DOUBLE, space);
+        fractions.write(PredType::NATIVE_DOUBLE, X.data());
+        Attribute mu_algorithm = variant->createAttribute(H5Names.viscosity_algorithm, stype, scalar);
+        mu_algorithm.write(stype, H5std_string(mu[v % n_mu]));
+        Attribute k_algorithm = variant->createAttribute(H5Names.conductivity_algorithm, stype, scalar);
+        k_algorithm.write(stype, H5std_string(k));
+    }
+}
+
+} // namespace IcarusPyro
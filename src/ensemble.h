@@ -0,0 +1,122 @@
+#ifndef ICARUSPYRO_ENSEMBLE_H
+#define ICARUSPYRO_ENSEMBLE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Thermodynamics.h"
+#include "Transport.h"
+
+#include "table_entry.h"
+
+namespace IcarusPyro {
+
+/**
+ * `n` elemental compositions perturbed about Xe for uncertainty
+ * quantification: each non-zero fraction is scaled by (1 + sigma N(0, 1)),
+ * clipped at zero, and the result is renormalized to sum to one.
+ *
+ * @param[in] seed Seed of the perturbations, so that ensembles are repeatable.
+ */
+std::vector< std::vector<double> > perturbComposition(const std::vector<double>& Xe,
+                                                      int n,
+                                                      double sigma,
+                                                      unsigned seed = 1);
+
+/**
+ * Ensemble of gas tables of one mixture over variants of the elemental
+ * composition and of the viscosity algorithm, for uncertainty
+ * quantification.
+ *
+ * The Mutation++ mixture is set up once per thread, with a Transport object
+ * per viscosity algorithm sharing its Thermodynamics. Each grid point is
+ * equilibrated once per composition and its transport properties evaluated
+ * with every algorithm, in one parallel pass over the pressure rows. Every
+ * (composition, algorithm) pair is a variant, written as a subgroup of the
+ * mixture group of the database (see write()).
+ */
+class GasEnsemble {
+public:
+    /**
+     * Set up the ensemble on the temperature and pressure grid, see
+     * GasMixture for the grid parameters. The compositions are the nominal
+     * pyrolysis gas composition (see pyrolysisElementFractions) followed by
+     * `n_perturbed` perturbations of it (see perturbComposition).
+     *
+     * @param[in] mu_algorithms Viscosity algorithms of the variants.
+     * @param[in] k_algorithm Method used to compute the thermal conductivity
+     *     of the heavy particles, common to all the variants.
+     * @param[in] n_threads Number of threads. Default is 0, which uses all
+     *     hardware threads.
+     */
+    GasEnsemble(const std::string& pyrolysis_gas_mixture,
+                double T_low, double T_high, int nT, const std::string& T_scale,
+                double p_low, double p_high, int nP, const std::string& p_scale,
+                const std::vector<std::string>& mu_algorithms,
+                const std::string& k_algorithm = "Wilke",
+                int n_perturbed = 0,
+                double sigma = 0.05,
+                unsigned seed = 1,
+                int n_threads = 0);
+
+    /**
+     * Replace the elemental compositions of the ensemble, ordered as the
+     * elements of the mixture.
+     */
+    void setCompositions(const std::vector< std::vector<double> >& compositions);
+
+    const std::vector< std::vector<double> >& compositions() const {
+        return Xe;
+    }
+
+    /**
+     * Number of variants: compositions times viscosity algorithms.
+     */
+    int variants() const {
+        return static_cast<int>(Xe.size() * mu.size());
+    }
+
+    /**
+     * Name of variant v, "xe<c>_<algorithm>" for composition c.
+     */
+    std::string variantName(int v) const;
+
+    /**
+     * Compute the properties of every variant at every grid point.
+     */
+    void compute();
+
+    /**
+     * Write each variant as the subgroup variantName(v) of the group
+     * `gas_mixture_name` (default the mixture name), which is replaced. A
+     * subgroup holds the property tables of a gas table, less the species,
+     * and its elemental fractions and transport algorithms as attributes, so
+     * that it loads as GasTable("<gas_mixture_name>/<variant>", database).
+     */
+    void write(const std::string& database, const std::string& gas_mixture_name = "");
+
+private:
+    std::string pyrolysis_gas;
+    std::vector<std::string> mu;
+    std::string k;
+    int threads;
+    std::string temperature_scale;
+    std::string pressure_scale;
+    std::vector<double> temperature;
+    std::vector<double> pressure;
+    std::vector< std::vector<double> > Xe;
+
+    // Mixture of the first thread, also used to set up the ensemble: its 
+    // transport uses the first viscosity algorithm.
+    std::unique_ptr<Mutation::Thermodynamics::Thermodynamics> thermo;
+    std::unique_ptr<Mutation::Transport::Transport> transport;
+
+    // Tables of variant v, property k (see GasTable::properties) at 
+    // v * GasTable::N_PROPERTIES + k.
+    std::vector< std::unique_ptr< TableEntry<double> > > tables;
+};
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,97 @@
+#include <cmath>
+#include <string>
+
+#include "equilibrium_cache.h"
+#include "pyrolysis_gas.h"
+
+namespace IcarusPyro { 
+
+StateCache::StateCache(size_t capacity, double T_step, double log_p_step)
+    : max_size(capacity),
+      dT(T_step),
+      dlogp(log_p_step),
+      n_hits(0),
+      n_misses(0),
+      n_evictions(0)
+{
+    index.reserve(capacity);
+}
+
+StateCache::Key StateCache::key(double temperature, double pressure) const
+{
+    return Key(static_cast<int64_t>(std::floor(temperature / dT)), 
+               static_cast<int64_t>(std::floor(std::log10(pressure) / dlogp)));
+}
+
+void StateCache::quantize(double& temperature, double& pressure) const
+{
+    Key k = key(temperature, pressure);
+    temperature = (k.first + 0.5) * dT;
+    pressure = std::pow(10.0, (k.second + 0.5) * dlogp);
+}
+
+bool StateCache::find(double temperature, double pressure, GasProperties& props)
+{
+    auto it = index.find(key(temperature, pressure));
+    if (it == index.end()) { 
+        n_misses++;
+        return false;
+    }
+    n_hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    props = it->second->second;
+    return true;
+}
+
+void StateCache::insert(double temperature, double pressure, const GasProperties& props)
+{
+    if (max_size == 0) return;
+    Key k = key(temperature, pressure);
+    auto it = index.find(k);
+    if (it != index.end()) { 
+        it->second->second = props;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    if (entries.size() >= max_size) { 
+        index.erase(entries.back().first);
+        entries.pop_back();
+        n_evictions++;
+    }
+    entries.push_front(std::make_pair(k, props));
+    index[k] = entries.begin();
+}
+
+EquilibriumFallback::EquilibriumFallback(const std::string& pyrolysis_gas_mixture,
+                                         size_t capacity,
+                                         double T_step,
+                                         double log_p_step,
+                                         std::string mu_algorithm,
+                                         std::string k_algorithm)
+    : thermo(nullptr),
+      transport(nullptr),
+      cache(capacity, T_step, log_p_step)
+{
+    createMutation(pyrolysis_gas_mixture, mu_algorithm, k_algorithm, thermo, transport);
+    Xe = pyrolysisElementFractions(*thermo);
+}
+
+EquilibriumFallback::~EquilibriumFallback()
+{
+    delete transport;
+    delete thermo;
+}
+
+void EquilibriumFallback::evaluate(double temperature, double pressure, GasProperties& props)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cache.find(temperature, pressure, props)) return;
+
+    double T = temperature;
+    double p = pressure;
+    cache.quantize(T, p);
+    equilibriumProperties(*thermo, *transport, T, p, Xe.data(), props);
+    cache.insert(temperature, pressure, props);
+}
+
+} // namespace IcarusPyro
@@ -0,0 +1,130 @@
+#ifndef ICARUSPYRO_EQUILIBRIUM_CACHE_H
+#define ICARUSPYRO_EQUILIBRIUM_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gas_table.h"
+
+namespace Mutation { 
+namespace Thermodynamics { class Thermodynamics; }
+namespace Transport { class Transport; }
+}
+
+namespace IcarusPyro {
+
+/**
+ * Bounded least-recently-used cache of gas properties keyed by a quantized 
+ * (T, log10 p) bin. All points of a bin share one cache entry.
+ */
+class StateCache { 
+public:
+    /**
+     * @param[in] capacity Maximum number of cached states.
+     * @param[in] T_step Width of a temperature bin, K.
+     * @param[in] log_p_step Width of a log10(pressure) bin.
+     */
+    StateCache(size_t capacity = 4096, double T_step = 1.0, double log_p_step = 1.0e-3);
+
+    /**
+     * Map (T, p) to the center of its bin, which is where cached states are
+     * evaluated.
+     */
+    void quantize(double& temperature, double& pressure) const;
+
+    /**
+     * Find the state of the bin containing (T, p). Counts a hit or a miss.
+     * 
+     * @return True if the bin is cached, in which case `props` is set.
+     */
+    bool find(double temperature, double pressure, GasProperties& props);
+
+    /**
+     * Store the state of the bin containing (T, p), evicting the least 
+     * recently used state if the cache is full.
+     */
+    void insert(double temperature, double pressure, const GasProperties& props);
+
+    size_t size() const { return entries.size(); }
+    size_t capacity() const { return max_size; }
+    uint64_t hits() const { return n_hits; }
+    uint64_t misses() const { return n_misses; }
+    uint64_t evictions() const { return n_evictions; }
+
+    void resetCounters() { 
+        n_hits = 0;
+        n_misses = 0;
+        n_evictions = 0;
+    }
+
+private:
+    typedef std::pair<int64_t, int64_t> Key;
+
+    struct KeyHash { 
+        size_t operator()(const Key& key) const { 
+            return std::hash<int64_t>()(key.first * 1000003 ^ key.second);
+        }
+    };
+
+    typedef std::list<std::pair<Key, GasProperties>> EntryList;
+
+    Key key(double temperature, double pressure) const;
+
+    size_t max_size;
+    double dT;
+    double dlogp;
+    EntryList entries;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index;
+    uint64_t n_hits;
+    uint64_t n_misses;
+    uint64_t n_evictions;
+};
+
+/**
+ * GasTable fallback that computes the properties of out-of-range points 
+ * directly from Mutation++ equilibrium, caching the results in a StateCache.
+ * Calls are serialized, so one fallback may be shared by several threads.
+ */
+class EquilibriumFallback : public GasTableFallback { 
+public:
+    /**
+     * @param[in] pyrolysis_gas_mixture The name of the Mutation++ mixture file.
+     * @param[in] capacity Maximum number of cached states.
+     * @param[in] T_step Width of a temperature bin of the cache, K.
+     * @param[in] log_p_step Width of a log10(pressure) bin of the cache.
+     * @param[in] mu_algorithm Method used to compute the viscosity.
+     * @param[in] k_algorithm Method used to compute the thermal conductivity.
+     */
+    EquilibriumFallback(const std::string& pyrolysis_gas_mixture,
+                        size_t capacity = 4096,
+                        double T_step = 1.0,
+                        double log_p_step = 1.0e-3,
+                        std::string mu_algorithm = "Chapmann-Enskog_CG",
+                        std::string k_algorithm = "Wilke");
+
+    ~EquilibriumFallback();
+
+    void evaluate(double temperature, double pressure, GasProperties& props);
+
+    const StateCache& getCache() const { 
+        return cache;
+    }
+
+    uint64_t hits() const { return cache.hits(); }
+    uint64_t misses() const { return cache.misses(); }
+
+private:
+    Mutation::Thermodynamics::Thermodynamics* thermo;
+    Mutation::Transport::Transport* transport;
+    std::vector<double> Xe;
+    StateCache cache;
+    std::mutex mutex;
+};
+
+} // namespace IcarusPyro
+
+#endif
@@ -1,6 +1,11 @@
+#include <cmath>
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
 
 #include "gas_table.h"
 #include "table_entry.h"
@@ -9,35 +14,235 @@ using namespace H5;
 
 namespace IcarusPyro { 
 
+namespace { 
+
+// Universal gas constant, J/kmol/K (the molecular weights are in kg/kmol).
+const double UNIVERSAL_GAS_CONSTANT = 8314.462618;
+
+} // namespace
+
+const int GasTable::N_PROPERTIES;
+
+double GasProperties::* const GasTable::properties[GasTable::N_PROPERTIES] = {
+    &GasProperties::cp, &GasProperties::cv, &GasProperties::eint, &GasProperties::enthalpy, 
+    &GasProperties::mw, &GasProperties::density, &GasProperties::viscosity, 
+    &GasProperties::conductivity, &GasProperties::reactive_conductivity};
+
+H5std_string GasTable::propertyName(int k)
+{
+    static const HDF5Names H5Names;
+    const H5std_string* names[N_PROPERTIES] = {&H5Names.cp, &H5Names.cv, &H5Names.internal_energy, 
+                                               &H5Names.enthalpy, &H5Names.molecular_weight, 
+                                               &H5Names.density, &H5Names.viscosity, 
+                                               &H5Names.conductivity, &H5Names.reactive_conductivity};
+    if (k < 0 || k >= N_PROPERTIES) { 
+        throw std::runtime_error("Invalid gas table property " + std::to_string(k) + ".");
+    }
+    return *names[k];
+}
+
 GasTable::GasTable(const std::string& pyrolysis_gas_mixture, const std::string& database) 
-    : pyrolysis_gas(pyrolysis_gas_mixture)
+    : pyrolysis_gas(pyrolysis_gas_mixture),
+      cp(nullptr),
+      cv(nullptr),
+      eint(nullptr),
+      enthalpy(nullptr),
+      mw(nullptr),
+      density(nullptr),
+      viscosity(nullptr),
+      conductivity(nullptr),
+      reactive_conductivity(nullptr),
+      fallback(nullptr),
+      shared_axes(false),
+      arena(nullptr)
 {
     H5std_string FILE_NAME(database);
-    H5File* file(nullptr);
+    std::unique_ptr<H5File> file;
     try { 
         Exception::dontPrint();
-        file = new H5File(FILE_NAME, H5F_ACC_RDONLY);
-    } catch (FileIException error) { 
+        file.reset(new H5File(FILE_NAME, H5F_ACC_RDONLY));
+    } catch (const FileIException&) { 
         throw std::runtime_error("Could not open database.");
     }
-    Group* gas = new Group(file->openGroup(pyrolysis_gas));
+    if (H5Lexists(file->getId(), pyrolysis_gas.c_str(), H5P_DEFAULT) <= 0) { 
+        throw std::runtime_error("The database " + database + " has no gas mixture " + pyrolysis_gas + ".");
+    }
+    std::unique_ptr<Group> gas(new Group(file->openGroup(pyrolysis_gas)));
+    std::unique_ptr<Group> group;
 
-    cp = readDataSet(gas, H5Names.cp);
+    // The tables and the arena are owned by the members as they are read: 
+    // on any error they are released by clear().
+    try { 
+        if (H5Lexists(gas->getId(), H5Names.species.c_str(), H5P_DEFAULT) > 0) { 
+            group.reset(new Group(gas->openGroup(H5Names.species)));
+            for (hsize_t s = 0; s < group->getNumObjs(); s++) { 
+                species_names.push_back(group->getObjnameByIdx(s));
+            }
+        }
 
-    cv = readDataSet(gas, H5Names.cv);
+        // Size every table first so that all the axes and data share one 
+        // arena. Tables missing from older databases (e.g. mw, conductivity)
+        // are left null rather than read as placeholders, which would not 
+        // share the axes of the others. So are tables on other axes, e.g. 
+        // the (energy, density) cp and cv of older databases: lookups 
+        // interpolate every table at (temperature, pressure).
+        TableEntry<double>** vars[] = {&cp, &cv, &eint, &enthalpy, &viscosity, &density, 
+                                       &mw, &conductivity, &reactive_conductivity};
+        const H5std_string* names[] = {&H5Names.cp, &H5Names.cv, &H5Names.internal_energy, 
+                                       &H5Names.enthalpy, &H5Names.viscosity, &H5Names.density, 
+                                       &H5Names.molecular_weight, &H5Names.conductivity, 
+                                       &H5Names.reactive_conductivity};
+        const int n_vars = 9;
+        bool present[n_vars];
+        size_t arena_size = 0;
+        int nx, ny;
+        for (int k = 0; k < n_vars; k++) { 
+            present[k] = readTableShape(gas.get(), *names[k], nx, ny);
+            if (present[k]) arena_size += TableEntry<double>::storageSize(nx, ny);
+        }
+        for (size_t s = 0; s < species_names.size(); s++) { 
+            readTableShape(group.get(), species_names[s], nx, ny);
+            arena_size += TableEntry<double>::storageSize(nx, ny);
+        }
+        arena = alignedAlloc<double>(arena_size);
+
+        double* storage = arena;
+        bool enthalpy_off_axes = false;
+        for (int k = 0; k < n_vars; k++) { 
+            if (!present[k]) continue;
+            *vars[k] = readTableEntry(gas.get(), *names[k], storage);
+            storage += TableEntry<double>::storageSize((*vars[k])->nx, (*vars[k])->ny);
+            if ((*vars[k])->x_variable != "temperature" || (*vars[k])->y_variable != "pressure") { 
+                delete *vars[k];
+                *vars[k] = nullptr;
+                enthalpy_off_axes = enthalpy_off_axes || (vars[k] == &enthalpy);
+            }
+        }
+        if (enthalpy_off_axes) { 
+            throw std::runtime_error("The gas mixture " + pyrolysis_gas + " of " + database + 
+                                     " has an enthalpy table not on (temperature, pressure) axes.");
+        }
+        for (size_t s = 0; s < species_names.size(); s++) { 
+            species.push_back(nullptr);
+            species.back() = readTableEntry(group.get(), species_names[s], storage);
+            storage += TableEntry<double>::storageSize(species.back()->nx, species.back()->ny);
+        }
+    } catch (...) { 
+        clear();
+        throw;
+    }
 
-    eint = readDataSet(gas, H5Names.internal_energy);
+    updateSharedAxes();
+}
 
-    enthalpy = readDataSet(gas, H5Names.enthalpy);
+GasTable::GasTable(GasTable&& rhs) 
+    : pyrolysis_gas(std::move(rhs.pyrolysis_gas)),
+      cp(rhs.cp),
+      cv(rhs.cv),
+      eint(rhs.eint),
+      enthalpy(rhs.enthalpy),
+      mw(rhs.mw),
+      density(rhs.density),
+      viscosity(rhs.viscosity),
+      conductivity(rhs.conductivity),
+      reactive_conductivity(rhs.reactive_conductivity),
+      species_names(std::move(rhs.species_names)),
+      species(std::move(rhs.species)),
+      fallback(rhs.fallback),
+      shared_axes(rhs.shared_axes),
+      arena(rhs.arena),
+      stats(std::move(rhs.stats)),
+      derived(std::move(rhs.derived))
+{
+    rhs.cp = rhs.cv = rhs.eint = rhs.enthalpy = rhs.mw = nullptr;
+    rhs.density = rhs.viscosity = rhs.conductivity = rhs.reactive_conductivity = nullptr;
+    rhs.species.clear();
+    rhs.species_names.clear();
+    rhs.fallback = nullptr;
+    rhs.shared_axes = false;
+    rhs.arena = nullptr;
+}
 
-    viscosity = readDataSet(gas, H5Names.viscosity);
+GasTable& GasTable::operator=(GasTable&& rhs)
+{
+    if (this != &rhs) { 
+        clear();
+        pyrolysis_gas = std::move(rhs.pyrolysis_gas);
+        cp = rhs.cp;
+        cv = rhs.cv;
+        eint = rhs.eint;
+        enthalpy = rhs.enthalpy;
+        mw = rhs.mw;
+        density = rhs.density;
+        viscosity = rhs.viscosity;
+        conductivity = rhs.conductivity;
+        reactive_conductivity = rhs.reactive_conductivity;
+        species_names = std::move(rhs.species_names);
+        species = std::move(rhs.species);
+        fallback = rhs.fallback;
+        shared_axes = rhs.shared_axes;
+        arena = rhs.arena;
+        stats = std::move(rhs.stats);
+        derived = std::move(rhs.derived);
+
+        rhs.cp = rhs.cv = rhs.eint = rhs.enthalpy = rhs.mw = nullptr;
+        rhs.density = rhs.viscosity = rhs.conductivity = rhs.reactive_conductivity = nullptr;
+        rhs.species.clear();
+        rhs.species_names.clear();
+        rhs.fallback = nullptr;
+        rhs.shared_axes = false;
+        rhs.arena = nullptr;
+    }
+    return *this;
+}
 
-    density = readDataSet(gas, H5Names.density);
+void GasTable::clear()
+{
+    delete cp;
+    delete cv;
+    delete eint;
+    delete enthalpy;
+    delete mw;
+    delete density;
+    delete viscosity;
+    delete conductivity;
+    delete reactive_conductivity;
+    for (size_t s = 0; s < species.size(); s++) delete species[s];
+    species.clear();
+    species_names.clear();
+    cp = cv = eint = enthalpy = mw = nullptr;
+    density = viscosity = conductivity = reactive_conductivity = nullptr;
+    derived.clear();
+
+    // The arena goes last: the tables above may view it.
+    alignedFree(arena);
+    arena = nullptr;
+}
 
-    mw = readDataSet(gas, H5Names.molecular_weight);
+void GasTable::updateSharedAxes()
+{
+    // The derived tables are stale once any table changes.
+    derived.clear();
 
-    delete gas;
-    delete file;
+    TableEntry<double>* vars[] = {cp, cv, eint, mw, density, viscosity, conductivity, reactive_conductivity};
+    for (int k = 0; k < 8; k++) { 
+        if (vars[k]) vars[k]->detectUniformAxes();
+    }
+    if (enthalpy) enthalpy->detectUniformAxes();
+    for (size_t s = 0; s < species.size(); s++) species[s]->detectUniformAxes();
+
+    shared_axes = (enthalpy != nullptr);
+    for (int k = 0; k < 8 && shared_axes; k++) { 
+        if (vars[k]) shared_axes = vars[k]->sameAxes(*enthalpy);
+    }
+
+#ifdef ICARUSPYRO_INSTRUMENT
+    if (enthalpy) { 
+        std::vector<double> x(enthalpy->x, enthalpy->x + enthalpy->nx);
+        std::vector<double> y(enthalpy->y, enthalpy->y + enthalpy->ny);
+        if (!stats || !stats->sameAxes(x, y)) stats.reset(new TableStats(x, y));
+    }
+#endif
 }
 
 void GasTable::load(std::string varname, 
@@ -49,34 +254,97 @@ void GasTable::load(std::string varname,
                     std::vector<double>& y, 
                     std::vector<std::vector<double>>& z) 
 {
-    int nx = x.size();
-    int ny = y.size();
+    TableEntry<double>* var = newTableEntry(x_variable, y_variable, x_scale, y_scale, x, y, z);
+    if (!setEntry(varname, var)) delete var;
+}
 
-    TableEntry<double>* var(nullptr);
+bool GasTable::setEntry(const std::string& varname, TableEntry<double>* var)
+{
+    TableEntry<double>** slot(nullptr);
     if (varname == "cp") {
-        cp = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale);
-        var = cp;
+        slot = &cp;
     } else if (varname == "cv") { 
-        cv = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale);
-        var = cv;
+        slot = &cv;
     } else if (varname == "internal_energy") { 
-        eint = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale);
-        var = eint;
+        slot = &eint;
     } else if (varname == "enthalpy") { 
-        enthalpy = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale);
-        var = enthalpy;
+        slot = &enthalpy;
     } else if (varname == "molecular_weight") { 
-        mw = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale);
-        var = mw;
+        slot = &mw;
     } else if (varname == "density") { 
-        density = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale);
-        var = density;
+        slot = &density;
     } else if (varname == "viscosity") { 
-        viscosity = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale);
-        var = viscosity;
+        slot = &viscosity;
+    } else if (varname == "conductivity") { 
+        slot = &conductivity;
+    } else if (varname == "reactive_conductivity") { 
+        slot = &reactive_conductivity;
     } else { 
-        return;
+        return false;
     }
+    delete *slot;
+    *slot = var;
+    updateSharedAxes();
+    return true;
+}
+
+void GasTable::loadSpecies(std::string name, 
+                           std::string x_variable, 
+                           std::string y_variable,
+                           std::string x_scale, 
+                           std::string y_scale,
+                           std::vector<double>& x, 
+                           std::vector<double>& y, 
+                           std::vector<std::vector<double>>& z) 
+{
+    TableEntry<double>* var = newTableEntry(x_variable, y_variable, x_scale, y_scale, x, y, z);
+    int s = speciesIndex(name);
+    if (s < 0) { 
+        species_names.push_back(name);
+        species.push_back(var);
+    } else { 
+        delete species[s];
+        species[s] = var;
+    }
+}
+
+void GasTable::compactSpecies()
+{
+    std::vector<std::string> names;
+    std::vector<TableEntry<double>*> tables;
+    for (size_t s = 0; s < species.size(); s++) { 
+        TableEntry<double>* var = compactSupport(*species[s]);
+        if (var) { 
+            var->detectUniformAxes();
+            names.push_back(species_names[s]);
+            tables.push_back(var);
+        }
+        delete species[s];
+    }
+    species_names.swap(names);
+    species.swap(tables);
+}
+
+int GasTable::speciesIndex(const std::string& name) const
+{
+    for (size_t s = 0; s < species_names.size(); s++) { 
+        if (species_names[s] == name) return static_cast<int>(s);
+    }
+    return -1;
+}
+
+TableEntry<double>* GasTable::newTableEntry(std::string& x_variable, 
+                                            std::string& y_variable,
+                                            std::string& x_scale, 
+                                            std::string& y_scale,
+                                            std::vector<double>& x, 
+                                            std::vector<double>& y, 
+                                            std::vector<std::vector<double>>& z)
+{
+    int nx = x.size();
+    int ny = y.size();
+    TableEntry<double>* var = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale);
+
     // Copy data
     for (int i = 0; i < nx; i++) { 
         var->x[i] = x[i];
@@ -89,9 +357,155 @@ void GasTable::load(std::string varname,
             (*(*var).z)(j,i) = z[i][j];
         }
     }
+    return var;
+}
+
+void GasTable::lookup(double temperature, double pressure, GasProperties& props) const
+{
+    if (fallback && !inRange(temperature, pressure)) { 
+        evaluateFallback(temperature, pressure, props);
+        return;
+    }
+
+    interpolateProperties(temperature, pressure, locate(temperature, pressure), props);
+}
+
+void GasTable::lookup(const std::vector<double>& temperature, 
+                      const std::vector<double>& pressure, 
+                      size_t begin, 
+                      size_t end, 
+                      TableIndexCache& cells, 
+                      std::vector<GasProperties>& props) const
+{
+    if (end > temperature.size() || end > pressure.size() || end > cells.i.size() || 
+        end > cells.j.size() || end > props.size()) { 
+        throw std::runtime_error("Batched gas table lookup beyond the end of the batch.");
+    }
+
+    for (size_t k = begin; k < end; k++) { 
+        double T = temperature[k];
+        double p = pressure[k];
+        GasProperties& out = props[k];
+        if (fallback && !inRange(T, p)) { 
+            evaluateFallback(T, p, out);
+            continue;
+        }
+
+        TableIndex idx = locateFrom(T, p, cells.i[k], cells.j[k]);
+        cells.i[k] = idx.i;
+        cells.j[k] = idx.j;
+        interpolateProperties(T, p, idx, out);
+    }
+}
+
+void GasTable::interpolateProperties(double temperature, double pressure, const TableIndex& idx, 
+                                     GasProperties& props) const
+{
+    auto value = [&](const TableEntry<double>* var) { 
+        if (!var) return 0.0;
+        return shared_axes ? var->interpolate(idx) : var->interpolate(temperature, pressure);
+    };
+    props.cp = value(cp);
+    props.cv = value(cv);
+    props.eint = value(eint);
+    props.enthalpy = value(enthalpy);
+    props.mw = value(mw);
+    props.density = value(density);
+    props.viscosity = value(viscosity);
+    props.conductivity = value(conductivity);
+    props.reactive_conductivity = value(reactive_conductivity);
+}
+
+void GasTable::deriveFromProperties(double temperature, double pressure, const GasProperties& source, 
+                                    GasDerivedState& state, size_t k) const
+{
+    double gamma = source.cp / source.cv;
+    double R = (source.mw > 0.0) ? UNIVERSAL_GAS_CONSTANT / source.mw 
+                                 : pressure / (source.density * temperature);
+    state.gamma[k] = gamma;
+    state.gas_constant[k] = R;
+    state.sound_speed[k] = std::sqrt(gamma * R * temperature);
+    state.kinematic_viscosity[k] = source.viscosity / source.density;
+}
+
+void GasTable::derivedProperties(const std::vector<double>& temperature, 
+                                 const std::vector<double>& pressure, 
+                                 GasDerivedState& state) const
+{
+    if (!cp || !cv) { 
+        throw std::runtime_error("Derived properties of " + pyrolysis_gas + " need its cp and cv tables.");
+    }
+    size_t n = temperature.size();
+    state.resize(n);
+
+    for (size_t k = 0; k < n; k++) { 
+        double T = temperature[k];
+        double p = pressure[k];
+        GasProperties props;
+        if (fallback && !inRange(T, p)) { 
+            evaluateFallback(T, p, props);
+            deriveFromProperties(T, p, props, state, k);
+            continue;
+        }
+
+        TableIndex idx = locate(T, p);
+        if (derived.empty()) { 
+            interpolateProperties(T, p, idx, props);
+            deriveFromProperties(T, p, props, state, k);
+            continue;
+        }
+
+        // Bilinear interpolation of all the derived quantities of the cell.
+        int ny = enthalpy->ny;
+        int i1 = (enthalpy->nx > 1) ? idx.i + 1 : idx.i;
+        int j1 = (ny > 1) ? idx.j + 1 : idx.j;
+        const double* z00 = &derived[N_DERIVED * (idx.j + ny * idx.i)];
+        const double* z10 = &derived[N_DERIVED * (idx.j + ny * i1)];
+        const double* z01 = &derived[N_DERIVED * (j1 + ny * idx.i)];
+        const double* z11 = &derived[N_DERIVED * (j1 + ny * i1)];
+        double values[N_DERIVED];
+        for (int q = 0; q < N_DERIVED; q++) { 
+            double z0 = z00[q] + idx.wx * (z10[q] - z00[q]);
+            double z1 = z01[q] + idx.wx * (z11[q] - z01[q]);
+            values[q] = z0 + idx.wy * (z1 - z0);
+        }
+        state.gamma[k] = values[0];
+        state.gas_constant[k] = values[1];
+        state.sound_speed[k] = values[2];
+        state.kinematic_viscosity[k] = values[3];
+    }
+}
+
+void GasTable::tabulateDerived()
+{
+    if (!enthalpy || !cp || !cv) { 
+        throw std::runtime_error("Cannot tabulate derived properties without enthalpy, cp and cv tables.");
+    }
+    int nx = enthalpy->nx;
+    int ny = enthalpy->ny;
+    GasDerivedState nodes;
+    nodes.resize(static_cast<size_t>(nx) * ny);
+    for (int i = 0; i < nx; i++) { 
+        for (int j = 0; j < ny; j++) { 
+            double T = enthalpy->x[i];
+            double p = enthalpy->y[j];
+            GasProperties props;
+            interpolateProperties(T, p, enthalpy->locate(T, p), props);
+            deriveFromProperties(T, p, props, nodes, j + ny * i);
+        }
+    }
+
+    std::vector<double> values(N_DERIVED * nodes.gamma.size());
+    for (size_t k = 0; k < nodes.gamma.size(); k++) { 
+        values[N_DERIVED * k] = nodes.gamma[k];
+        values[N_DERIVED * k + 1] = nodes.gas_constant[k];
+        values[N_DERIVED * k + 2] = nodes.sound_speed[k];
+        values[N_DERIVED * k + 3] = nodes.kinematic_viscosity[k];
+    }
+    derived.swap(values);
 }
 
-void GasTable::write(std::string database, std::string gas_mixture_name) 
+void GasTable::write(std::string database, std::string gas_mixture_name, bool truncate) 
 {
     std::string gas_name(pyrolysis_gas);
     if (!(gas_mixture_name.empty())) { 
@@ -100,107 +514,254 @@ void GasTable::write(std::string database, std::string gas_mixture_name)
     std::cout << "Writing database file : " << database 
               << " for gas mixutre : " << gas_name << std::endl;
 
-    H5std_string FILE_NAME(database);
-    H5File* file(nullptr);
-    try { 
-        file = new H5File(FILE_NAME, H5F_ACC_TRUNC);
-    } catch (FileIException error) { 
-        return;
-    }
-    Group* gas = new Group(file->createGroup(gas_name));
+    H5File* file = openDatabase(database, truncate);
+    if (!file) return;
+    Group* root = new Group(file->openGroup("/"));
+    Group* gas = replaceGroup(root, gas_name);
+    delete root;
     
     std::cout << "   Writing cp data " << std::endl;
-    if (cp) writeDataSet(gas, H5Names.cp, cp);
+    if (cp) writeTableEntry(gas, H5Names.cp, cp);
 
     std::cout << "   Writing cv data " << std::endl;
-    if (cv) writeDataSet(gas, H5Names.cv, cv);
+    if (cv) writeTableEntry(gas, H5Names.cv, cv);
 
     std::cout << "   Writing internal energy data " << std::endl;
-    if (eint) writeDataSet(gas, H5Names.internal_energy, eint);
+    if (eint) writeTableEntry(gas, H5Names.internal_energy, eint);
     
     std::cout << "   Writing enthalpy data " << std::endl;
-    if (enthalpy) writeDataSet(gas, H5Names.enthalpy, enthalpy);
+    if (enthalpy) writeTableEntry(gas, H5Names.enthalpy, enthalpy);
 
     std::cout << "   Writing molecular weight data " << std::endl;
-    if (mw) writeDataSet(gas, H5Names.molecular_weight, mw);
+    if (mw) writeTableEntry(gas, H5Names.molecular_weight, mw);
 
     std::cout << "   Writing density data " << std::endl;
-    if (density) writeDataSet(gas, H5Names.density, density);
+    if (density) writeTableEntry(gas, H5Names.density, density);
 
     std::cout << "   Writing viscosity data " << std::endl;
-    if (viscosity) writeDataSet(gas, H5Names.viscosity, viscosity);
+    if (viscosity) writeTableEntry(gas, H5Names.viscosity, viscosity);
+
+    std::cout << "   Writing thermal conductivity data " << std::endl;
+    if (conductivity) writeTableEntry(gas, H5Names.conductivity, conductivity);
+    if (reactive_conductivity) writeTableEntry(gas, H5Names.reactive_conductivity, reactive_conductivity);
+
+    if (!species.empty()) { 
+        std::cout << "   Writing species mass fraction data " << std::endl;
+        Group* group = new Group(gas->createGroup(H5Names.species));
+        for (size_t s = 0; s < species.size(); s++) { 
+            writeTableEntry(group, species_names[s], species[s]);
+        }
+        delete group;
+    }
 
     delete gas;
     delete file;
 }
 
-void GasTable::writeDataSet(Group* gas, H5std_string &variable, TableEntry<double>* var)
+std::future<GasTable> loadGasTableAsync(const std::string& pyrolysis_gas_mixture, 
+                                        const std::string& database)
 {
-    const static int RANK = 1;
-    DataSet *x_data, *y_data, *z_data;
-    hsize_t xdims[RANK];
-    hsize_t ydims[RANK];
-    hsize_t zdims[RANK];
+    // Several pending loads read one at a time.
+    static std::mutex loading;
+    return std::async(std::launch::async, [pyrolysis_gas_mixture, database]() { 
+        std::lock_guard<std::mutex> lock(loading);
+        return GasTable(pyrolysis_gas_mixture, database);
+    });
+}
 
+H5File* openDatabase(const std::string& database, bool truncate)
+{
+    H5std_string FILE_NAME(database);
+    H5File* file(nullptr);
+    Exception::dontPrint();
+    if (!truncate) { 
+        try { 
+            file = new H5File(FILE_NAME, H5F_ACC_RDWR);
+        } catch (const FileIException&) { 
+            file = nullptr;
+        }
+    }
+    if (!file) { 
+        try { 
+            file = new H5File(FILE_NAME, H5F_ACC_TRUNC);
+        } catch (const FileIException&) { 
+            return nullptr;
+        }
+    }
+    return file;
+}
+
+Group* replaceGroup(Group* parent, const H5std_string& name)
+{
+    if (H5Lexists(parent->getId(), name.c_str(), H5P_DEFAULT) > 0) { 
+        parent->unlink(name);
+    }
+    return new Group(parent->createGroup(name));
+}
+
+TableEntry<double>* compactSupport(const TableEntry<double>& var)
+{
+    int i_low = var.nx, i_high = -1, j_low = var.ny, j_high = -1;
+    for (int j = 0; j < var.ny; j++) { 
+        for (int i = 0; i < var.nx; i++) { 
+            if ((*var.z)(i, j) == 0.0) continue;
+            i_low = std::min(i_low, i);
+            i_high = std::max(i_high, i);
+            j_low = std::min(j_low, j);
+            j_high = std::max(j_high, j);
+        }
+    }
+    if (i_high < 0) return nullptr;
+    i_low = std::max(i_low - 1, 0);
+    i_high = std::min(i_high + 1, var.nx - 1);
+    j_low = std::max(j_low - 1, 0);
+    j_high = std::min(j_high + 1, var.ny - 1);
+
+    TableEntry<double>* compact = new TableEntry<double>(i_high - i_low + 1, j_high - j_low + 1, 
+                                                         var.x_variable, var.y_variable, 
+                                                         var.x_scale, var.y_scale);
+    std::copy(var.x + i_low, var.x + i_high + 1, compact->x);
+    std::copy(var.y + j_low, var.y + j_high + 1, compact->y);
+    for (int j = 0; j < compact->ny; j++) { 
+        for (int i = 0; i < compact->nx; i++) (*compact->z)(i, j) = (*var.z)(i + i_low, j + j_low);
+    }
+    return compact;
+}
+
+void writeTableEntry(Group* gas, const H5std_string &variable, TableEntry<double>* var)
+{
+    std::vector<double> x(var->x, var->x + var->nx);
+    TableStream stream(gas, variable, var->x_variable, var->y_variable, var->x_scale, var->y_scale, x);
+
+    std::vector<double> row(var->nx);
+    for (int j = 0; j < var->ny; j++) {
+        for (int i = 0; i < var->nx; i++) {
+            row[i] = (*(*var).z)(i,j);
+        }
+        stream.writeRow(j, var->y[j], row.data());
+    }
+}
+
+TableStream::TableStream(Group* parent, 
+                         const H5std_string& variable, 
+                         const std::string& x_variable, 
+                         const std::string& y_variable,
+                         const std::string& x_scale, 
+                         const std::string& y_scale,
+                         const std::vector<double>& x)
+    : group(nullptr), 
+      z_data(nullptr),
+      nx(x.size())
+{
+    HDF5Names H5Names;
     Attribute attr;
     DataSpace attr_dataspace = DataSpace(H5S_SCALAR);
     H5std_string buffer;
     StrType stype(PredType::C_S1, H5T_VARIABLE);
     stype.setCset(H5T_CSET_ASCII);
-    
-    Group* group = new Group(gas->createGroup(variable));
 
-    attr = Attribute(group->createAttribute(H5Names.nx, PredType::NATIVE_INT, attr_dataspace));
-    attr.write(PredType::NATIVE_INT, &var->nx);
+    group = new Group(parent->createGroup(variable));
 
-    attr = Attribute(group->createAttribute(H5Names.ny, PredType::NATIVE_INT, attr_dataspace));
-    attr.write(PredType::NATIVE_INT, &var->ny);
+    int nx_attr = static_cast<int>(nx);
+    attr = Attribute(group->createAttribute(H5Names.nx, PredType::NATIVE_INT, attr_dataspace));
+    attr.write(PredType::NATIVE_INT, &nx_attr);
 
     attr = Attribute(group->createAttribute(H5Names.x_scale, stype, attr_dataspace));
-    buffer = var->x_scale;
+    buffer = x_scale;
     attr.write(stype, buffer);
 
     attr = Attribute(group->createAttribute(H5Names.y_scale, stype, attr_dataspace));
-    buffer = var->y_scale;
+    buffer = y_scale;
     attr.write(stype, buffer);
 
     attr = Attribute(group->createAttribute(H5Names.x_variable, stype, attr_dataspace));
-    buffer = var->x_variable;
+    buffer = x_variable;
     attr.write(stype, buffer);
 
     attr = Attribute(group->createAttribute(H5Names.y_variable, stype, attr_dataspace));
-    buffer = var->y_variable;
+    buffer = y_variable;
     attr.write(stype, buffer);
 
-    xdims[0] = var->nx;
-    DataSpace x_dataspace = DataSpace(RANK, xdims);
-    x_data = new DataSet(group->createDataSet(H5Names.x_data, PredType::NATIVE_DOUBLE, x_dataspace));
-    x_data->write(var->x, PredType::NATIVE_DOUBLE);
-    delete x_data;
-
-    ydims[0] = var->ny;
-    DataSpace y_dataspace = DataSpace(RANK, ydims);
-    y_data = new DataSet(group->createDataSet(H5Names.y_data, PredType::NATIVE_DOUBLE, y_dataspace));
-    y_data->write(var->y, PredType::NATIVE_DOUBLE);
-    delete y_data;
+    hsize_t xdims[1] = {nx};
+    DataSpace x_dataspace = DataSpace(1, xdims);
+    DataSet x_data = group->createDataSet(H5Names.x_data, PredType::NATIVE_DOUBLE, x_dataspace);
+    x_data.write(x.data(), PredType::NATIVE_DOUBLE);
+
+    // One chunk per row; the table grows along y as rows are written.
+    hsize_t zdims[2] = {0, nx};
+    hsize_t maxdims[2] = {H5S_UNLIMITED, nx};
+    hsize_t chunk[2] = {1, nx};
+    DSetCreatPropList props;
+    props.setChunk(2, chunk);
+    DataSpace z_dataspace = DataSpace(2, zdims, maxdims);
+    z_data = new DataSet(group->createDataSet(H5Names.z_table, PredType::NATIVE_DOUBLE, z_dataspace, props));
+}
 
-    for (int i = 0; i < var->ny; i++) {
-        H5std_string zvar = H5Names.z_data(i);
-        z_data = new DataSet(group->createDataSet(zvar, PredType::NATIVE_DOUBLE, x_dataspace));
+TableStream::~TableStream()
+{
+    try {
+        close();
+    } catch (...) {
+    }
+}
 
-        double data_out[xdims[0]];
-        for (int j = 0; j < var->nx; j++) {
-            data_out[j] = (*(*var).z)(j,i);
-        }
-        z_data->write(data_out, PredType::NATIVE_DOUBLE);
-        delete z_data;
+void TableStream::writeRow(int j, double yj, const double* z)
+{
+    if (static_cast<size_t>(j) >= y.size()) {
+        y.resize(j + 1, 0.0);
+        hsize_t zdims[2] = {y.size(), nx};
+        z_data->extend(zdims);
     }
+    y[j] = yj;
+
+    hsize_t offset[2] = {static_cast<hsize_t>(j), 0};
+    hsize_t count[2] = {1, nx};
+    DataSpace file_space = z_data->getSpace();
+    file_space.selectHyperslab(H5S_SELECT_SET, count, offset);
+    DataSpace memory_space = DataSpace(1, &nx);
+    z_data->write(z, PredType::NATIVE_DOUBLE, memory_space, file_space);
+}
+
+void TableStream::close()
+{
+    if (!group) return;
+    HDF5Names H5Names;
+
+    delete z_data;
+    z_data = nullptr;
+
+    int ny = static_cast<int>(y.size());
+    DataSpace attr_dataspace = DataSpace(H5S_SCALAR);
+    Attribute attr = Attribute(group->createAttribute(H5Names.ny, PredType::NATIVE_INT, attr_dataspace));
+    attr.write(PredType::NATIVE_INT, &ny);
+
+    hsize_t ydims[1] = {y.size()};
+    DataSpace y_dataspace = DataSpace(1, ydims);
+    DataSet y_data = group->createDataSet(H5Names.y_data, PredType::NATIVE_DOUBLE, y_dataspace);
+    y_data.write(y.data(), PredType::NATIVE_DOUBLE);
 
     delete group;
+    group = nullptr;
 }
 
-TableEntry<double>* GasTable::readDataSet(Group* gas, H5std_string &variable)
+bool readTableShape(Group* gas, const H5std_string& variable, int& nx, int& ny)
 {
+    HDF5Names H5Names;
+    nx = ny = 1;
+    if (!gas || H5Lexists(gas->getId(), variable.c_str(), H5P_DEFAULT) <= 0) return false;
+
+    Group group = gas->openGroup(variable);
+    hsize_t dims[1];
+    group.openDataSet(H5Names.x_data).getSpace().getSimpleExtentDims(dims, nullptr);
+    nx = static_cast<int>(dims[0]);
+    group.openDataSet(H5Names.y_data).getSpace().getSimpleExtentDims(dims, nullptr);
+    ny = static_cast<int>(dims[0]);
+    return true;
+}
+
+TableEntry<double>* readTableEntry(Group* gas, const H5std_string &variable, double* storage)
+{
+    HDF5Names H5Names;
     DataSpace x_dataspace, y_dataspace, z_dataspace;
     DataSet *x_data, *y_data, *z_data;
     Attribute* attr;
@@ -215,7 +776,7 @@ TableEntry<double>* GasTable::readDataSet(Group* gas, H5std_string &variable)
     } catch (...) {
         std::cout << "Creating empty variable object for " << variable << 
                      ". It does not exist in the HDF5 file." << std::endl;
-        TableEntry<double>* var = new TableEntry<double>(1, 1, "temperature", "pressure", "linear", "linear");
+        TableEntry<double>* var = new TableEntry<double>(1, 1, "temperature", "pressure", "linear", "linear", storage);
         return var;
     }
 
@@ -258,7 +819,7 @@ TableEntry<double>* GasTable::readDataSet(Group* gas, H5std_string &variable)
     ndims = y_dataspace.getSimpleExtentDims(ydims, nullptr);
     int ny = ydims[0];
 
-    TableEntry<double>* var = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale);
+    TableEntry<double>* var = new TableEntry<double>(nx, ny, x_variable, y_variable, x_scale, y_scale, storage);
 
     x_data->read(var->x, PredType::NATIVE_DOUBLE, DataSpace(1,xdims), x_dataspace);
     delete x_data;
@@ -266,18 +827,49 @@ TableEntry<double>* GasTable::readDataSet(Group* gas, H5std_string &variable)
     y_data->read(var->y, PredType::NATIVE_DOUBLE, DataSpace(1,ydims), y_dataspace);
     delete y_data;
 
-    for (int i = 0; i < var->ny; i++) {
-        H5std_string zvar = H5Names.z_data(i);
-
-        z_data = new DataSet(group->openDataSet(zvar));
+    if (H5Lexists(group->getId(), H5Names.z_table.c_str(), H5P_DEFAULT) > 0) {
+        // Two-dimensional (ny, nx) layout written by TableStream.
+        std::vector<double> data_in(static_cast<size_t>(nx) * ny);
+        z_data = new DataSet(group->openDataSet(H5Names.z_table));
         z_dataspace = z_data->getSpace();
-        ndims = z_dataspace.getSimpleExtentDims(zdims, nullptr);
-        double data_in[zdims[0]];
-        z_data->read(data_in, PredType::NATIVE_DOUBLE, DataSpace(1,zdims), z_dataspace);
+        hsize_t z_dims[2] = {0, 0};
+        if (z_dataspace.getSimpleExtentNdims() != 2 || 
+            (z_dataspace.getSimpleExtentDims(z_dims, nullptr), z_dims[0] != static_cast<hsize_t>(ny)) || 
+            z_dims[1] != static_cast<hsize_t>(nx)) { 
+            delete z_data;
+            delete group;
+            delete var;
+            throw std::runtime_error("The z table of " + variable + " does not match its axes.");
+        }
+        if (!data_in.empty()) z_data->read(data_in.data(), PredType::NATIVE_DOUBLE);
         delete z_data;
-        
-        for (int j = 0; j < var->nx; j++) {
-            (*(*var).z)(j,i) = data_in[j];
+
+        for (int i = 0; i < var->ny; i++) {
+            for (int j = 0; j < var->nx; j++) {
+                (*(*var).z)(j,i) = data_in[static_cast<size_t>(i) * nx + j];
+            }
+        }
+    } else {
+        // Legacy layout with one z_i dataset per row.
+        std::vector<double> data_in(nx);
+        for (int i = 0; i < var->ny; i++) {
+            H5std_string zvar = H5Names.z_data(i);
+
+            z_data = new DataSet(group->openDataSet(zvar));
+            z_dataspace = z_data->getSpace();
+            ndims = z_dataspace.getSimpleExtentDims(zdims, nullptr);
+            if (static_cast<int>(zdims[0]) != nx) {
+                delete z_data;
+                delete group;
+                delete var;
+                throw std::runtime_error("Row " + zvar + " of " + variable + " does not match the x axis.");
+            }
+            z_data->read(data_in.data(), PredType::NATIVE_DOUBLE, DataSpace(1,zdims), z_dataspace);
+            delete z_data;
+
+            for (int j = 0; j < var->nx; j++) {
+                (*(*var).z)(j,i) = data_in[j];
+            }
         }
     }
     delete group;
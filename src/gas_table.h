@@ -1,10 +1,14 @@
 #ifndef __GAS_TABLE_H__
 #define __GAS_TABLE_H__
 
+#include <algorithm>
+#include <future>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "table_entry.h"
+#include "table_stats.h"
 #include "H5Cpp.h"
 
 using namespace H5;
@@ -21,6 +25,9 @@ public:
            molecular_weight("mw"),
            density("density"),
            viscosity("viscosity"), 
+           conductivity("conductivity"),
+           reactive_conductivity("reactive_conductivity"),
+           species("species"),
            nx("nx"), 
            ny("ny"), 
            x_variable("x_variable"), 
@@ -28,11 +35,31 @@ public:
            x_scale("x_scale"), 
            y_scale("y_scale"), 
            x_data("x"), 
-           y_data("y") {}
+           y_data("y"),
+           z_table("z"),
+           bprime_c("bc"),
+           wall_enthalpy("hw"),
+           bprime_g("bg"),
+           bprime_g_scale("bg_scale"),
+           first_row("first_row"),
+           total_rows("total_rows"),
+           elemental_fractions("elemental_fractions"),
+           viscosity_algorithm("viscosity_algorithm"),
+           conductivity_algorithm("conductivity_algorithm"),
+           generation_key("generation_key"),
+           mixture_hash("mixture_hash"),
+           temperature_range("temperature_range"),
+           pressure_range("pressure_range"),
+           temperature_points("temperature_points"),
+           pressure_points("pressure_points"),
+           temperature_scale("temperature_scale"),
+           pressure_scale("pressure_scale"),
+           species_threshold("species_threshold") {}
 
     ~HDF5Names() {}; 
 
     H5std_string z_data(int i) const { return "z_" + std::to_string(i); }
+    H5std_string slice(const H5std_string& name, int k) const { return name + "_" + std::to_string(k); }
 
     H5std_string cv;
     H5std_string cp;
@@ -41,6 +68,9 @@ public:
     H5std_string molecular_weight;
     H5std_string density;
     H5std_string viscosity;
+    H5std_string conductivity;
+    H5std_string reactive_conductivity;
+    H5std_string species;
     H5std_string nx;
     H5std_string ny;
     H5std_string x_variable;
@@ -49,6 +79,92 @@ public:
     H5std_string y_scale;
     H5std_string x_data;
     H5std_string y_data;
+    H5std_string z_table;
+    H5std_string bprime_c;
+    H5std_string wall_enthalpy;
+    H5std_string bprime_g;
+    H5std_string bprime_g_scale;
+    H5std_string first_row;
+    H5std_string total_rows;
+    H5std_string elemental_fractions;
+    H5std_string viscosity_algorithm;
+    H5std_string conductivity_algorithm;
+    H5std_string generation_key;
+    H5std_string mixture_hash;
+    H5std_string temperature_range;
+    H5std_string pressure_range;
+    H5std_string temperature_points;
+    H5std_string pressure_points;
+    H5std_string temperature_scale;
+    H5std_string pressure_scale;
+    H5std_string species_threshold;
+};
+
+/**
+ * Gas mixture properties at a single temperature and pressure point.
+ */
+struct GasProperties { 
+    double cp;
+    double cv;
+    double eint;
+    double enthalpy;
+    double mw;
+    double density;
+    double viscosity;
+    double conductivity;
+    double reactive_conductivity;
+};
+
+/**
+ * Properties derived from the tabulated ones for a batch of points, stored 
+ * as a structure of arrays (see GasTable::derivedProperties).
+ */
+struct GasDerivedState { 
+    void resize(size_t n) { 
+        gamma.resize(n);
+        gas_constant.resize(n);
+        sound_speed.resize(n);
+        kinematic_viscosity.resize(n);
+    }
+
+    std::vector<double> gamma;               // cp / cv
+    std::vector<double> gas_constant;        // J/kg/K
+    std::vector<double> sound_speed;         // m/s
+    std::vector<double> kinematic_viscosity; // m^2/s
+};
+
+/**
+ * Caller-owned cells of the last lookup of each point of a batch, e.g. of each
+ * mesh cell, stored as a structure of arrays (see GasTable::lookup). Points 
+ * that were never located hold -1.
+ */
+struct TableIndexCache { 
+    void resize(size_t n) { 
+        i.resize(n, -1);
+        j.resize(n, -1);
+    }
+
+    /**
+     * Forget the cells, e.g. after the table has been replaced.
+     */
+    void reset() { 
+        std::fill(i.begin(), i.end(), -1);
+        std::fill(j.begin(), j.end(), -1);
+    }
+
+    std::vector<int> i;  // temperature interval
+    std::vector<int> j;  // pressure interval
+};
+
+/**
+ * Source of gas mixture properties for points outside of the table range, 
+ * e.g., a direct equilibrium calculation (see EquilibriumFallback).
+ */
+class GasTableFallback { 
+public:
+    virtual ~GasTableFallback() {}
+
+    virtual void evaluate(double temperature, double pressure, GasProperties& props) = 0;
 };
 
 class GasTable { 
@@ -66,36 +182,53 @@ public:
           enthalpy(nullptr), 
           mw(nullptr),
           density(nullptr),
-          viscosity(nullptr) {}
+          viscosity(nullptr),
+          conductivity(nullptr),
+          reactive_conductivity(nullptr),
+          fallback(nullptr),
+          shared_axes(false),
+          arena(nullptr) {}
 
     /** 
      * A constructor that will initialize the object from a previous gas table 
-     * database.
+     * database. Properties without a table in the database, or whose table 
+     * is not on (temperature, pressure) axes (e.g. the (energy, density) cp
+     * and cv of older databases), are left null. Throws std::runtime_error
+     * if the enthalpy table is on other axes.
      * 
      * @param pyrolysis_gas_mixture The name of the pyrolysis gas mixture.
      * @param database The name (and/or full path) of the gas table database.
      */
     GasTable(const std::string& pyrolysis_gas_mixture, const std::string& database);
 
+    /**
+     * Gas tables own their property tables: they can be moved but not copied.
+     */
+    GasTable(const GasTable&) = delete;
+    GasTable& operator=(const GasTable&) = delete;
+    GasTable(GasTable&& rhs);
+    GasTable& operator=(GasTable&& rhs);
+
     /**
      * Object deconstructor.
      */
     ~GasTable() {
-        delete cp;
-        delete cv;
-        delete eint;
-        delete enthalpy;
-        delete mw;
-        delete density;
-        delete viscosity;
+        clear();
     }
 
     /** 
-     * Write the gas mixture property data to an HDF5 database file.
+     * Write the gas mixture property data to an HDF5 database file. The 
+     * other mixtures (and B' tables) of an existing database are kept; the
+     * group of this mixture is deleted and written anew, so nothing of a 
+     * previous table of the same name survives in it.
      * 
      * @param[in] database Name or full path of the database file. Default is gas_table.h5.
+     * @param[in] truncate Recreate the database file, dropping everything in 
+     *     it, instead of updating it. HDF5 does not reclaim the space of 
+     *     replaced groups, so this also keeps rewritten databases compact.
+     *     Default is false.
      */
-    void write(std::string database="gas_table.h5", std::string gas_mixture_name="");
+    void write(std::string database="gas_table.h5", std::string gas_mixture_name="", bool truncate=false);
 
     /**
      * Set the table entry values for a gas mixture property where the 
@@ -120,6 +253,197 @@ public:
               std::vector<double>& y, 
               std::vector<std::vector<double>>& z);
 
+    /**
+     * Replace the table entry of a gas mixture property (see load() for the
+     * names) with `var`, taking ownership of it.
+     * 
+     * @return False, without taking ownership, if `varname` is not a property.
+     */
+    bool setEntry(const std::string& varname, TableEntry<double>* var);
+
+    /**
+     * Set the table entry values of the equilibrium mass fraction of a 
+     * species. See load() for the arguments.
+     * 
+     * @param[in] name Name of the species.
+     */
+    void loadSpecies(std::string name, 
+                     std::string x_variable, 
+                     std::string y_variable,
+                     std::string x_scale, 
+                     std::string y_scale,
+                     std::vector<double>& x, 
+                     std::vector<double>& y, 
+                     std::vector<std::vector<double>>& z);
+
+    /**
+     * Index of a tabulated species in species_names, or -1 if the species 
+     * was not tabulated.
+     */
+    int speciesIndex(const std::string& name) const;
+
+    /**
+     * Store each species table sparsely, as its compact support (see 
+     * compactSupport), and drop the species that are zero everywhere, e.g. 
+     * those that never exceed the species threshold of table generation.
+     * Interpolated mass fractions are unchanged.
+     */
+    void compactSpecies();
+
+    /**
+     * Locate a temperature and pressure point within the gas tables. The index 
+     * is computed on the axes of the enthalpy table and may be reused for any 
+     * property defined on the same axes (see TableEntry::sameAxes).
+     * 
+     * @param[in] temperature Temperature of the pyrolysis gas mixture.
+     * @param[in] pressure Pressure of the pyrolysis gas mixture.
+     */
+    TableIndex locate(double temperature, double pressure) const { 
+        TableIndex idx = enthalpy->locate(temperature, pressure);
+        ICARUSPYRO_RECORD(if (stats) stats->recordLookup(temperature, pressure, idx));
+        return idx;
+    }
+
+    /**
+     * Locate a point starting from the cell (i, j) of a previous point, see 
+     * TableEntry::locateFrom. Equal to locate(temperature, pressure).
+     */
+    TableIndex locateFrom(double temperature, double pressure, int i, int j) const { 
+        TableIndex idx = enthalpy->locateFrom(temperature, pressure, i, j);
+        ICARUSPYRO_RECORD(if (stats) stats->recordLookup(temperature, pressure, idx));
+        return idx;
+    }
+
+    /**
+     * True if the point lies within the temperature and pressure range of the
+     * enthalpy table.
+     */
+    bool inRange(double temperature, double pressure) const { 
+        return temperature >= enthalpy->x[0] && temperature <= enthalpy->x[enthalpy->nx-1] &&
+               pressure >= enthalpy->y[0] && pressure <= enthalpy->y[enthalpy->ny-1];
+    }
+
+    /**
+     * Use `source` for the properties of points outside of the table range 
+     * instead of clamping to the table edge. The fallback is not owned by the 
+     * table; pass nullptr to restore clamping.
+     */
+    void setFallback(GasTableFallback* source) { 
+        fallback = source;
+    }
+
+    /**
+     * Properties of the gas mixture at a temperature and pressure from the 
+     * fallback, which must be set.
+     */
+    void evaluateFallback(double temperature, double pressure, GasProperties& props) const { 
+        ICARUSPYRO_RECORD(if (stats) stats->recordFallback());
+        fallback->evaluate(temperature, pressure, props);
+    }
+
+    /**
+     * Lookup statistics on the enthalpy table axes, or nullptr when the 
+     * library is built without instrumentation (ICARUSPYRO_INSTRUMENT). 
+     */
+    const TableStats* statistics() const { 
+        return stats.get();
+    }
+
+    /**
+     * Zero the lookup statistics. Lookups in flight may or may not be counted.
+     */
+    void resetStatistics() { 
+        if (stats) stats->reset();
+    }
+
+    /**
+     * Properties of the gas mixture at a temperature and pressure. Points 
+     * within the table range are interpolated from the tables; points outside
+     * are sent to the fallback, if one is set, and clamped otherwise. Missing
+     * tables give zero.
+     */
+    void lookup(double temperature, double pressure, GasProperties& props) const;
+
+    /**
+     * Properties of the points [begin, end) of a batch, e.g. the mesh cells 
+     * of one thread. Each point is located starting from its cell in `cells`
+     * at the previous call, which is then updated, so that points that moved
+     * little since cost a bounds check instead of a search. The properties 
+     * are those of lookup() at each point.
+     * 
+     * Threads may share `cells` and `props` on disjoint ranges of points. 
+     * Both must already hold every point of the batch (see 
+     * TableIndexCache::resize).
+     */
+    void lookup(const std::vector<double>& temperature, 
+                const std::vector<double>& pressure, 
+                size_t begin, 
+                size_t end, 
+                TableIndexCache& cells, 
+                std::vector<GasProperties>& props) const;
+
+    /**
+     * Ratio of specific heats, gas constant, speed of sound and kinematic 
+     * viscosity of a batch of points, from a single pass over the cp, cv, 
+     * mw, density and viscosity tables: each point is located once (when the
+     * axes are shared) and the five properties are interpolated together. 
+     * The gas constant is R/mw, or p/(rho T) where the mw table is missing, 
+     * and the speed of sound is sqrt(gamma R T). Points outside of the table
+     * range use the fallback, if one is set, and are clamped otherwise.
+     * 
+     * After tabulateDerived(), points within the table range are instead 
+     * interpolated from the pre-tabulated derived quantities. Throws 
+     * std::runtime_error if the cp or cv table is missing.
+     * 
+     * @param[out] state Derived properties of each point. Resized to the 
+     *     number of points.
+     */
+    void derivedProperties(const std::vector<double>& temperature, 
+                           const std::vector<double>& pressure, 
+                           GasDerivedState& state) const;
+
+    /**
+     * Tabulate the derived quantities of derivedProperties() at the nodes of
+     * the enthalpy table, interleaved per node so that one cell access 
+     * fetches all of them. Lookups then interpolate the derived quantities 
+     * themselves, which are exact at the nodes but differ from the 
+     * quantities of interpolated properties in between, markedly so for the
+     * kinematic viscosity (~1/p) on coarse pressure grids. Changing a table 
+     * (see setEntry) discards the derived tables.
+     */
+    void tabulateDerived();
+
+    /**
+     * True if the derived quantities are pre-tabulated.
+     */
+    bool derivedTabulated() const { 
+        return !derived.empty();
+    }
+
+    /**
+     * True if every loaded property is defined on the enthalpy table axes, so 
+     * that one located index serves all of them.
+     */
+    bool sharedAxes() const { 
+        return shared_axes;
+    }
+
+    /**
+     * Number of property tables of a gas table, species excluded.
+     */
+    static const int N_PROPERTIES = 9;
+
+    /**
+     * The GasProperties field of each property, in the order of the fields.
+     */
+    static double GasProperties::* const properties[N_PROPERTIES];
+
+    /**
+     * Name of the table of property k (in the order of properties) in a 
+     * database.
+     */
+    static H5std_string propertyName(int k);
+
     std::string pyrolysis_gas;
     TableEntry<double>* cp;
     TableEntry<double>* cv;
@@ -128,12 +452,160 @@ public:
     TableEntry<double>* mw;
     TableEntry<double>* density;
     TableEntry<double>* viscosity;
+    TableEntry<double>* conductivity;
+    TableEntry<double>* reactive_conductivity;
+    std::vector<std::string> species_names;
+    std::vector<TableEntry<double>*> species;
+    GasTableFallback* fallback;
 
 private:
 
     HDF5Names H5Names;
-    TableEntry<double>* readDataSet(Group* group, H5std_string& name);
-    void writeDataSet(Group* group, H5std_string& name, TableEntry<double>* var);
+    bool shared_axes;
+
+    // A table read from a database holds the axes and data of every property
+    // in this single aligned block; its tables are views of it.
+    double* arena;
+
+    std::unique_ptr<TableStats> stats;
+
+    // Derived quantities at the enthalpy table nodes, N_DERIVED per node in 
+    // the order of GasDerivedState, nodes ordered as the table data.
+    static const int N_DERIVED = 4;
+    std::vector<double> derived;
+
+    /**
+     * Derived quantities of point k from the properties of `source` (values
+     * interpolated from the tables or computed by the fallback).
+     */
+    void deriveFromProperties(double temperature, double pressure, const GasProperties& source, 
+                              GasDerivedState& state, size_t k) const;
+
+    /**
+     * Interpolate every property at a point located at `idx` on the enthalpy
+     * table axes; on other axes the point is located again. Missing tables 
+     * give zero.
+     */
+    void interpolateProperties(double temperature, double pressure, const TableIndex& idx, 
+                               GasProperties& props) const;
+
+    void clear();
+
+    void updateSharedAxes();
+
+    TableEntry<double>* newTableEntry(std::string& x_variable, 
+                                      std::string& y_variable,
+                                      std::string& x_scale, 
+                                      std::string& y_scale,
+                                      std::vector<double>& x, 
+                                      std::vector<double>& y, 
+                                      std::vector<std::vector<double>>& z);
+};
+
+/**
+ * Start reading the gas table of a mixture from a database on a background
+ * thread and return at once, so that the caller can do other set-up work
+ * (e.g. mesh partitioning) while the tables are read. The table is obtained,
+ * or the error of the read rethrown, by get() on the returned future.
+ * 
+ * The whole table is read on the one background thread, and pending loads
+ * read one at a time: the serial HDF5 library is not thread safe, so the
+ * caller must not use HDF5 itself until the future is ready.
+ * 
+ * @param pyrolysis_gas_mixture The name of the pyrolysis gas mixture.
+ * @param database The name (and/or full path) of the gas table database.
+ */
+std::future<GasTable> loadGasTableAsync(const std::string& pyrolysis_gas_mixture, 
+                                        const std::string& database);
+
+/**
+ * Open a database file for writing. An existing file is opened for 
+ * read/write so that several mixtures (and B' tables) can share one 
+ * database; otherwise the file is created.
+ * 
+ * @param[in] database Name or full path of the database file.
+ * @param[in] truncate Recreate the file even if it exists. Default is false.
+ * @return The open file, or nullptr if it cannot be opened or created.
+ */
+H5File* openDatabase(const std::string& database, bool truncate = false);
+
+/**
+ * Create (or replace) the group `name` within `parent`.
+ */
+Group* replaceGroup(Group* parent, const H5std_string& name);
+
+/**
+ * Size of the table entry stored as the group `variable` of `group`. 
+ * 
+ * @return False, with a 1x1 size, if the group does not exist.
+ */
+bool readTableShape(Group* group, const H5std_string& variable, int& nx, int& ny);
+
+/**
+ * Read a table entry stored as the group `variable` of `group`. If the group
+ * does not exist, an empty 1x1 table is returned. 
+ * 
+ * @param[in] storage Zero-initialised block of TableEntry::storageSize 
+ *     elements for the table to view, e.g. part of an arena. Default is 
+ *     nullptr, which allocates a block owned by the table.
+ */
+TableEntry<double>* readTableEntry(Group* group, const H5std_string& variable, double* storage = nullptr);
+
+/**
+ * Compact support of a table that is zero over much of its grid, e.g. the
+ * mass fraction of a minor species: the block of rows and columns holding
+ * every nonzero value, widened by one row and column of zeros on each side
+ * within the table. Bilinear interpolation (clamped outside the block) 
+ * gives the same values as on the full table everywhere. The caller owns the
+ * returned entry, or nullptr if the table is zero everywhere.
+ */
+TableEntry<double>* compactSupport(const TableEntry<double>& var);
+
+/**
+ * Write a table entry as the group `variable` of `group`.
+ */
+void writeTableEntry(Group* group, const H5std_string& variable, TableEntry<double>* var);
+
+/**
+ * Writer of a table entry one y row at a time.
+ * 
+ * The z values are stored as a single two-dimensional (ny, nx) dataset, "z",
+ * chunked by row and extensible along y, so rows can be written as soon as 
+ * they are computed and in any order. The y dataset and the ny attribute are
+ * written by close(). readTableEntry reads both this layout and the older 
+ * one with a z_i dataset per row.
+ */
+class TableStream { 
+public:
+    /**
+     * Create the group `variable` of `parent` with the attributes and x axis 
+     * of the table entry.
+     */
+    TableStream(Group* parent, 
+                const H5std_string& variable, 
+                const std::string& x_variable, 
+                const std::string& y_variable,
+                const std::string& x_scale, 
+                const std::string& y_scale,
+                const std::vector<double>& x);
+
+    ~TableStream();
+
+    /**
+     * Write row j, i.e., the z values at y, extending the table if needed.
+     */
+    void writeRow(int j, double y, const double* z);
+
+    /**
+     * Write the y axis and the ny attribute. Called by the destructor.
+     */
+    void close();
+
+private:
+    Group* group;
+    DataSet* z_data;
+    hsize_t nx;
+    std::vector<double> y;
 };
 
 } // end namespace IcarusPyro
@@ -0,0 +1,148 @@
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "yaml-cpp/yaml.h"
+
+#include "generation_jobs.h"
+#include "pyrolysis_gas.h"
+
+namespace IcarusPyro {
+
+namespace {
+
+template<class T>
+void readField(const YAML::Node& node, const char* name, T& value)
+{
+    if (node[name]) value = node[name].as<T>();
+}
+
+std::string gasMixtureName(const GenerationJob& job)
+{
+    return job.gas_mixture_name.empty() ? job.mixture : job.gas_mixture_name;
+}
+
+// Mixture of a job, set up but not computed.
+GasMixture* createMixture(const GenerationJob& job,
+                          const std::string& mu_algorithm,
+                          const std::string& k_algorithm,
+                          int n_threads,
+                          const std::string& cache_directory)
+{
+    std::string mixture(job.mixture);
+    return new GasMixture(mixture,
+                          job.T_low, job.T_high, job.nT, job.T_scale,
+                          job.p_low, job.p_high, job.nP, job.p_scale,
+                          mu_algorithm, k_algorithm,
+                          n_threads, job.species_threshold,
+                          cache_directory, 0, -1, "", false, false);
+}
+
+} // namespace
+
+std::vector<GenerationJob> readJobList(const std::string& file, const GenerationJob& defaults)
+{
+    YAML::Node inputs;
+    try {
+        inputs = YAML::LoadFile(file);
+    } catch (const YAML::Exception& error) {
+        throw std::runtime_error("Could not read job list " + file + ": " + error.what());
+    }
+    YAML::Node list = inputs["jobs"];
+    if (!list || !list.IsSequence()) {
+        throw std::runtime_error("Job list " + file + " has no sequence of jobs.");
+    }
+
+    std::vector<GenerationJob> jobs;
+    for (size_t k = 0; k < list.size(); k++) {
+        YAML::Node node = list[k];
+        if (!node["mixture"]) {
+            throw std::runtime_error("Job " + std::to_string(k) + " of " + file + " has no mixture.");
+        }
+        GenerationJob job = defaults;
+        job.gas_mixture_name.clear();
+        readField(node, "mixture", job.mixture);
+        readField(node, "gas_mixture_name", job.gas_mixture_name);
+        readField(node, "database", job.database);
+        readField(node, "T_low", job.T_low);
+        readField(node, "T_high", job.T_high);
+        readField(node, "nT", job.nT);
+        readField(node, "T_scale", job.T_scale);
+        readField(node, "p_low", job.p_low);
+        readField(node, "p_high", job.p_high);
+        readField(node, "nP", job.nP);
+        readField(node, "p_scale", job.p_scale);
+        readField(node, "species_threshold", job.species_threshold);
+        readField(node, "cost_profile", job.cost_profile);
+        if (job.gas_mixture_name.empty()) job.gas_mixture_name = job.mixture;
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+void runJobs(const std::vector<GenerationJob>& jobs,
+             const std::string& mu_algorithm,
+             const std::string& k_algorithm,
+             int n_threads,
+             int block_size,
+             const std::string& cache_directory,
+             bool skip_up_to_date)
+{
+    std::vector<std::unique_ptr<GasMixture>> mixtures;
+    std::vector<const GenerationJob*> pending;
+    std::vector<GasMixture*> pool;
+    for (size_t k = 0; k < jobs.size(); k++) {
+        const GenerationJob& job = jobs[k];
+        std::unique_ptr<GasMixture> gas(createMixture(job, mu_algorithm, k_algorithm, n_threads, cache_directory));
+        if (skip_up_to_date && tableUpToDate(job.database, gasMixtureName(job), gas->provenance())) {
+            std::cout << "Skipping " << gasMixtureName(job) << ": " << job.database 
+                      << " is up to date" << std::endl;
+            continue;
+        }
+        if (!job.cost_profile.empty()) {
+            std::ifstream in(job.cost_profile.c_str());
+            if (!in) {
+                throw std::runtime_error("Could not open generation profile " + job.cost_profile + ".");
+            }
+            GenerationProfile costs;
+            costs.readJson(in);
+            gas->setCostProfile(costs);
+        }
+        mixtures.push_back(std::move(gas));
+        pending.push_back(&job);
+        pool.push_back(mixtures.back().get());
+    }
+
+    std::cout << "Generating " << pool.size() << " gas tables" << std::endl;
+    GasMixture::computeAll(pool, n_threads, block_size);
+
+    // Serial HDF5: the tables are written one after the other.
+    for (size_t k = 0; k < pool.size(); k++) {
+        mixtures[k]->write(pending[k]->database, pending[k]->gas_mixture_name);
+    }
+}
+
+GasTable ensureGasTable(const GenerationJob& job,
+                        const std::string& mu_algorithm,
+                        const std::string& k_algorithm,
+                        int n_threads,
+                        const std::string& cache_directory,
+                        bool* generated)
+{
+    std::string name = gasMixtureName(job);
+    bool generate = false;
+    {
+        std::unique_ptr<GasMixture> gas(createMixture(job, mu_algorithm, k_algorithm, n_threads, cache_directory));
+        generate = !tableUpToDate(job.database, name, gas->provenance());
+        if (generate) {
+            gas->computeProperties();
+            gas->write(job.database, name);
+        }
+    }
+    if (generated) *generated = generate;
+    return GasTable(name, job.database);
+}
+
+} // namespace IcarusPyro
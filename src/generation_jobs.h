@@ -0,0 +1,79 @@
+#ifndef ICARUSPYRO_GENERATION_JOBS_H
+#define ICARUSPYRO_GENERATION_JOBS_H
+
+#include <string>
+#include <vector>
+
+#include "gas_table.h"
+
+namespace IcarusPyro {
+
+/**
+ * A gas table to generate: the mixture, its temperature and pressure grid
+ * and where to write it. See GasMixture for the parameters.
+ */
+struct GenerationJob {
+    std::string mixture;
+    std::string gas_mixture_name;
+    std::string database = "gas_table.h5";
+    double T_low = 200.0;
+    double T_high = 4000.0;
+    int nT = 76;
+    std::string T_scale = "linear";
+    double p_low = 1.01325;
+    double p_high = 1013250.0;
+    int nP = 6;
+    std::string p_scale = "log10";
+    double species_threshold = -1.0;
+    /** Generation profile (JSON) of an earlier run, to cost the tasks of this one. */
+    std::string cost_profile;
+};
+
+/**
+ * Read a YAML job list: a sequence `jobs` of maps with a `mixture` and any
+ * of the other fields of GenerationJob, e.g.
+ *
+ *     jobs:
+ *       - mixture: tacot24
+ *         nT: 191
+ *       - mixture: air5
+ *         database: air5.h5
+ *         T_high: 10000
+ *
+ * Fields that are not given are taken from `defaults`.
+ */
+std::vector<GenerationJob> readJobList(const std::string& file, const GenerationJob& defaults);
+
+/**
+ * Generate every job of the list on one work-stealing pool (see
+ * GasMixture::computeAll) and write each table to its database.
+ *
+ * @param[in] skip_up_to_date Skip the jobs whose database already holds a 
+ *     table of the same provenance (see tableUpToDate).
+ */
+void runJobs(const std::vector<GenerationJob>& jobs,
+             const std::string& mu_algorithm,
+             const std::string& k_algorithm,
+             int n_threads = 0,
+             int block_size = 16,
+             const std::string& cache_directory = "",
+             bool skip_up_to_date = false);
+
+/**
+ * Gas table of a job: loaded from its database if that holds a table of the
+ * same provenance (mixture file, composition, transport algorithms, grid and
+ * species threshold), otherwise generated, written to the database and then
+ * loaded. Only the Mutation++ set-up is paid when the table is up to date.
+ *
+ * @param[out] generated If not null, set to whether the table was generated.
+ */
+GasTable ensureGasTable(const GenerationJob& job,
+                        const std::string& mu_algorithm,
+                        const std::string& k_algorithm,
+                        int n_threads = 0,
+                        const std::string& cache_directory = "",
+                        bool* generated = nullptr);
+
+} // namespace IcarusPyro
+
+#endif
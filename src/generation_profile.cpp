@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+
+#include "generation_profile.h"
+
+namespace IcarusPyro { 
+
+namespace { 
+
+struct CallStats { 
+    double total;
+    double mean;
+    double max;
+};
+
+CallStats callStats(const std::vector<double>& t, const std::vector<char>& computed)
+{
+    CallStats stats = {0.0, 0.0, 0.0};
+    size_t n = 0;
+    for (size_t k = 0; k < t.size(); k++) { 
+        if (!computed[k]) continue;
+        stats.total += t[k];
+        stats.max = std::max(stats.max, t[k]);
+        n++;
+    }
+    stats.mean = n ? stats.total / n : 0.0;
+    return stats;
+}
+
+void writeStats(std::ostream& out, const CallStats& stats)
+{
+    out << "{\"total\": " << stats.total << ", \"mean\": " << stats.mean 
+        << ", \"max\": " << stats.max << "}";
+}
+
+void writeArray(std::ostream& out, const std::vector<double>& v)
+{
+    out << "[";
+    for (size_t k = 0; k < v.size(); k++) { 
+        out << (k ? ", " : "") << v[k];
+    }
+    out << "]";
+}
+
+/**
+ * Numbers of the JSON array following `key` in `text`, from `pos` on, with 
+ * nested arrays flattened. `pos` is moved past the array.
+ */
+std::vector<double> readArray(const std::string& text, size_t& pos, const std::string& key)
+{
+    pos = text.find("\"" + key + "\"", pos);
+    if (pos != std::string::npos) pos = text.find('[', pos);
+    if (pos == std::string::npos) { 
+        throw std::runtime_error("Generation profile without a " + key + " array.");
+    }
+
+    std::vector<double> values;
+    int depth = 0;
+    do { 
+        char c = text[pos];
+        if (c == '[') depth++;
+        else if (c == ']') depth--;
+        else if (c == '-' || c == '.' || (c >= '0' && c <= '9')) { 
+            char* end;
+            values.push_back(std::strtod(text.c_str() + pos, &end));
+            pos = end - text.c_str();
+            continue;
+        }
+        pos++;
+    } while (depth > 0 && pos < text.size());
+    if (depth > 0) { 
+        throw std::runtime_error("Unterminated " + key + " array in generation profile.");
+    }
+    return values;
+}
+
+} // namespace
+
+void GenerationProfile::reset(const std::vector<double>& T, const std::vector<double>& p, int threads)
+{
+    temperature = T;
+    pressure = p;
+    nT = T.size();
+    n_threads = threads;
+    equilibrate.assign(T.size() * p.size(), 0.0);
+    transport.assign(T.size() * p.size(), 0.0);
+    computed.assign(T.size() * p.size(), 0);
+}
+
+void GenerationProfile::addPhase(const std::string& name, double seconds)
+{
+    for (size_t k = 0; k < phases.size(); k++) { 
+        if (phases[k].first == name) { 
+            phases[k].second += seconds;
+            return;
+        }
+    }
+    phases.push_back(std::make_pair(name, seconds));
+}
+
+double GenerationProfile::phase(const std::string& name) const
+{
+    for (size_t k = 0; k < phases.size(); k++) { 
+        if (phases[k].first == name) return phases[k].second;
+    }
+    return 0.0;
+}
+
+size_t GenerationProfile::computedPoints() const
+{
+    return std::count(computed.begin(), computed.end(), 1);
+}
+
+void GenerationProfile::writeJson(std::ostream& out, const std::string& mixture, int top) const
+{
+    CallStats eq = callStats(equilibrate, computed);
+    CallStats tr = callStats(transport, computed);
+    size_t n_computed = computedPoints();
+
+    std::vector<size_t> order;
+    for (size_t k = 0; k < computed.size(); k++) { 
+        if (computed[k]) order.push_back(k);
+    }
+    size_t n_top = std::min(order.size(), static_cast<size_t>(std::max(top, 0)));
+    std::partial_sort(order.begin(), order.begin() + n_top, order.end(), [&](size_t a, size_t b) { 
+        return equilibrate[a] + transport[a] > equilibrate[b] + transport[b];
+    });
+
+    out << std::setprecision(6);
+    out << "{\n";
+    out << "  \"mixture\": \"" << mixture << "\",\n";
+    out << "  \"grid\": {\"temperature\": " << temperature.size() 
+        << ", \"pressure\": " << pressure.size() << ", \"threads\": " << n_threads << "},\n";
+
+    out << "  \"phases\": {";
+    for (size_t k = 0; k < phases.size(); k++) { 
+        out << (k ? ", " : "") << "\"" << phases[k].first << "\": " << phases[k].second;
+    }
+    out << "},\n";
+
+    out << "  \"points\": {\"computed\": " << n_computed 
+        << ", \"reused\": " << computed.size() - n_computed << ",\n";
+    out << "             \"equilibrate\": ";
+    writeStats(out, eq);
+    out << ",\n             \"transport\": ";
+    writeStats(out, tr);
+    out << "},\n";
+
+    out << "  \"heatmap\": {\n";
+    out << "    \"temperature\": ";
+    writeArray(out, temperature);
+    out << ",\n    \"pressure\": ";
+    writeArray(out, pressure);
+    out << ",\n    \"seconds\": [";
+    for (size_t j = 0; j < pressure.size(); j++) { 
+        out << (j ? ",\n                " : "\n                ") << "[";
+        for (size_t i = 0; i < nT; i++) { 
+            size_t k = j * nT + i;
+            out << (i ? ", " : "") << (computed[k] ? equilibrate[k] + transport[k] : 0.0);
+        }
+        out << "]";
+    }
+    out << "]\n  },\n";
+
+    out << "  \"slowest\": [";
+    for (size_t n = 0; n < n_top; n++) { 
+        size_t k = order[n];
+        out << (n ? ",\n              " : "\n              ") 
+            << "{\"temperature\": " << temperature[k % nT] 
+            << ", \"pressure\": " << pressure[k / nT]
+            << ", \"equilibrate\": " << equilibrate[k] 
+            << ", \"transport\": " << transport[k] << "}";
+    }
+    out << "]\n";
+    out << "}\n";
+}
+
+void GenerationProfile::readJson(std::istream& in)
+{
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t pos = text.find("\"heatmap\"");
+    if (pos == std::string::npos) { 
+        throw std::runtime_error("Generation profile without a heatmap.");
+    }
+    std::vector<double> T = readArray(text, pos, "temperature");
+    std::vector<double> p = readArray(text, pos, "pressure");
+    std::vector<double> seconds = readArray(text, pos, "seconds");
+    if (seconds.size() != T.size() * p.size()) { 
+        throw std::runtime_error("The heatmap of the generation profile does not match its grid.");
+    }
+
+    reset(T, p, 1);
+    phases.clear();
+    for (size_t k = 0; k < seconds.size(); k++) { 
+        equilibrate[k] = seconds[k];
+        computed[k] = (seconds[k] > 0.0);
+    }
+}
+
+double GenerationProfile::meanPointCost(double T_low, double T_high) const
+{
+    if (temperature.empty()) return 0.0;
+    size_t first = std::upper_bound(temperature.begin(), temperature.end(), T_low) - temperature.begin();
+    size_t last = std::lower_bound(temperature.begin(), temperature.end(), T_high) - temperature.begin();
+    first = (first > 0) ? first - 1 : 0;
+    last = std::min(last, nT - 1);
+
+    double total = 0.0, all_total = 0.0;
+    size_t n = 0, all_n = 0;
+    for (size_t k = 0; k < computed.size(); k++) { 
+        if (!computed[k]) continue;
+        double seconds = equilibrate[k] + transport[k];
+        size_t i = k % nT;
+        if (i >= first && i <= last) { 
+            total += seconds;
+            n++;
+        }
+        all_total += seconds;
+        all_n++;
+    }
+    if (n > 0) return total / n;
+    return all_n ? all_total / all_n : 0.0;
+}
+
+void GenerationProfile::print(std::ostream& out) const
+{
+    CallStats eq = callStats(equilibrate, computed);
+    CallStats tr = callStats(transport, computed);
+    std::ios::fmtflags flags(out.flags());
+    std::streamsize precision = out.precision();
+    out << "Generation profile" << std::endl;
+    for (size_t k = 0; k < phases.size(); k++) { 
+        out << "   " << std::setw(12) << std::left << phases[k].first << std::right
+            << std::setw(12) << std::fixed << std::setprecision(3) << phases[k].second << " s" << std::endl;
+    }
+    out << "   " << computedPoints() << " points computed, equilibrate " 
+        << std::scientific << std::setprecision(3) << eq.mean << " s/point (max " << eq.max 
+        << "), transport " << tr.mean << " s/point (max " << tr.max << ")" << std::endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace IcarusPyro
@@ -0,0 +1,98 @@
+#ifndef ICARUSPYRO_GENERATION_PROFILE_H
+#define ICARUSPYRO_GENERATION_PROFILE_H
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace IcarusPyro {
+
+/**
+ * Seconds elapsed since `start`.
+ */
+inline double secondsSince(const std::chrono::steady_clock::time_point& start) 
+{ 
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Timing of a table generation run: wall time per phase (setup, compute, I/O)
+ * and the equilibrium and transport time of every (T, p) grid point.
+ * 
+ * Points are recorded by the thread computing their row, so recordPoint needs
+ * no lock as long as rows are not shared between threads. Points reused from
+ * a cache or checkpoint are not recorded.
+ */
+class GenerationProfile { 
+public:
+    GenerationProfile() : n_threads(1) {}
+
+    /**
+     * Start a profile of the grid temperature x pressure.
+     */
+    void reset(const std::vector<double>& temperature, const std::vector<double>& pressure, int threads);
+
+    /**
+     * Add `seconds` to the wall time of a phase. Phases are reported in the 
+     * order they are first added.
+     */
+    void addPhase(const std::string& name, double seconds);
+
+    /**
+     * Record the cost of the grid point (temperature i, pressure j).
+     */
+    void recordPoint(int j, int i, double equilibrate_seconds, double transport_seconds) { 
+        size_t k = static_cast<size_t>(j) * nT + i;
+        equilibrate[k] = equilibrate_seconds;
+        transport[k] = transport_seconds;
+        computed[k] = 1;
+    }
+
+    /**
+     * Write the report as JSON: the phase times, the statistics of the 
+     * equilibrium and transport calls, a (pressure, temperature) heatmap of 
+     * the cost per point and the `top` slowest points. Times are in seconds.
+     */
+    void writeJson(std::ostream& out, const std::string& mixture, int top = 10) const;
+
+    /**
+     * Restore the grid and point times from the heatmap of a report written 
+     * by writeJson, e.g. of an earlier run, to cost the tasks of a new one 
+     * (see meanPointCost). Points of zero time were not computed. Throws 
+     * std::runtime_error if the report has no valid heatmap.
+     */
+    void readJson(std::istream& in);
+
+    /**
+     * Write a short summary of the phases and point costs.
+     */
+    void print(std::ostream& out) const;
+
+    /**
+     * Mean equilibrium and transport time of the computed points from the last
+     * temperature of the grid at or below T_low to the first at or above 
+     * T_high, at every pressure; the mean of every computed point if there 
+     * is none there, and zero if no point was computed.
+     */
+    double meanPointCost(double T_low, double T_high) const;
+
+    size_t computedPoints() const;
+
+    double phase(const std::string& name) const;
+
+private:
+    std::vector<double> temperature;
+    std::vector<double> pressure;
+    size_t nT;
+    int n_threads;
+    std::vector<std::pair<std::string, double>> phases;
+    std::vector<double> equilibrate;
+    std::vector<double> transport;
+    std::vector<char> computed;
+};
+
+} // namespace IcarusPyro
+
+#endif
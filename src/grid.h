@@ -0,0 +1,33 @@
+#ifndef ICARUSPYRO_GRID_H
+#define ICARUSPYRO_GRID_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace IcarusPyro {
+
+/**
+ * Fill `var` with N points evenly distributed between low and high, either on
+ * a linear scale or, for scale "log10", on a logarithmic scale.
+ */
+inline void makeRange(double low, double high, int N, const std::string& scale, std::vector<double>& var) { 
+    var.resize(N);
+    if (N == 1) { 
+        var[0] = low;
+        return;
+    }
+    if (scale == "log10") { 
+        double dv = (std::log10(high) - std::log10(low)) / static_cast<double>(N - 1);
+        for (int i = 0; i < N; i++)
+            var[i] = std::pow(10.0, std::log10(low) + dv * i);
+    } else { 
+        double dv = (high - low) / static_cast<double>(N - 1);
+        for (int i = 0; i < N; i++)
+            var[i] = low + dv * i;
+    }
+}
+
+} // namespace IcarusPyro
+
+#endif
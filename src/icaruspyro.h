@@ -9,7 +9,24 @@
  */
 
 #include "gas_table.h"
+#include "table_handle.h"
 #include "table_entry.h"
+#include "table_stats.h"
+#include "compressed_table.h"
 #include "pyrolysis_gas.h"
+#include "generation_jobs.h"
+#include "ensemble.h"
+#include "equilibrium_cache.h"
+#include "memo_cache.h"
+#include "table_merge.h"
+#include "checkpoint.h"
+#include "legacy_table.h"
+#include "table_validation.h"
+#include "table_resample.h"
+#include "table_provenance.h"
+#include "bprime_table.h"
+#include "surface_gas.h"
+#include "material.h"
+#include "pyro.h"
 
 #endif
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "legacy_table.h"
+
+namespace IcarusPyro { 
+
+namespace { 
+
+/**
+ * Parse the next number of `line` at `pos`, advancing `pos` past it. 
+ */
+bool parseNumber(const char*& pos, double& value)
+{
+    char* end;
+    errno = 0;
+    value = std::strtod(pos, &end);
+    if (end == pos || errno == ERANGE) return false;
+    pos = end;
+    return true;
+}
+
+/**
+ * Scale of an axis: log10 if its points form a geometric sequence with
+ * decade steps, as the pressures of the legacy tables do, and linear otherwise.
+ */
+std::string axisScale(const double* v, int n)
+{
+    if (n < 2 || v[0] <= 0.0) return "linear";
+    for (int i = 1; i < n; i++) { 
+        if (std::fabs(v[i] / (v[i-1] * 10.0) - 1.0) > 1.0e-6) return "linear";
+    }
+    return "log10";
+}
+
+/**
+ * Name of the GasTable property (see GasTable::load) of a section, or an 
+ * empty string. The legacy CP and CV are functions of (energy, density), not
+ * of the (temperature, pressure) of the GasTable properties.
+ */
+std::string propertyName(const std::string& section)
+{
+    if (section == "eint") return "internal_energy";
+    if (section == "enthalpy" || section == "density" || section == "viscosity") return section;
+    return "";
+}
+
+/**
+ * Name of the database group of a section. The (energy, density) CP and CV 
+ * are stored apart from the (temperature, pressure) cp and cv of GasTable.
+ */
+std::string groupName(const std::string& section)
+{
+    if (section == "cp" || section == "cv") return section + "_energy_density";
+    return section;
+}
+
+} // namespace
+
+LegacyTableReader::LegacyTableReader(const std::string& file_name)
+    : file_name(file_name),
+      in(file_name.c_str()),
+      line_number(0)
+{
+    if (!in) { 
+        throw std::runtime_error("Could not open legacy gas table " + file_name + ".");
+    }
+}
+
+bool LegacyTableReader::nextLine()
+{
+    while (std::getline(in, line)) { 
+        line_number++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) continue;
+        size_t last = line.find_last_not_of(" \t\r");
+        line = line.substr(first, last - first + 1);
+        return true;
+    }
+    return false;
+}
+
+void LegacyTableReader::fail(const std::string& message) const
+{
+    throw std::runtime_error(file_name + ":" + std::to_string(line_number) + ": " + message);
+}
+
+TableEntry<double>* LegacyTableReader::next(std::string& section)
+{
+    while (nextLine()) { 
+        if (line.front() != '[' || line.back() != ']') continue;
+        section = line.substr(1, line.size() - 2);
+        std::transform(section.begin(), section.end(), section.begin(), ::tolower);
+
+        if (section == "gas") { 
+            if (!nextLine()) fail("Missing mixture name.");
+            mixture_name = line;
+            continue;
+        }
+
+        if (!nextLine() || line != "table-lookup-2D") { 
+            fail("Unsupported section type in [" + section + "].");
+        }
+
+        int ny = 0, nx = 0;
+        double x_min, x_max;
+        const char* pos;
+        double value;
+        if (!nextLine() || !parseNumber(pos = line.c_str(), value) || (ny = static_cast<int>(value)) < 1) fail("Invalid ny.");
+        if (!nextLine() || !parseNumber(pos = line.c_str(), value) || (nx = static_cast<int>(value)) < 1) fail("Invalid nx.");
+        if (!nextLine() || !parseNumber(pos = line.c_str(), x_min)) fail("Invalid minimum x.");
+        if (!nextLine() || !parseNumber(pos = line.c_str(), x_max)) fail("Invalid maximum x.");
+
+        bool tp = (section == "enthalpy" || section == "eint" || 
+                   section == "density" || section == "viscosity");
+        bool ed = (section == "cp" || section == "cv" || 
+                   section == "pressure" || section == "temperature");
+        std::string x_variable = tp ? "temperature" : (ed ? "energy" : "x");
+        std::string y_variable = tp ? "pressure" : (ed ? "density" : "y");
+
+        std::unique_ptr<TableEntry<double>> var(new TableEntry<double>(nx, ny, x_variable, y_variable, "linear", "linear"));
+
+        if (!nextLine()) fail("Missing y values.");
+        pos = line.c_str();
+        for (int j = 0; j < ny; j++) { 
+            if (!parseNumber(pos, var->y[j])) fail("Expected " + std::to_string(ny) + " y values.");
+        }
+
+        for (int i = 0; i < nx; i++) { 
+            if (!nextLine()) fail("Expected " + std::to_string(nx) + " rows in [" + section + "].");
+            pos = line.c_str();
+            if (!parseNumber(pos, var->x[i])) fail("Invalid x value.");
+            for (int j = 0; j < ny; j++) { 
+                if (!parseNumber(pos, (*var->z)(i, j))) fail("Expected " + std::to_string(ny) + " z values.");
+            }
+        }
+
+        // The scales are only known once the axes are read.
+        var->setScales(axisScale(var->x, nx), axisScale(var->y, ny));
+        return var.release();
+    }
+    return nullptr;
+}
+
+std::string convertLegacyTable(const std::string& legacy_file, 
+                               const std::string& database, 
+                               const std::string& gas_mixture_name)
+{
+    LegacyTableReader reader(legacy_file);
+    std::unique_ptr<H5File> file;
+    std::unique_ptr<Group> gas;
+    std::string gas_name;
+
+    std::string section;
+    while (true) { 
+        std::unique_ptr<TableEntry<double>> var(reader.next(section));
+        if (!var) break;
+
+        // The [GAS] section precedes the tables, so the group is created 
+        // when the first table is read.
+        if (!gas) { 
+            gas_name = gas_mixture_name.empty() ? reader.mixture() : gas_mixture_name;
+            if (gas_name.empty()) { 
+                throw std::runtime_error("No mixture name in " + legacy_file + ".");
+            }
+            std::cout << "Writing database file : " << database 
+                      << " for gas mixture : " << gas_name << std::endl;
+            file.reset(openDatabase(database));
+            if (!file) { 
+                throw std::runtime_error("Could not open database " + database + ".");
+            }
+            std::unique_ptr<Group> root(new Group(file->openGroup("/")));
+            gas.reset(replaceGroup(root.get(), gas_name));
+        }
+
+        std::cout << "   Writing " << section << " data " << std::endl;
+        writeTableEntry(gas.get(), groupName(section), var.get());
+    }
+    return gas_name;
+}
+
+void loadLegacyTable(const std::string& legacy_file, GasTable& table)
+{
+    LegacyTableReader reader(legacy_file);
+    std::string section;
+    while (TableEntry<double>* var = reader.next(section)) { 
+        std::string name = propertyName(section);
+        if (name.empty() || !table.setEntry(name, var)) { 
+            delete var;
+        }
+    }
+}
+
+} // namespace IcarusPyro
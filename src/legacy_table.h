@@ -0,0 +1,95 @@
+#ifndef ICARUSPYRO_LEGACY_TABLE_H
+#define ICARUSPYRO_LEGACY_TABLE_H
+
+#include <fstream>
+#include <string>
+
+#include "gas_table.h"
+#include "table_entry.h"
+
+namespace IcarusPyro {
+
+/**
+ * Reader of legacy Icarus gas table files (gas_table.db).
+ * 
+ * The file holds a [GAS] section with the mixture name followed by one 
+ * `table-lookup-2D` section per property:
+ * 
+ *     [ENTHALPY]
+ *     table-lookup-2D
+ *     ny
+ *     nx
+ *     min x
+ *     max x
+ *     y_1 ... y_ny
+ *     x_1 z_11 ... z_1ny
+ *     ...
+ *     x_nx z_nx1 ... z_nxny
+ * 
+ * ENTHALPY, EINT, DENSITY and VISCOSITY are functions of (temperature, 
+ * pressure); CP, CV, PRESSURE and TEMPERATURE of (energy, density). The file
+ * is parsed one section at a time, straight into a TableEntry.
+ */
+class LegacyTableReader { 
+public:
+    /**
+     * Open a legacy gas table file. Throws std::runtime_error if it cannot be
+     * opened.
+     */
+    explicit LegacyTableReader(const std::string& file_name);
+
+    /**
+     * Read the next table section. 
+     * 
+     * @param[out] section Name of the section, in lower case (e.g. "enthalpy").
+     * @return The table, owned by the caller, or nullptr at the end of the 
+     *     file. Throws std::runtime_error on a malformed section.
+     */
+    TableEntry<double>* next(std::string& section);
+
+    /**
+     * Name of the mixture given in the [GAS] section, if read yet.
+     */
+    const std::string& mixture() const { 
+        return mixture_name;
+    }
+
+private:
+    std::string file_name;
+    std::ifstream in;
+    std::string mixture_name;
+    std::string line;
+    int line_number;
+
+    bool nextLine();
+
+    [[noreturn]] void fail(const std::string& message) const;
+};
+
+/**
+ * Convert a legacy gas table file into the group `gas_mixture_name` of an HDF5
+ * database, in double precision. Every table section is written under its 
+ * name in lower case, including the (energy, density) tables of pressure and 
+ * temperature. The (energy, density) CP and CV are written as cp_energy_density
+ * and cv_energy_density, so that GasTable does not read them as its 
+ * (temperature, pressure) cp and cv.
+ * 
+ * @param[in] legacy_file Name of the legacy gas_table.db file.
+ * @param[in] database Name of the HDF5 database, created if needed.
+ * @param[in] gas_mixture_name Name of the mixture group. Default is the 
+ *     mixture named in the legacy file.
+ * @return Name of the mixture group written.
+ */
+std::string convertLegacyTable(const std::string& legacy_file, 
+                               const std::string& database, 
+                               const std::string& gas_mixture_name = "");
+
+/**
+ * Load the properties of a legacy gas table file into `table`. Sections 
+ * without a GasTable property, i.e. the (energy, density) tables, are skipped.
+ */
+void loadLegacyTable(const std::string& legacy_file, GasTable& table);
+
+} // namespace IcarusPyro
+
+#endif
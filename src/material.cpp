@@ -1,6 +1,9 @@
 /* Define a material.
 */ 
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -10,38 +13,246 @@ using std::string;
 
 namespace IcarusPyro {
 
-Material::Material(const string database) {
+const double Material::T_ref = 298.15;
+
+namespace {
+
+const double STEFAN_BOLTZMANN = 5.670374419e-8;
+
+// Constant virgin and char values of a surface property, e.g. 
+// emissivity: {virgin: {constant: 0.8}, char: {constant: 0.9}}.
+void readSurfaceProperty(const YAML::Node& node, double& virgin, double& charred)
+{
+    virgin = node["virgin"]["constant"].as<double>();
+    charred = node["char"]["constant"].as<double>();
+}
+
+} // namespace
+
+double Polynomial::evaluate(const double T) const { 
+    double value = 0.0;
+    for (size_t k = 0; k < exponents.size(); k++) { 
+        value += coefficients[k] * std::pow(T, exponents[k]);
+    }
+    return value;
+}
+
+double Polynomial::integrate(const double T_ref, const double T) const { 
+    double value = 0.0;
+    for (size_t k = 0; k < exponents.size(); k++) { 
+        int n = exponents[k] + 1;
+        if (n == 0) { 
+            value += coefficients[k] * std::log(T / T_ref);
+        } else { 
+            value += coefficients[k] * (std::pow(T, n) - std::pow(T_ref, n)) / n;
+        }
+    }
+    return value;
+}
+
+Material::Material(const string database) 
+    : p_state(0.0),
+      T_state(T_ref),
+      rho_state(0.0),
+      Yv_state(1.0),
+      beta_state(0.0),
+      pyrolyzing(false),
+      rho_v(0.0),
+      rho_c(0.0),
+      hf_v(0.0),
+      hf_c(0.0),
+      eps_v(1.0),
+      eps_c(1.0),
+      alpha_v(1.0),
+      alpha_c(1.0)
+{
+    read_database(database.c_str());
+    set_density(rho_v);
+}
+
+void Material::read_database(const char* datafile) { 
     // Parse the database
-    YAML::Node inputs = YAML::LoadFile(database);
+    YAML::Node inputs = YAML::LoadFile(datafile);
     name = inputs["name"].as<std::string>();
+    if (inputs["pryolyzing"]) pyrolyzing = inputs["pryolyzing"].as<bool>();
+    if (inputs["pyrolyzing"]) pyrolyzing = inputs["pyrolyzing"].as<bool>();
+    if (inputs["state_model"]) state_model = inputs["state_model"].as<std::string>();
+
+    // The state is defined by the solid density: without the virgin and 
+    // char densities the mass fractions divide by zero.
+    if (!inputs["density"] || !inputs["density"]["virgin"] || !inputs["density"]["char"]) { 
+        throw std::runtime_error("Material " + name + " has no virgin and char densities.");
+    }
+    rho_v = inputs["density"]["virgin"].as<double>();
+    rho_c = inputs["density"]["char"].as<double>();
+    if (!(rho_v > rho_c && rho_c > 0.0)) { 
+        throw std::runtime_error("Material " + name + " needs virgin density > char density > 0.");
+    }
+    if (inputs["heat_of_formation"]) { 
+        hf_v = inputs["heat_of_formation"]["virgin"].as<double>();
+        hf_c = inputs["heat_of_formation"]["char"].as<double>();
+    }
+    if (inputs["specific_heat"]) { 
+        YAML::Node virgin = inputs["specific_heat"]["virgin"]["polynomial"];
+        cp_v.exponents = virgin["exponents"].as<std::vector<int>>();
+        cp_v.coefficients = virgin["coefficients"].as<std::vector<double>>();
+        YAML::Node charred = inputs["specific_heat"]["char"]["polynomial"];
+        cp_c.exponents = charred["exponents"].as<std::vector<int>>();
+        cp_c.coefficients = charred["coefficients"].as<std::vector<double>>();
+    }
+    if (inputs["porosity"]) { 
+        porosity_beta = inputs["porosity"]["tabular_data"]["x"].as<std::vector<double>>();
+        porosity_data = inputs["porosity"]["tabular_data"]["y"].as<std::vector<double>>();
+    }
+    if (inputs["decomposition_model"]) { 
+        YAML::Node model = inputs["decomposition_model"];
+        std::vector<std::string> names = model["components"].as<std::vector<std::string>>();
+        for (size_t k = 0; k < names.size(); k++) { 
+            YAML::Node c = model[names[k]];
+            DecompositionComponent component;
+            component.name = names[k];
+            component.volume_fraction = c["initial_volume_fraction"].as<double>();
+            component.initial_density = c["initial_density"].as<double>();
+            component.residual_density = c["residual_density"].as<double>();
+            component.preexponential_factor = c["preexponential_factor"].as<double>();
+            component.exponent = c["exponent"].as<double>();
+            component.temperature_exponent = c["temperature_exponent"].as<double>();
+            component.activation_temperature = c["activation_temperature"].as<double>();
+            component.minimum_temperature = c["minimum_reaction_temperature"].as<double>();
+            components.push_back(component);
+        }
+    }
+    if (inputs["emissivity"]) readSurfaceProperty(inputs["emissivity"], eps_v, eps_c);
+    if (inputs["absorptivity"]) readSurfaceProperty(inputs["absorptivity"], alpha_v, alpha_c);
 }
 
 double Material::enthalpy() { 
-    return 0.0;
+    return solid_enthalpy(T_state, Yv_state);
+}
+
+double Material::porosity(const double beta) const { 
+    int n = porosity_beta.size();
+    if (n == 0) return 0.0;
+    if (n == 1 || beta <= porosity_beta[0]) return porosity_data[0];
+    if (beta >= porosity_beta[n-1]) return porosity_data[n-1];
+    int k = 0;
+    while (beta > porosity_beta[k+1]) k++;
+    double w = (beta - porosity_beta[k]) / (porosity_beta[k+1] - porosity_beta[k]);
+    return porosity_data[k] + w * (porosity_data[k+1] - porosity_data[k]);
+}
+
+double Material::decomposition_rate(const double T, const double density) const { 
+    double beta = decomposition_fraction(density);
+    double rate = 0.0;
+    for (size_t k = 0; k < components.size(); k++) { 
+        const DecompositionComponent& c = components[k];
+        if (T < c.minimum_temperature || c.preexponential_factor == 0.0) continue;
+        double rho_k = c.initial_density - beta * (c.initial_density - c.residual_density);
+        if (rho_k <= c.residual_density) continue;
+        double extent = (rho_k - c.residual_density) / c.initial_density;
+        rate -= c.volume_fraction * c.preexponential_factor * std::pow(T, c.temperature_exponent) 
+              * std::exp(-c.activation_temperature / T) * c.initial_density * std::pow(extent, c.exponent);
+    }
+    return rate;
 }
 
 void Material::computeEnthalpy(const std::vector<double>& temperature, 
                                const std::vector<double>& pressure, 
                                const std::vector<double>& virgin_mass_fraction, 
                                std::vector<double>& h) {
-    for (std::vector<double>::iterator it = h.begin(); it != h.end(); ++it) { 
-        *it = 1.0;
-    }                            
+    computeEnthalpy(temperature, virgin_mass_fraction, h);
 }
 
 void Material::computeEnthalpy(const std::vector<double>& temperature, 
                                const std::vector<double>& virgin_mass_fraction, 
                                std::vector<double>& h) {
-    for (std::vector<double>::iterator it = h.begin(); it != h.end(); ++it) { 
-        *it = 2.0;
+    h.resize(temperature.size());
+    for (size_t k = 0; k < temperature.size(); k++) { 
+        h[k] = solid_enthalpy(temperature[k], virgin_mass_fraction[k]);
     }                            
 }
 
 void Material::computeEnthalpy(const std::vector<double>& temperature, 
                                std::vector<double>& h) {
-    for (std::vector<double>::iterator it = h.begin(); it != h.end(); ++it) { 
-        *it = 3.0;
+    h.resize(temperature.size());
+    for (size_t k = 0; k < temperature.size(); k++) { 
+        h[k] = solid_enthalpy(temperature[k], Yv_state);
     }                            
 }
 
-} // namespace IcarusPyro
\ No newline at end of file
+int Material::computeSurfaceTemperature(const std::vector<double>& convective_flux, 
+                                        const std::vector<double>& radiative_flux, 
+                                        const std::vector<double>& char_fraction, 
+                                        const std::vector<double>& conductance, 
+                                        const std::vector<double>& interior_temperature, 
+                                        std::vector<double>& temperature, 
+                                        const double environment_temperature, 
+                                        const double tolerance, 
+                                        const int max_iterations) const { 
+    size_t n = convective_flux.size();
+    bool conducting = !conductance.empty();
+    if (radiative_flux.size() != n || char_fraction.size() != n || 
+        (conducting && (conductance.size() != n || interior_temperature.size() != n))) { 
+        throw std::runtime_error("Surface energy balance inputs of different sizes.");
+    }
+
+    // Per-face coefficients of the balance f(T) = q_in + G T_in - G T - a T^4.
+    double T4_env = std::pow(environment_temperature, 4);
+    // Without a guess, start from the larger of the radiative equilibrium 
+    // and interior temperatures, where f <= 0: f is concave and decreasing, 
+    // so Newton descends monotonically to the root. The root is positive 
+    // only if f(0) > 0, and so are then the iterates and f' < 0.
+    bool guess = (temperature.size() == n);
+    temperature.resize(n);
+    std::vector<double> a(n), q(n), G(n, 0.0);
+    for (size_t k = 0; k < n; k++) { 
+        a[k] = STEFAN_BOLTZMANN * emissivity(char_fraction[k]);
+        q[k] = convective_flux[k] + absorptivity(char_fraction[k]) * radiative_flux[k] + a[k] * T4_env;
+        double T_in = 0.0;
+        if (conducting) { 
+            G[k] = conductance[k];
+            T_in = interior_temperature[k];
+        }
+        if (!(a[k] > 0.0 || G[k] > 0.0)) { 
+            throw std::runtime_error("Surface energy balance of face " + std::to_string(k) + 
+                                     " has neither emission nor conduction.");
+        }
+        if (!(q[k] + G[k] * T_in > 0.0)) { 
+            throw std::runtime_error("Surface energy balance of face " + std::to_string(k) + 
+                                     " has no positive temperature solution.");
+        }
+        if (!guess || !(temperature[k] > 0.0)) { 
+            double T_rad = (a[k] > 0.0) ? std::pow(std::max(q[k], 0.0) / a[k], 0.25) : 0.0;
+            temperature[k] = std::max(T_rad, T_in);
+        }
+        q[k] += G[k] * T_in;
+    }
+
+    std::vector<unsigned char> active(n, 1);
+    size_t remaining = n;
+    int sweep = 0;
+    while (remaining > 0) { 
+        if (sweep == max_iterations) { 
+            throw std::runtime_error("Surface energy balance did not converge on " + 
+                                     std::to_string(remaining) + " faces.");
+        }
+        sweep++;
+        double* T = temperature.data();
+        unsigned char* mask = active.data();
+        for (size_t k = 0; k < n; k++) { 
+            double T3 = T[k] * T[k] * T[k];
+            double f = q[k] - G[k] * T[k] - a[k] * T3 * T[k];
+            double df = -G[k] - 4.0 * a[k] * T3;
+            double T_new = T[k] - f / df;
+            // A guess far below the root can overshoot to T <= 0: halve instead.
+            T_new = (T_new > 0.0) ? T_new : 0.5 * T[k];
+            bool converged = std::abs(T_new - T[k]) <= tolerance * T_new;
+            T[k] = mask[k] ? T_new : T[k];
+            mask[k] = mask[k] && !converged;
+        }
+        remaining = std::count(active.begin(), active.end(), 1);
+    }
+    return sweep;
+}
+
+} // namespace IcarusPyro
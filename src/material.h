@@ -11,6 +11,37 @@
 
 namespace IcarusPyro { 
 
+/**
+ * Polynomial in temperature with arbitrary integer exponents, e.g., the 
+ * specific heat fits cp(T) = sum_k c_k T^e_k of the material database.
+ */
+struct Polynomial {
+    std::vector<int> exponents;
+    std::vector<double> coefficients;
+
+    double evaluate(const double T) const;
+
+    /**
+     * Definite integral of the polynomial from T_ref to T.
+     */
+    double integrate(const double T_ref, const double T) const;
+};
+
+/**
+ * Arrhenius parameters of a single decomposing solid component.
+ */
+struct DecompositionComponent {
+    std::string name;
+    double volume_fraction;
+    double initial_density;
+    double residual_density;
+    double preexponential_factor;
+    double exponent;
+    double temperature_exponent;
+    double activation_temperature;
+    double minimum_temperature;
+};
+
 class Material
 {
  public:
@@ -28,6 +59,18 @@ class Material
         return name;
     }
 
+    double get_density() const { 
+        return rho_state;
+    }
+
+    double get_virgin_density() const { 
+        return rho_v;
+    }
+
+    double get_char_density() const { 
+        return rho_c;
+    }
+
     void set_state(const double temperature, const double pressure, const double density) {
         T_state = temperature;
         p_state = pressure;
@@ -48,6 +91,44 @@ class Material
 
     double enthalpy();
 
+    /**
+     * Solid enthalpy (J/kg) at temperature T of a virgin/char blend with the 
+     * given virgin mass fraction. Each phase is its heat of formation plus 
+     * the integral of its specific heat polynomial from 298.15 K.
+     */
+    double solid_enthalpy(const double T, const double Yv) const { 
+        return Yv * (hf_v + cp_v.integrate(T_ref, T)) + (1.0 - Yv) * (hf_c + cp_c.integrate(T_ref, T));
+    }
+
+    /**
+     * Solid specific heat (J/kg/K) of a virgin/char blend, i.e., the 
+     * temperature derivative of solid_enthalpy().
+     */
+    double solid_cp(const double T, const double Yv) const { 
+        return Yv * cp_v.evaluate(T) + (1.0 - Yv) * cp_c.evaluate(T);
+    }
+
+    /**
+     * Porosity interpolated from the tabular data as a function of the 
+     * decomposition fraction.
+     */
+    double porosity(const double beta) const;
+
+    /**
+     * Rate of change of the solid density (kg/m^3/s, non-positive) from the
+     * Arrhenius decomposition model. The components are assumed to share the 
+     * decomposition fraction implied by the bulk solid density.
+     */
+    double decomposition_rate(const double T, const double density) const;
+
+    double decomposition_fraction(const double density) const {
+        return (rho_v - density) / (rho_v - rho_c);
+    }
+
+    double virgin_mass_fraction(const double density) const {
+        return rho_v / (rho_v - rho_c) * (1.0 - rho_c / density);
+    }
+
     void computeEnthalpy(const std::vector<double>& temperature, 
                          const std::vector<double>& pressure, 
                          const std::vector<double>& virgin_mass_fraction, 
@@ -60,18 +141,60 @@ class Material
     void computeEnthalpy(const std::vector<double>& temperature, 
                          std::vector<double>& h);
 
-    void read_database(const char* datafile);
-
- private:
-
-    double decomposition_fraction(const double density) const {
-        return (rho_v - density) / (rho_v - rho_c);
+    /**
+     * Surface emissivity of a virgin/char blend, linear in the char fraction
+     * (0 virgin, 1 char), e.g. the decomposition fraction of the surface.
+     */
+    double emissivity(const double char_fraction) const { 
+        return eps_v + char_fraction * (eps_c - eps_v);
     }
 
-    double virgin_mass_fraction(const double density) const {
-        return rho_v / (rho_v - rho_c) * (1.0 - rho_c / density);
+    /**
+     * Surface absorptivity of a virgin/char blend, see emissivity().
+     */
+    double absorptivity(const double char_fraction) const { 
+        return alpha_v + char_fraction * (alpha_c - alpha_v);
     }
 
+    /**
+     * Solve the surface energy balance of a batch of wall faces for their 
+     * temperature T,
+     * 
+     *     q_conv + alpha q_rad - eps sigma (T^4 - T_env^4) - G (T - T_in) = 0,
+     * 
+     * with alpha and eps blended by the char fraction of each face and G the
+     * conductance (W/m^2/K) to the interior temperature T_in of the face's 
+     * cell. The balance decreases monotonically in T, so Newton converges to
+     * its unique root. All faces iterate together in branch-free sweeps over
+     * the arrays, each face masked off once its update falls below 
+     * `tolerance` relative to its temperature.
+     * 
+     * @param[in] conductance Empty, or per face; empty gives radiative 
+     *     equilibrium (G = 0).
+     * @param[in] interior_temperature Empty when the conductance is, or per face.
+     * @param[in,out] temperature Initial guess of each face or, if not of the
+     *     size of the batch, replaced by an upper bound of the solution, 
+     *     from which Newton converges monotonically. Guesses that are not 
+     *     positive are replaced likewise. Receives the solution.
+     * @return Number of Newton sweeps. Throws std::runtime_error if a face 
+     *     has not converged within `max_iterations`, or has no positive 
+     *     solution: the flux it receives, with the conduction from the 
+     *     interior at T = 0, is not positive.
+     */
+    int computeSurfaceTemperature(const std::vector<double>& convective_flux, 
+                                  const std::vector<double>& radiative_flux, 
+                                  const std::vector<double>& char_fraction, 
+                                  const std::vector<double>& conductance, 
+                                  const std::vector<double>& interior_temperature, 
+                                  std::vector<double>& temperature, 
+                                  const double environment_temperature = 0.0, 
+                                  const double tolerance = 1.0e-10, 
+                                  const int max_iterations = 50) const;
+
+    void read_database(const char* datafile);
+
+ private:
+
     double p_state; 
     double T_state;
     double rho_state;
@@ -83,8 +206,21 @@ class Material
     std::string state_model;
     double rho_v;
     double rho_c;
+    double hf_v;
+    double hf_c;
+    Polynomial cp_v;
+    Polynomial cp_c;
+    std::vector<double> porosity_beta;
+    std::vector<double> porosity_data;
+    std::vector<DecompositionComponent> components;
+    double eps_v;
+    double eps_c;
+    double alpha_v;
+    double alpha_c;
+
+    static const double T_ref;
 };
 
 } // namespace IcarusPyro
 
-#endif
\ No newline at end of file
+#endif
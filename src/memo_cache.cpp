@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "memo_cache.h"
+
+namespace IcarusPyro { 
+
+namespace { 
+
+const char MEMO_MAGIC[8] = {'I', 'P', 'M', 'E', 'M', 'O', '1', '\0'};
+
+std::string dataDirectory()
+{
+    const char* data_directory = std::getenv("MPP_DATA_DIRECTORY");
+    return data_directory ? data_directory : ".";
+}
+
+bool readable(const std::string& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode) && 
+           static_cast<bool>(std::ifstream(path.c_str()));
+}
+
+// Regular files of a directory, in name order.
+std::vector<std::string> directoryFiles(const std::string& directory)
+{
+    std::vector<std::string> files;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) return files;
+    while (struct dirent* entry = readdir(dir)) { 
+        std::string path = directory + "/" + entry->d_name;
+        if (readable(path)) files.push_back(path);
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+bool writeAll(int fd, const char* data, size_t size)
+{
+    while (size > 0) { 
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+} // namespace
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t k = 0; k < size; k++) { 
+        hash ^= bytes[k];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t hashFile(const std::string& path, uint64_t hash)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) { 
+        throw std::runtime_error("Could not read " + path + ".");
+    }
+
+    std::vector<char> buffer(1 << 16);
+    while (file) { 
+        file.read(buffer.data(), buffer.size());
+        hash = fnv1a(buffer.data(), file.gcount(), hash);
+    }
+    return hash;
+}
+
+std::string mixtureFilePath(const std::string& mixture)
+{
+    if (readable(mixture)) return mixture;
+    std::string path = dataDirectory() + "/mixtures/" + mixture + ".xml";
+    if (!readable(path)) { 
+        throw std::runtime_error("Could not find the mixture file of " + mixture + 
+                                 " (looked for " + path + "; is MPP_DATA_DIRECTORY set?).");
+    }
+    return path;
+}
+
+std::vector<std::string> speciesDatabaseFiles()
+{
+    std::vector<std::string> files = directoryFiles(dataDirectory() + "/thermo");
+    std::vector<std::string> transport = directoryFiles(dataDirectory() + "/transport");
+    files.insert(files.end(), transport.begin(), transport.end());
+    return files;
+}
+
+uint64_t hashMixtureData(const std::string& mixture)
+{
+    uint64_t hash = hashFile(mixtureFilePath(mixture));
+    std::vector<std::string> files = speciesDatabaseFiles();
+    for (size_t k = 0; k < files.size(); k++) hash = hashFile(files[k], hash);
+    return hash;
+}
+
+std::string MemoCache::makeKey(const std::string& mixture, 
+                               const std::vector<double>& Xe, 
+                               const std::string& mu_algorithm, 
+                               const std::string& k_algorithm)
+{
+    uint64_t hash = hashMixtureData(mixture);
+    hash = fnv1a(Xe.data(), Xe.size() * sizeof(double), hash);
+    hash = fnv1a(mu_algorithm.data(), mu_algorithm.size(), hash);
+    hash = fnv1a("/", 1, hash);
+    hash = fnv1a(k_algorithm.data(), k_algorithm.size(), hash);
+
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+MemoCache::MemoCache(const std::string& directory, const std::string& key, int n_values)
+    : file_name(directory + "/" + key + ".memo"),
+      n_values(n_values)
+{
+    mkdir(directory.c_str(), 0755);
+
+    std::ifstream file(file_name.c_str(), std::ios::binary);
+    if (!file) return;
+
+    char magic[8];
+    int32_t n_stored = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&n_stored), sizeof(n_stored));
+    if (!file || std::memcmp(magic, MEMO_MAGIC, sizeof(magic)) != 0 || n_stored != n_values) { 
+        std::cout << "Discarding incompatible cache file " << file_name << std::endl;
+        file.close();
+        std::remove(file_name.c_str());
+        return;
+    }
+
+    // A record cut short by an interrupted run is ignored.
+    size_t record = n_values + 2;
+    std::vector<double> buffer(record);
+    while (file.read(reinterpret_cast<char*>(buffer.data()), record * sizeof(double))) { 
+        Key k = pointKey(buffer[0], buffer[1]);
+        if (points.count(k)) continue;
+        points[k] = data.size();
+        data.insert(data.end(), buffer.begin() + 2, buffer.end());
+    }
+}
+
+MemoCache::Key MemoCache::pointKey(double temperature, double pressure)
+{
+    return Key(std::llround(temperature * 1.0e6), std::llround(std::log10(pressure) * 1.0e10));
+}
+
+bool MemoCache::find(double temperature, double pressure, double* values) const
+{
+    auto it = points.find(pointKey(temperature, pressure));
+    if (it == points.end()) return false;
+    std::memcpy(values, &data[it->second], n_values * sizeof(double));
+    return true;
+}
+
+void MemoCache::append(const std::vector<double>& records)
+{
+    if (records.empty()) return;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Other processes (e.g. the shards of one table) may append to the same
+    // file: the header check and the write happen under an exclusive lock.
+    int fd = ::open(file_name.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) return;
+    if (flock(fd, LOCK_EX) == 0) { 
+        // A record (or header) cut short by an interrupted run is dropped 
+        // first: the records appended after it would be read out of 
+        // alignment.
+        struct stat info;
+        bool ok = (fstat(fd, &info) == 0);
+        off_t header = sizeof(MEMO_MAGIC) + sizeof(int32_t);
+        off_t record = (n_values + 2) * sizeof(double);
+        if (ok && info.st_size < header) { 
+            ok = (ftruncate(fd, 0) == 0);
+            info.st_size = 0;
+        } else if (ok && (info.st_size - header) % record != 0) { 
+            ok = (ftruncate(fd, info.st_size - (info.st_size - header) % record) == 0);
+        }
+        if (ok && info.st_size == 0) { 
+            int32_t n_stored = n_values;
+            ok = writeAll(fd, MEMO_MAGIC, sizeof(MEMO_MAGIC)) && 
+                 writeAll(fd, reinterpret_cast<const char*>(&n_stored), sizeof(n_stored));
+        }
+        if (ok) writeAll(fd, reinterpret_cast<const char*>(records.data()), records.size() * sizeof(double));
+        flock(fd, LOCK_UN);
+    }
+    ::close(fd);
+}
+
+} // namespace IcarusPyro
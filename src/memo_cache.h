@@ -0,0 +1,123 @@
+#ifndef ICARUSPYRO_MEMO_CACHE_H
+#define ICARUSPYRO_MEMO_CACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace IcarusPyro {
+
+/**
+ * 64-bit FNV-1a hash, used to fingerprint mixture files and generation 
+ * parameters.
+ */
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL);
+
+/**
+ * FNV-1a hash of the contents of a file. Throws std::runtime_error if the 
+ * file cannot be read.
+ */
+uint64_t hashFile(const std::string& path, uint64_t hash = 14695981039346656037ULL);
+
+/**
+ * Path of a Mutation++ mixture file: the name itself if it is a readable 
+ * file, otherwise $MPP_DATA_DIRECTORY/mixtures/<name>.xml. Throws 
+ * std::runtime_error if neither can be read.
+ */
+std::string mixtureFilePath(const std::string& mixture);
+
+/**
+ * The Mutation++ species databases, i.e. every file of the thermo and 
+ * transport directories of $MPP_DATA_DIRECTORY (NASA polynomials, RRHO 
+ * data, collision integrals), in name order. Empty if the directories do
+ * not exist.
+ */
+std::vector<std::string> speciesDatabaseFiles();
+
+/**
+ * Hash of everything Mutation++ reads to set up a mixture: the mixture file
+ * and the species databases.
+ */
+uint64_t hashMixtureData(const std::string& mixture);
+
+/**
+ * Persistent, content-addressed cache of equilibrium results on disk.
+ * 
+ * The cache file lives in `directory` and is named by a hash of everything
+ * that determines an equilibrium state other than (T, p): the mixture file
+ * contents, the elemental composition and the transport algorithms (see 
+ * makeKey). Each record holds T, p and a fixed number of values. Records are
+ * matched on (T, log10 p) rounded to well below the grid spacing of any 
+ * practical table, so regenerated grids that share points with a previous 
+ * run reuse them.
+ */
+class MemoCache { 
+public:
+    /**
+     * Open (or start) the cache file for `key` and load its records. A file 
+     * written with a different number of values per record is discarded.
+     * 
+     * @param[in] directory Cache directory. Created if it does not exist.
+     * @param[in] key Cache key, see makeKey.
+     * @param[in] n_values Number of values stored per (T, p) point.
+     */
+    MemoCache(const std::string& directory, const std::string& key, int n_values);
+
+    /**
+     * Cache key of an equilibrium calculation: a hex digest of the mixture 
+     * data (see hashMixtureData), the elemental composition and the 
+     * transport algorithms. Editing the species databases changes the key.
+     */
+    static std::string makeKey(const std::string& mixture, 
+                               const std::vector<double>& Xe, 
+                               const std::string& mu_algorithm, 
+                               const std::string& k_algorithm);
+
+    /**
+     * Look up the values of the point (T, p). Safe to call concurrently with
+     * other find() calls, but not with append().
+     * 
+     * @return True if the point is cached, in which case `values` is set.
+     */
+    bool find(double temperature, double pressure, double* values) const;
+
+    /**
+     * Append new records, stored as consecutive (T, p, values...) groups, to
+     * the cache file. Thread safe, and safe across processes sharing the 
+     * cache (e.g. the shards of a sharded run): the file is locked for the 
+     * write, and a partial record left by an interrupted run is truncated
+     * before it. The new records are not visible to find() until the cache 
+     * is reopened.
+     */
+    void append(const std::vector<double>& records);
+
+    size_t size() const { return points.size(); }
+
+    int valuesPerPoint() const { return n_values; }
+
+    std::string path() const { return file_name; }
+
+private:
+    typedef std::pair<int64_t, int64_t> Key;
+
+    struct KeyHash { 
+        size_t operator()(const Key& key) const { 
+            return std::hash<int64_t>()(key.first * 1000003 ^ key.second);
+        }
+    };
+
+    static Key pointKey(double temperature, double pressure);
+
+    std::string file_name;
+    int n_values;
+    std::vector<double> data;
+    std::unordered_map<Key, size_t, KeyHash> points;
+    std::mutex mutex;
+};
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef ICARUSPYRO_PARALLEL_H
+#define ICARUSPYRO_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace IcarusPyro {
+
+/**
+ * Number of threads to use for table generation. A non-positive request
+ * selects the number of hardware threads.
+ */
+inline int numThreads(int requested) { 
+    if (requested > 0) return requested;
+    int n = static_cast<int>(std::thread::hardware_concurrency());
+    return (n > 0) ? n : 1;
+}
+
+/**
+ * Run body(thread, i) for i = 0, ..., n-1 on `nthreads` threads. Iterations
+ * are handed out one at a time so that rows of differing cost balance across
+ * the threads. The thread index lets each thread use its own Mutation++ 
+ * objects, which are not thread safe. The first exception thrown by any 
+ * thread stops the loop and is rethrown to the caller.
+ */
+template<class Body>
+void parallelFor(int n, int nthreads, Body body) { 
+    std::atomic<int> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&](int thread) { 
+        try { 
+            for (int i = next++; i < n; i = next++) body(thread, i);
+        } catch (...) { 
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            next = n;
+        }
+    };
+    if (nthreads <= 1 || n <= 1) { 
+        worker(0);
+    } else { 
+        std::vector<std::thread> threads;
+        for (int t = 1; t < nthreads; t++) threads.push_back(std::thread(worker, t));
+        worker(0);
+        for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+/**
+ * Run body(thread, k) for every task k = 0, ..., cost.size()-1 on `nthreads`
+ * threads with cost-aware work stealing. The tasks are dealt round robin, 
+ * most expensive first, onto one queue per thread. Each thread runs its own
+ * queue from the most expensive task and, once it is empty, steals the 
+ * cheapest task of the queue with the most remaining cost, so that no thread
+ * idles while work remains and the expensive tasks are not left to the end.
+ * The costs are estimates in any consistent unit. Exceptions are handled as
+ * by parallelFor.
+ */
+template<class Body>
+void parallelTasks(const std::vector<double>& cost, int nthreads, Body body) { 
+    struct Queue { 
+        std::mutex mutex;
+        std::deque<int> tasks;
+        double remaining = 0.0;
+    };
+    int n = static_cast<int>(cost.size());
+    nthreads = std::max(1, std::min(nthreads, n));
+    std::vector<int> order(n);
+    for (int k = 0; k < n; k++) order[k] = k;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return cost[a] > cost[b]; });
+    std::vector<Queue> queues(nthreads);
+    for (int k = 0; k < n; k++) { 
+        Queue& q = queues[k % nthreads];
+        q.tasks.push_back(order[k]);
+        q.remaining += cost[order[k]];
+    }
+
+    std::atomic<bool> stop(false);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto take = [&](int thread, int& task) { 
+        {
+            Queue& own = queues[thread];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) { 
+                task = own.tasks.front();
+                own.tasks.pop_front();
+                own.remaining -= cost[task];
+                return true;
+            }
+        }
+        while (true) { 
+            int victim = -1;
+            double most = -1.0;
+            for (int t = 0; t < nthreads; t++) { 
+                std::lock_guard<std::mutex> lock(queues[t].mutex);
+                if (!queues[t].tasks.empty() && queues[t].remaining > most) { 
+                    victim = t;
+                    most = queues[t].remaining;
+                }
+            }
+            if (victim < 0) return false;
+            Queue& q = queues[victim];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            task = q.tasks.back();
+            q.tasks.pop_back();
+            q.remaining -= cost[task];
+            return true;
+        }
+    };
+    auto worker = [&](int thread) { 
+        try { 
+            int task;
+            while (!stop && take(thread, task)) body(thread, task);
+        } catch (...) { 
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            stop = true;
+        }
+    };
+    if (nthreads <= 1) { 
+        worker(0);
+    } else { 
+        std::vector<std::thread> threads;
+        for (int t = 1; t < nthreads; t++) threads.push_back(std::thread(worker, t));
+        worker(0);
+        for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,170 @@
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pyro.h"
+
+namespace IcarusPyro { 
+
+Pyro::Pyro(const std::string& material,
+           const std::string& pyrolysis_gas_mixture, 
+           const std::string& surface_gas_mixture,
+           const std::string& database)
+    : solid(material),
+      gas(pyrolysis_gas_mixture, database),
+      surface_gas(surface_gas_mixture)
+{
+    // A database without B' data for the surface mixture is not an error, 
+    // but one whose B' data cannot be read is.
+    try { 
+        bprime.reset(new BprimeTable(surface_gas, database));
+    } catch (const std::runtime_error&) { 
+        bprime.reset();
+    } catch (const H5::Exception& error) { 
+        throw std::runtime_error("Could not read the B' table of " + surface_gas + " from " + 
+                                 database + ": " + error.getDetailMsg());
+    }
+    shared_axes = gas.enthalpy->sameAxes(*gas.density) && gas.enthalpy->sameAxes(*gas.viscosity);
+}
+
+void Pyro::evaluate(const std::vector<double>& temperature, 
+                    const std::vector<double>& pressure,
+                    const std::vector<double>& solid_density,
+                    PyroState& state) const
+{
+    size_t n = temperature.size();
+    state.resize(n);
+
+    for (size_t k = 0; k < n; k++) { 
+        double T = temperature[k];
+        double p = pressure[k];
+        double rho_s = solid_density[k];
+
+        TableIndex idx = gas.locate(T, p);
+        double h_g, rho_g, mu_g;
+        if (gas.fallback && !gas.inRange(T, p)) { 
+            GasProperties props;
+            gas.evaluateFallback(T, p, props);
+            h_g = props.enthalpy;
+            rho_g = props.density;
+            mu_g = props.viscosity;
+        } else if (shared_axes) { 
+            h_g = gas.enthalpy->interpolate(idx);
+            rho_g = gas.density->interpolate(idx);
+            mu_g = gas.viscosity->interpolate(idx);
+        } else { 
+            h_g = gas.enthalpy->interpolate(idx);
+            rho_g = gas.density->interpolate(T, p);
+            mu_g = gas.viscosity->interpolate(T, p);
+        }
+
+        double h_s = solid.solid_enthalpy(T, solid.virgin_mass_fraction(rho_s));
+        double phi = solid.porosity(solid.decomposition_fraction(rho_s));
+        double rho_mix = rho_s + phi * rho_g;
+
+        state.solid_enthalpy[k] = h_s;
+        state.gas_enthalpy[k] = h_g;
+        state.gas_density[k] = rho_g;
+        state.gas_viscosity[k] = mu_g;
+        state.porosity[k] = phi;
+        state.mixture_density[k] = rho_mix;
+        state.mixture_enthalpy[k] = (rho_s * h_s + phi * rho_g * h_g) / rho_mix;
+        state.decomposition_rate[k] = solid.decomposition_rate(T, rho_s);
+    }
+}
+
+int Pyro::computeTemperature(const std::vector<double>& total_energy, 
+                             const std::vector<double>& solid_density,
+                             const std::vector<double>& pressure,
+                             const std::vector<double>& porosity,
+                             std::vector<double>& temperature,
+                             double tolerance,
+                             int max_iterations) const
+{
+    size_t n = total_energy.size();
+    const TableEntry<double>& h = *gas.enthalpy;
+    const TableEntry<double>& rho = *gas.density;
+    double T_low = h.x[0];
+    double T_high = h.x[h.nx-1];
+
+    if (temperature.size() != n) { 
+        temperature.assign(n, 0.5 * (T_low + T_high));
+    }
+
+    // Residual of the energy balance and its derivative at T.
+    auto residual = [&](size_t k, double T, double Yv_k, double& df) { 
+        TableIndex idx = gas.locate(T, pressure[k]);
+        double h_g = h.interpolate(idx);
+        double rho_g = shared_axes ? rho.interpolate(idx) : rho.interpolate(T, pressure[k]);
+        double dh_g = h.derivativeX(idx);
+        double drho_g = shared_axes ? rho.derivativeX(idx) : rho.derivativeX(rho.locate(T, pressure[k]));
+        df = solid_density[k] * solid.solid_cp(T, Yv_k) + porosity[k] * (drho_g * h_g + rho_g * dh_g);
+        return solid_density[k] * solid.solid_enthalpy(T, Yv_k) 
+             + porosity[k] * (rho_g * h_g - pressure[k]) - total_energy[k];
+    };
+
+    // Per-cell bracket, residuals at the bracket ends and the list of cells
+    // still iterating. Cells whose energy lies outside the range of the 
+    // tables have no root in the bracket: they are left at the nearest edge
+    // and counted as not converged.
+    std::vector<double> lower(n, T_low);
+    std::vector<double> upper(n, T_high);
+    std::vector<double> f_lower(n);
+    std::vector<double> f_upper(n);
+    std::vector<double> Yv(n);
+    std::vector<size_t> active(n);
+    size_t n_active = 0;
+    int n_outside = 0;
+    double df;
+    for (size_t k = 0; k < n; k++) { 
+        Yv[k] = solid.virgin_mass_fraction(solid_density[k]);
+        f_lower[k] = residual(k, T_low, Yv[k], df);
+        f_upper[k] = residual(k, T_high, Yv[k], df);
+        if (f_lower[k] > 0.0 || f_upper[k] < 0.0) { 
+            temperature[k] = f_lower[k] > 0.0 ? T_low : T_high;
+            n_outside++;
+            continue;
+        }
+        active[n_active++] = k;
+        temperature[k] = std::min(std::max(temperature[k], T_low), T_high);
+    }
+
+    for (int iter = 0; iter < max_iterations && n_active > 0; iter++) { 
+        size_t m = 0;
+        for (size_t a = 0; a < n_active; a++) { 
+            size_t k = active[a];
+            double T = temperature[k];
+            double f = residual(k, T, Yv[k], df);
+
+            if (std::abs(f) <= tolerance * T * std::abs(df)) continue;
+
+            if (f > 0.0) { 
+                upper[k] = T;
+                f_upper[k] = f;
+            } else { 
+                lower[k] = T;
+                f_lower[k] = f;
+            }
+
+            // Newton step, falling back to false position across the kinks
+            // of the piecewise-linear tables and to bisection otherwise.
+            double T_new = T - f / df;
+            if (!(df > 0.0) || !(T_new > lower[k] && T_new < upper[k])) { 
+                T_new = lower[k] - f_lower[k] * (upper[k] - lower[k]) / (f_upper[k] - f_lower[k]);
+                if (!(T_new >= lower[k] && T_new <= upper[k])) { 
+                    T_new = 0.5 * (lower[k] + upper[k]);
+                }
+            }
+            temperature[k] = T_new;
+
+            bool converged = std::abs(T_new - T) <= tolerance * T 
+                          || upper[k] - lower[k] <= tolerance * T;
+            if (!converged) active[m++] = k;
+        }
+        n_active = m;
+    }
+    return static_cast<int>(n_active) + n_outside;
+}
+
+} // namespace IcarusPyro
@@ -1,13 +1,137 @@
 #ifndef ICARUS_PYRO_H
 #define ICARUS_PYRO_H
 
-class Icarus { 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bprime_table.h"
+#include "gas_table.h"
+#include "material.h"
+
+namespace IcarusPyro {
+
+/**
+ * Per-cell state returned by Pyro::evaluate, stored as a structure of arrays.
+ */
+struct PyroState { 
+    void resize(size_t n) { 
+        solid_enthalpy.resize(n);
+        gas_enthalpy.resize(n);
+        gas_density.resize(n);
+        gas_viscosity.resize(n);
+        porosity.resize(n);
+        mixture_density.resize(n);
+        mixture_enthalpy.resize(n);
+        decomposition_rate.resize(n);
+    }
+
+    std::vector<double> solid_enthalpy;     // J/kg
+    std::vector<double> gas_enthalpy;       // J/kg
+    std::vector<double> gas_density;        // kg/m^3 of pore volume
+    std::vector<double> gas_viscosity;      // Pa s
+    std::vector<double> porosity;           
+    std::vector<double> mixture_density;    // rho_s + phi rho_g, kg/m^3
+    std::vector<double> mixture_enthalpy;   // (rho_s h_s + phi rho_g h_g) / mixture_density
+    std::vector<double> decomposition_rate; // d(rho_s)/dt, kg/m^3/s
+};
+
+/**
+ * Facade combining the solid material model and the tabulated pyrolysis gas
+ * properties of a charring ablator.
+ */
+class Pyro { 
  public:
 
-    IcarusPyro(const char* material,
-               const char* pyrolysis_gas_mixture, 
-               const char* surface_gas_mixture);
+    /** 
+     * @param[in] material Material database file, e.g., tacot.yaml.
+     * @param[in] pyrolysis_gas_mixture Name of the pyrolysis gas mixture in the gas table database.
+     * @param[in] surface_gas_mixture Name of the gas-surface interaction mixture.
+     *     Its B' table is loaded when the database contains one.
+     * @param[in] database Name (and/or full path) of the gas table database.
+     */
+    Pyro(const std::string& material,
+         const std::string& pyrolysis_gas_mixture, 
+         const std::string& surface_gas_mixture,
+         const std::string& database = "gas_table.h5");
+
+    Material& get_material() { 
+        return solid;
+    }
 
+    GasTable& get_gas_table() { 
+        return gas;
+    }
+
+    std::string get_surface_gas_mixture() const { 
+        return surface_gas;
+    }
+
+    /**
+     * The B' table of the surface gas mixture, owned by the Pyro object, or 
+     * nullptr if the database does not contain one.
+     */
+    const BprimeTable* get_bprime_table() const { 
+        return bprime.get();
+    }
+
+    /**
+     * Evaluate the solid and pyrolysis gas properties for a batch of cells in
+     * a single pass. The table cell of each (T, p) point is located once and 
+     * shared by every gas property. Points outside of the gas table range use
+     * the table fallback, if one is set (see GasTable::setFallback).
+     * 
+     * @param[in] temperature Temperature of each cell.
+     * @param[in] pressure Pressure of each cell.
+     * @param[in] solid_density Bulk density of the solid in each cell.
+     * @param[out] state Properties of each cell. Resized to the number of cells.
+     */
+    void evaluate(const std::vector<double>& temperature, 
+                  const std::vector<double>& pressure,
+                  const std::vector<double>& solid_density,
+                  PyroState& state) const;
+
+    /**
+     * Recover the temperature of a batch of cells from the total volumetric 
+     * energy of the solid and the pyrolysis gas,
+     * 
+     *     E = rho_s h_s(T) + phi (rho_g(T, p) h_g(T, p) - p),
+     * 
+     * using a safeguarded Newton iteration with analytic derivatives. All 
+     * cells iterate together; converged cells are masked out of the 
+     * remaining iterations. The search is bracketed by the temperature range
+     * of the gas table, which is always used (clamped) here, even when a 
+     * fallback is set. Cells whose energy lies outside that range are left 
+     * at the nearest edge of the table and counted as not converged.
+     * 
+     * @param[in] total_energy Total volumetric energy of each cell, J/m^3.
+     * @param[in] solid_density Bulk density of the solid in each cell.
+     * @param[in] pressure Pressure of each cell.
+     * @param[in] porosity Porosity of each cell.
+     * @param[in,out] temperature Initial guess (e.g., the previous time step) 
+     *     and, on return, the temperature of each cell. If the size does not 
+     *     match the number of cells, the search starts from the middle of the
+     *     table range.
+     * @param[in] tolerance Relative temperature change for convergence.
+     * @param[in] max_iterations Maximum number of Newton iterations.
+     * @return The number of cells that did not converge.
+     */
+    int computeTemperature(const std::vector<double>& total_energy, 
+                           const std::vector<double>& solid_density,
+                           const std::vector<double>& pressure,
+                           const std::vector<double>& porosity,
+                           std::vector<double>& temperature,
+                           double tolerance = 1.0e-10,
+                           int max_iterations = 30) const;
+
+ private:
+    Material solid;
+    GasTable gas;
+    std::string surface_gas;
+    std::unique_ptr<BprimeTable> bprime;
+    bool shared_axes;
 };
 
-#endif
\ No newline at end of file
+} // namespace IcarusPyro
+
+#endif
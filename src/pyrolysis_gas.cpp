@@ -1,9 +1,20 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <iostream>
 #include <iomanip>
 
 #include "pyrolysis_gas.h"
+#include "grid.h"
+#include "parallel.h"
+#include "table_merge.h"
 
 namespace IcarusPyro { 
 
@@ -17,80 +28,509 @@ GasMixture::GasMixture(std::string& pyrolysis_gas_mixture,
                        int nP,
                        std::string p_scale,
                        std::string mu_algorithm, 
-                       std::string k_algorithm) 
+                       std::string k_algorithm,
+                       int n_threads,
+                       double species_threshold,
+                       std::string cache_directory,
+                       int first_row,
+                       int last_row,
+                       std::string checkpoint_file,
+                       bool resume,
+                       bool compute) 
     : pyrolysis_gas(pyrolysis_gas_mixture), 
       viscosity_algorithm(mu_algorithm), 
       conductivity_algorithm(k_algorithm),
       temperature_scale(T_scale),
       pressure_scale(p_scale),
+      threads(n_threads),
+      species_cutoff(species_threshold),
+      cache_dir(cache_directory),
+      row_offset(0),
+      total_rows(0),
+      checkpoint_name(checkpoint_file),
+      resume_run(resume),
+      n_species(0),
       thermo(nullptr),
       transport(nullptr),
       gasTable(pyrolysis_gas_mixture)
 {
-    Mutation::MixtureOptions* opts = new Mutation::MixtureOptions(pyrolysis_gas_mixture);
-    thermo = new Mutation::Thermodynamics::Thermodynamics(opts->getSpeciesDescriptor(), 
-                                                          opts->getThermodynamicDatabase(),
-                                                          opts->getStateModel());
-    transport = new Mutation::Transport::Transport(*thermo, 
-                                                   viscosity_algorithm, 
-                                                   conductivity_algorithm);
-    delete opts;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    createMutation(pyrolysis_gas, viscosity_algorithm, conductivity_algorithm, thermo, transport);
+    timing.addPhase("setup", secondsSince(start));
 
     setTemperature(T_low, T_high, nT, T_scale);
     setPressure(p_low, p_high, nP, p_scale);
-    computeProperties();
-}
 
-void GasMixture::computeProperties() { 
-    int T_size = temperature.size();
-    int p_size = pressure.size();
+    // The rows of a shard are taken from the full pressure range, so merged
+    // shards reproduce a single run exactly.
+    total_rows = pressure.size();
+    origin = TableProvenance::make(pyrolysis_gas, pyrolysisElementFractions(*thermo), 
+                                   viscosity_algorithm, conductivity_algorithm);
+    origin.T_low = T_low;
+    origin.T_high = T_high;
+    origin.nT = nT;
+    origin.T_scale = T_scale;
+    origin.p_low = p_low;
+    origin.p_high = p_high;
+    origin.nP = nP;
+    origin.p_scale = p_scale;
+    origin.species_threshold = species_threshold;
+    if (last_row < 0) last_row = total_rows - 1;
+    if (first_row < 0 || first_row > last_row || last_row >= total_rows) { 
+        throw std::runtime_error("Invalid pressure row range.");
+    }
+    row_offset = first_row;
+    pressure = std::vector<double>(pressure.begin() + first_row, pressure.begin() + last_row + 1);
 
-    internal_energy.resize(p_size);
-    enthalpy.resize(p_size);
-    cv.resize(p_size);
-    cp.resize(p_size);
-    molecular_weight.resize(p_size);
-    density.resize(p_size);
-    viscosity.resize(p_size);
+    if (compute) computeProperties();
+}
 
-    int nE = thermo->nElements();
+void createMutation(const std::string& mixture, 
+                    const std::string& mu_algorithm, 
+                    const std::string& k_algorithm,
+                    Mutation::Thermodynamics::Thermodynamics*& thermo, 
+                    Mutation::Transport::Transport*& transport)
+{
+    Mutation::MixtureOptions* opts = new Mutation::MixtureOptions(mixture);
+    thermo = new Mutation::Thermodynamics::Thermodynamics(opts->getSpeciesDescriptor(), 
+                                                          opts->getThermodynamicDatabase(),
+                                                          opts->getStateModel());
+    transport = new Mutation::Transport::Transport(*thermo, mu_algorithm, k_algorithm);
+    delete opts;
+}
+
+std::vector<double> pyrolysisElementFractions(const Mutation::Thermodynamics::Thermodynamics& thermo)
+{
+    int nE = thermo.nElements();
     std::string N("N");
     std::string O("O");
     std::string C("C");
     std::string H("H");
-    //std::vector<double> Xe(nE,0.0);
-    double* Xe = new double[nE];
-    Xe[thermo->elementIndex(N)] = 0.0;
-    Xe[thermo->elementIndex(C)] = 0.206;
-    Xe[thermo->elementIndex(H)] = 0.679;
-    Xe[thermo->elementIndex(O)] = 0.115;
+    std::vector<double> Xe(nE, 0.0);
+    Xe[thermo.elementIndex(N)] = 0.0;
+    Xe[thermo.elementIndex(C)] = 0.206;
+    Xe[thermo.elementIndex(H)] = 0.679;
+    Xe[thermo.elementIndex(O)] = 0.115;
+    return Xe;
+}
+
+void equilibriumProperties(Mutation::Thermodynamics::Thermodynamics& thermo,
+                           Mutation::Transport::Transport& transport, 
+                           double T, 
+                           double p, 
+                           const double* Xe,
+                           GasProperties& props,
+                           double* seconds)
+{
+    std::chrono::steady_clock::time_point start;
+    if (seconds) start = std::chrono::steady_clock::now();
+
+    thermo.equilibrate(T, p, Xe);
+
+    props.eint = thermo.mixtureEnergyMass();
+    props.enthalpy = thermo.mixtureHMass();
+    props.cv = thermo.mixtureFrozenCvMass();
+    props.cp = thermo.mixtureFrozenCpMass();
+    props.mw = thermo.mixtureMw() * 1000.0; // convert from kg/mol to kg/kmol
+    props.density = thermo.density();
+
+    if (seconds) { 
+        seconds[0] = secondsSince(start);
+        start = std::chrono::steady_clock::now();
+    }
+
+    transportProperties(transport, props);
 
-    for (int j = 0; j < p_size; j++) {
-        double p = pressure[j];
+    if (seconds) seconds[1] = secondsSince(start);
+}
+
+void transportProperties(Mutation::Transport::Transport& transport, GasProperties& props)
+{
+    props.viscosity = transport.viscosity();
+    props.conductivity = transport.equilibriumThermalConductivity();
+    props.reactive_conductivity = transport.reactiveThermalConductivity();
+}
 
-        internal_energy[j].resize(T_size);
-        enthalpy[j].resize(T_size);
-        cv[j].resize(T_size);
-        cp[j].resize(T_size);
-        molecular_weight[j].resize(T_size);
-        density[j].resize(T_size);
-        viscosity[j].resize(T_size);
+namespace { 
 
-        for (int i = 0; i < T_size; i++) { 
-            thermo->equilibrate(temperature[i], p, Xe);
+// Number and order of the GasProperties fields in a cache record, and of the
+// property tables in a row (see GasMixture::rowTables): those of GasTable.
+const int N_PROPERTIES = GasTable::N_PROPERTIES;
 
-            internal_energy[j][i] = thermo->mixtureEnergyMass();
-            enthalpy[j][i] = thermo->mixtureHMass();
-            cv[j][i] = thermo->mixtureFrozenCvMass();
-            cp[j][i] = thermo->mixtureFrozenCpMass();
-            molecular_weight[j][i] = thermo->mixtureMw() * 1000.0; // convert from kg/mol to kg/kmol
-            density[j][i] = thermo->density();
-            viscosity[j][i] = transport->viscosity();
+void packProperties(const GasProperties& props, double* values)
+{
+    for (int k = 0; k < N_PROPERTIES; k++) values[k] = props.*GasTable::properties[k];
+}
+
+void unpackProperties(const double* values, GasProperties& props)
+{
+    for (int k = 0; k < N_PROPERTIES; k++) props.*GasTable::properties[k] = values[k];
+}
+
+} // namespace
+
+void GasMixture::computeProperties() {
+    allocateTables();
+    generateRows([&](int j, const double* row) {
+        storeRow(j, row);
+    });
+}
+
+void GasMixture::computeAll(const std::vector<GasMixture*>& mixtures, int n_threads, int block_size)
+{
+    struct Task {
+        int m, j, i_begin, i_end;
+    };
+    int n_mixtures = mixtures.size();
+    int nthreads = numThreads(n_threads);
+    block_size = std::max(block_size, 1);
+
+    // Tasks are blocks of temperature points of a pressure row; the rows of
+    // a checkpoint are restored by a single task. The cost of a block is its
+    // number of points not found in the equilibrium cache times their 
+    // expected time from the profile of the mixture, if any.
+    std::vector<GenerationProfile> profiles(n_mixtures);
+    double profiled_seconds = 0.0;
+    int n_profiled = 0;
+    for (int m = 0; m < n_mixtures; m++) {
+        GasMixture& gas = *mixtures[m];
+        profiles[m] = gas.cost_profile.computedPoints() ? gas.cost_profile : gas.timing;
+        double seconds = profiles[m].meanPointCost(gas.temperature.front(), gas.temperature.back());
+        if (seconds > 0.0) {
+            profiled_seconds += seconds;
+            n_profiled++;
+        }
+    }
+    double default_seconds = n_profiled ? profiled_seconds / n_profiled : 1.0;
+
+    std::vector<Task> tasks;
+    std::vector<double> cost;
+    std::vector< std::vector<double> > Xe(n_mixtures);
+    std::vector< std::vector< std::vector<double> > > rows(n_mixtures);
+    std::vector< std::unique_ptr<std::atomic<int>[]> > pending(n_mixtures);
+    for (int m = 0; m < n_mixtures; m++) {
+        GasMixture& gas = *mixtures[m];
+        gas.allocateTables();
+        Xe[m] = pyrolysisElementFractions(*gas.thermo);
+        gas.openRowStores(Xe[m]);
+        gas.timing.reset(gas.temperature, gas.pressure, nthreads);
+
+        int T_size = gas.temperature.size();
+        int p_size = gas.pressure.size();
+        size_t row_size = (N_PROPERTIES + gas.n_species) * T_size;
+        rows[m].resize(p_size);
+        pending[m].reset(new std::atomic<int>[p_size]);
+        std::vector<double> values(gas.memo ? gas.memo->valuesPerPoint() : 0);
+        for (int j = 0; j < p_size; j++) {
+            if (gas.checkpoint && gas.checkpoint->completed(j)) {
+                tasks.push_back({m, j, 0, 0});
+                cost.push_back(0.0);
+                pending[m][j] = 1;
+                continue;
+            }
+            rows[m][j].resize(row_size);
+            pending[m][j] = 0;
+            for (int i = 0; i < T_size; i += block_size) {
+                Task task = {m, j, i, std::min(i + block_size, T_size)};
+                int uncached = 0;
+                for (int k = task.i_begin; k < task.i_end; k++) {
+                    if (!gas.memo || !gas.memo->find(gas.temperature[k], gas.pressure[j], values.data())) uncached++;
+                }
+                double seconds = profiles[m].meanPointCost(gas.temperature[task.i_begin],
+                                                           gas.temperature[task.i_end - 1]);
+                tasks.push_back(task);
+                cost.push_back(uncached * (seconds > 0.0 ? seconds : default_seconds));
+                pending[m][j]++;
+            }
+        }
+    }
+
+    // Thread 0 uses the Mutation++ objects of each mixture; the other threads
+    // create their own the first time they work on a mixture. Mutation++
+    // objects are created one at a time.
+    std::mutex setup;
+    std::vector< std::vector< std::unique_ptr<Mutation::Thermodynamics::Thermodynamics> > > thermos(n_mixtures);
+    std::vector< std::vector< std::unique_ptr<Mutation::Transport::Transport> > > transports(n_mixtures);
+    for (int m = 0; m < n_mixtures; m++) {
+        thermos[m].resize(nthreads);
+        transports[m].resize(nthreads);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    parallelTasks(cost, nthreads, [&](int t, int n) {
+        const Task& task = tasks[n];
+        GasMixture& gas = *mixtures[task.m];
+        if (gas.checkpoint && gas.checkpoint->completed(task.j)) {
+            gas.storeRow(task.j, gas.checkpoint->row(task.j));
+            return;
         }
+
+        Mutation::Thermodynamics::Thermodynamics* th = gas.thermo;
+        Mutation::Transport::Transport* tr = gas.transport;
+        if (t > 0) {
+            std::lock_guard<std::mutex> lock(setup);
+            if (!thermos[task.m][t]) {
+                createMutation(gas.pyrolysis_gas, gas.viscosity_algorithm, gas.conductivity_algorithm, th, tr);
+                thermos[task.m][t].reset(th);
+                transports[task.m][t].reset(tr);
+            }
+            th = thermos[task.m][t].get();
+            tr = transports[task.m][t].get();
+        }
+
+        std::vector<double>& row = rows[task.m][task.j];
+        gas.computeRow(task.j, *th, *tr, Xe[task.m].data(), row.data(), task.i_begin, task.i_end);
+
+        // The thread finishing the last block of a row completes it.
+        if (--pending[task.m][task.j] == 0) {
+            if (gas.checkpoint) gas.checkpoint->save(task.j, row.data());
+            gas.storeRow(task.j, row.data());
+            std::vector<double>().swap(row);
+        }
+    });
+    double seconds = secondsSince(start);
+    for (int m = 0; m < n_mixtures; m++) {
+        mixtures[m]->timing.addPhase("compute", seconds);
+    }
+}
+
+void GasMixture::allocateTables()
+{
+    int p_size = pressure.size();
+    n_species = (species_cutoff < 0.0) ? 0 : thermo->nSpecies();
+
+    std::vector< std::vector< std::vector<double> >* > tables = rowTables();
+    for (size_t k = 0; k < tables.size(); k++) {
+        tables[k]->assign(p_size, std::vector<double>());
+    }
+}
+
+void GasMixture::storeRow(int j, const double* row)
+{
+    std::vector< std::vector< std::vector<double> >* > tables = rowTables();
+    size_t T_size = temperature.size();
+    for (size_t k = 0; k < tables.size(); k++) {
+        (*tables[k])[j].assign(row + k * T_size, row + (k + 1) * T_size);
     }
 }
 
+void GasMixture::stream(std::string gas_table, std::string gas_mixture_name)
+{
+    HDF5Names H5Names;
+    std::string gas_name = gas_mixture_name.empty() ? pyrolysis_gas : gas_mixture_name;
+    n_species = (species_cutoff < 0.0) ? 0 : thermo->nSpecies();
+    std::cout << "Streaming database file : " << gas_table 
+              << " for gas mixture : " << gas_name << std::endl;
+
+    std::unique_ptr<H5File> file(openDatabase(gas_table));
+    if (!file) { 
+        throw std::runtime_error("Could not open database " + gas_table + ".");
+    }
+    std::unique_ptr<Group> root(new Group(file->openGroup("/")));
+    std::unique_ptr<Group> gas(replaceGroup(root.get(), gas_name));
+
+    // Which species exceed the threshold is only known once the whole table 
+    // is computed, so they are streamed to a scratch file and only those 
+    // kept are copied to the database: space taken by a dataset that is 
+    // later unlinked is never reclaimed by HDF5.
+    std::string scratch_name = gas_table + ".species.tmp";
+    std::unique_ptr<H5File> scratch;
+    std::unique_ptr<Group> species_group;
+
+    std::vector<std::unique_ptr<TableStream>> streams;
+    for (int k = 0; k < N_PROPERTIES; k++) { 
+        streams.emplace_back(new TableStream(gas.get(), GasTable::propertyName(k), "temperature", "pressure", 
+                                             temperature_scale, pressure_scale, temperature));
+    }
+    if (n_species > 0) { 
+        scratch.reset(new H5File(scratch_name, H5F_ACC_TRUNC));
+        species_group.reset(new Group(scratch->openGroup("/")));
+        for (int s = 0; s < n_species; s++) { 
+            streams.emplace_back(new TableStream(species_group.get(), thermo->speciesName(s), 
+                                                 "temperature", "pressure", 
+                                                 temperature_scale, pressure_scale, temperature));
+        }
+    }
+
+    // Serial HDF5 is not thread safe: rows are written one at a time as the 
+    // threads finish them.
+    std::mutex io;
+    std::vector<bool> present(n_species, false);
+    size_t T_size = temperature.size();
+    double io_seconds = 0.0;
+    generateRows([&](int j, const double* row) { 
+        std::lock_guard<std::mutex> lock(io);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t k = 0; k < streams.size(); k++) { 
+            streams[k]->writeRow(j, pressure[j], row + k * T_size);
+        }
+        io_seconds += secondsSince(start);
+        for (int s = 0; s < n_species; s++) { 
+            const double* Y = row + (N_PROPERTIES + s) * T_size;
+            for (size_t i = 0; i < T_size && !present[s]; i++) present[s] = (Y[i] > 0.0);
+        }
+    });
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    streams.clear();
+
+    // Only species that exceed the threshold somewhere in the table are kept,
+    // on their compact support, one at a time. Shards keep them all so that 
+    // they can be merged; mergeShards drops them.
+    bool shard = static_cast<int>(pressure.size()) != total_rows;
+    if (n_species > 0) { 
+        std::unique_ptr<Group> kept(new Group(gas->createGroup(H5Names.species)));
+        for (int s = 0; s < n_species; s++) { 
+            if (!present[s] && !shard) continue;
+            TableEntry<double>* var = readTableEntry(species_group.get(), thermo->speciesName(s));
+            if (!shard) { 
+                TableEntry<double>* compact = compactSupport(*var);
+                delete var;
+                var = compact;
+            }
+            writeTableEntry(kept.get(), thermo->speciesName(s), var);
+            delete var;
+        }
+        species_group.reset();
+        scratch.reset();
+        std::remove(scratch_name.c_str());
+    }
+    gas.reset();
+    root.reset();
+    file.reset();
+    timing.addPhase("write", io_seconds + secondsSince(start));
+    writeProvenance(gas_table, gas_name, origin);
+
+    if (checkpoint) checkpoint->remove();
+    writeShardInfo(gas_table, gas_name, row_offset, total_rows);
+}
+
+void GasMixture::generateRows(const std::function<void(int, const double*)>& sink)
+{
+    int p_size = pressure.size();
+    std::vector<double> Xe = pyrolysisElementFractions(*thermo);
+    size_t row_size = (N_PROPERTIES + n_species) * temperature.size();
+
+    openRowStores(Xe);
+
+    // The Mutation++ objects are not thread safe, so each additional thread 
+    // gets its own set. They are created here, serially, before the threads start.
+    int nthreads = std::min(numThreads(threads), p_size);
+    timing.reset(temperature, pressure, nthreads);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<Mutation::Thermodynamics::Thermodynamics>> thermos;
+    std::vector<std::unique_ptr<Mutation::Transport::Transport>> transports;
+    for (int t = 1; t < nthreads; t++) { 
+        Mutation::Thermodynamics::Thermodynamics* th(nullptr);
+        Mutation::Transport::Transport* tr(nullptr);
+        createMutation(pyrolysis_gas, viscosity_algorithm, conductivity_algorithm, th, tr);
+        thermos.emplace_back(th);
+        transports.emplace_back(tr);
+    }
+    timing.addPhase("setup", secondsSince(start));
+
+    start = std::chrono::steady_clock::now();
+    std::vector< std::vector<double> > rows(nthreads, std::vector<double>(row_size));
+    parallelFor(p_size, nthreads, [&](int t, int j) { 
+        if (checkpoint && checkpoint->completed(j)) { 
+            sink(j, checkpoint->row(j));
+            return;
+        }
+        if (t == 0) { 
+            computeRow(j, *thermo, *transport, Xe.data(), rows[t].data());
+        } else { 
+            computeRow(j, *thermos[t-1], *transports[t-1], Xe.data(), rows[t].data());
+        }
+        if (checkpoint) checkpoint->save(j, rows[t].data());
+        sink(j, rows[t].data());
+    });
+    timing.addPhase("compute", secondsSince(start));
+}
+
+void GasMixture::openRowStores(const std::vector<double>& Xe)
+{
+    size_t row_size = (N_PROPERTIES + n_species) * temperature.size();
+
+    // Cached points hold the tabulated properties followed by the full
+    // (unthresholded) species mass fractions.
+    if (!cache_dir.empty()) { 
+        std::string key = MemoCache::makeKey(pyrolysis_gas, Xe, viscosity_algorithm, conductivity_algorithm);
+        memo.reset(new MemoCache(cache_dir, key, N_PROPERTIES + thermo->nSpecies()));
+        std::cout << "Using equilibrium cache " << memo->path() 
+                  << " (" << memo->size() << " points)" << std::endl;
+    }
+
+    if (!checkpoint_name.empty()) { 
+        std::string key = MemoCache::makeKey(pyrolysis_gas, Xe, viscosity_algorithm, conductivity_algorithm);
+        uint64_t fingerprint = fnv1a(key.data(), key.size());
+        fingerprint = fnv1a(temperature.data(), temperature.size() * sizeof(double), fingerprint);
+        fingerprint = fnv1a(pressure.data(), pressure.size() * sizeof(double), fingerprint);
+        fingerprint = fnv1a(&species_cutoff, sizeof(species_cutoff), fingerprint);
+        checkpoint.reset(new RowCheckpoint(checkpoint_name, fingerprint, row_size, resume_run));
+        std::cout << "Checkpointing to " << checkpoint->path() << " (" 
+                  << checkpoint->completedRows() << " of " << pressure.size() << " rows completed)" << std::endl;
+    }
+}
+
+std::vector< std::vector< std::vector<double> >* > GasMixture::rowTables()
+{
+    std::vector< std::vector< std::vector<double> >* > tables = { 
+        &cp, &cv, &internal_energy, &enthalpy, &molecular_weight, &density, 
+        &viscosity, &conductivity, &reactive_conductivity};
+    species.resize(n_species);
+    for (size_t s = 0; s < species.size(); s++) { 
+        tables.push_back(&species[s]);
+    }
+    return tables;
+}
+
+void GasMixture::computeRow(int j, 
+                            Mutation::Thermodynamics::Thermodynamics& thermo,
+                            Mutation::Transport::Transport& transport, 
+                            const double* Xe,
+                            double* row,
+                            int i_begin,
+                            int i_end)
+{
+    int T_size = temperature.size();
+    if (i_end < 0) i_end = T_size;
+    double p = pressure[j];
+
+    GasProperties props;
+    std::vector<double> values(std::max(N_PROPERTIES, memo ? memo->valuesPerPoint() : 0));
+    std::vector<double> records;
+    for (int i = i_begin; i < i_end; i++) { 
+        const double* Y;
+        if (memo && memo->find(temperature[i], p, values.data())) { 
+            unpackProperties(values.data(), props);
+            Y = values.data() + N_PROPERTIES;
+        } else { 
+            double seconds[2];
+            equilibriumProperties(thermo, transport, temperature[i], p, Xe, props, seconds);
+            timing.recordPoint(j, i, seconds[0], seconds[1]);
+            Y = thermo.Y();
+            if (memo) { 
+                records.push_back(temperature[i]);
+                records.push_back(p);
+                packProperties(props, values.data());
+                records.insert(records.end(), values.begin(), values.begin() + N_PROPERTIES);
+                records.insert(records.end(), Y, Y + thermo.nSpecies());
+            }
+        }
+
+        packProperties(props, values.data());
+        for (int k = 0; k < N_PROPERTIES; k++) { 
+            row[k * T_size + i] = values[k];
+        }
+        for (int s = 0; s < n_species; s++) { 
+            row[(N_PROPERTIES + s) * T_size + i] = (Y[s] > species_cutoff) ? Y[s] : 0.0;
+        }
+    }
+
+    if (memo) memo->append(records);
+}
+
 void GasMixture::write(std::string gas_table, std::string gas_mixture_name) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     gasTable.load("cp", 
                   "temperature", "pressure", 
                   temperature_scale, pressure_scale, 
@@ -119,44 +559,56 @@ void GasMixture::write(std::string gas_table, std::string gas_mixture_name) {
                    "temperature", "pressure", 
                    temperature_scale, pressure_scale,
                    temperature, pressure, viscosity);
+    gasTable.load("conductivity", 
+                   "temperature", "pressure", 
+                   temperature_scale, pressure_scale,
+                   temperature, pressure, conductivity);
+    gasTable.load("reactive_conductivity", 
+                   "temperature", "pressure", 
+                   temperature_scale, pressure_scale,
+                   temperature, pressure, reactive_conductivity);
+
+    // Only species that exceed the threshold somewhere in the table are kept.
+    // Shards keep them all so that they can be merged; mergeShards drops them.
+    bool shard = static_cast<int>(pressure.size()) != total_rows;
+    for (size_t s = 0; s < species.size(); s++) { 
+        bool present = shard;
+        for (size_t j = 0; j < species[s].size() && !present; j++) { 
+            for (size_t i = 0; i < species[s][j].size() && !present; i++) { 
+                present = (species[s][j][i] > 0.0);
+            }
+        }
+        if (present) { 
+            gasTable.loadSpecies(thermo->speciesName(s), 
+                                 "temperature", "pressure", 
+                                 temperature_scale, pressure_scale,
+                                 temperature, pressure, species[s]);
+        }
+    }
+    if (!shard) gasTable.compactSpecies();
 
+    timing.addPhase("load", secondsSince(start));
+
+    start = std::chrono::steady_clock::now();
     gasTable.write(gas_table, gas_mixture_name);
+    writeProvenance(gas_table, gas_mixture_name.empty() ? pyrolysis_gas : gas_mixture_name, origin);
+    timing.addPhase("write", secondsSince(start));
+    if (checkpoint) checkpoint->remove();
+
+    writeShardInfo(gas_table, gas_mixture_name.empty() ? pyrolysis_gas : gas_mixture_name, 
+                   row_offset, total_rows);
 }
 
 void GasMixture::setTemperature(double low, double high, int N, std::string& scale)
 {
-    temperature.resize(N);
     temperature_scale = scale;
-    if (scale == "log10") { 
-        log_range(low, high, temperature);
-    } else { 
-        linear_range(low, high, temperature);
-    }
+    makeRange(low, high, N, scale, temperature);
 }
 
 void GasMixture::setPressure(double low, double high, int N, std::string& scale)
 {
-    pressure.resize(N);
     pressure_scale = scale;
-    if (scale == "log10") { 
-        log_range(low, high, pressure);
-    } else { 
-        linear_range(low, high, pressure);
-    }
-}
-
-void GasMixture::linear_range(double &low, double &high, std::vector<double>& var) { 
-    int N = var.size();
-    double dv = (high - low) / static_cast<double>(N - 1);
-    for (int i = 0; i < N; i++)
-        var[i] = low + dv * i;
-}
-
-void GasMixture::log_range(double &low, double &high, std::vector<double>& var) { 
-    int N = var.size();
-    double dv = (std::log10(high) - std::log10(low)) / static_cast<double>(N - 1);
-    for (int i = 0; i < N; i++)
-        var[i] = std::pow(10.0, std::log10(low) + dv * i);
+    makeRange(low, high, N, scale, pressure);
 }
 
 // void GasMixture::print(double T, double p) 
@@ -1,6 +1,8 @@
 #ifndef ICARUSPYRO_GAS_H
 #define ICARUSPYRO_GAS_H
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -9,9 +11,55 @@
 #include "Transport.h"
 
 #include "gas_table.h"
+#include "memo_cache.h"
+#include "checkpoint.h"
+#include "generation_profile.h"
+#include "table_provenance.h"
 
 namespace IcarusPyro {
 
+/**
+ * Create the Mutation++ thermodynamics and transport objects of a mixture.
+ * The caller owns both objects. The transport references the 
+ * thermodynamics, so it must be deleted first: holders of std::unique_ptr 
+ * declare the transports after the thermodynamics.
+ */
+void createMutation(const std::string& mixture, 
+                    const std::string& mu_algorithm, 
+                    const std::string& k_algorithm,
+                    Mutation::Thermodynamics::Thermodynamics*& thermo, 
+                    Mutation::Transport::Transport*& transport);
+
+/**
+ * Elemental mole fractions of the pyrolysis gas (TACOT: C 0.206, H 0.679, 
+ * O 0.115) ordered as the elements of `thermo`.
+ */
+std::vector<double> pyrolysisElementFractions(const Mutation::Thermodynamics::Thermodynamics& thermo);
+
+/**
+ * Equilibrate the mixture at (T, p) with elemental mole fractions Xe and 
+ * return its properties. This is the single definition of the tabulated 
+ * properties, shared by table generation and direct evaluation.
+ * 
+ * @param[out] seconds If not null, receives the time spent in the 
+ *     equilibrium solve and thermodynamic properties (seconds[0]) and in the
+ *     transport properties (seconds[1]).
+ */
+void equilibriumProperties(Mutation::Thermodynamics::Thermodynamics& thermo,
+                           Mutation::Transport::Transport& transport, 
+                           double T, 
+                           double p, 
+                           const double* Xe,
+                           GasProperties& props,
+                           double* seconds = nullptr);
+
+/**
+ * Transport properties of the current state of the Thermodynamics object of
+ * `transport`, e.g. after equilibriumProperties with another Transport 
+ * object of the same Thermodynamics.
+ */
+void transportProperties(Mutation::Transport::Transport& transport, GasProperties& props);
+
 class GasMixture {
 public:
 
@@ -37,8 +85,29 @@ public:
      *     scale. Default is log10. 
      * @param[in] mu_algorithm Method used to compute the viscosity. Default 
      *     is Chapmann-Enskog.
-     * @param[in] k_algorithm Method used to compute the thermal conductivity. 
-     *     Default is Wilke. Not used at this time. 
+     * @param[in] k_algorithm Method used to compute the thermal conductivity 
+     *     of the heavy particles. Default is Wilke.
+     * @param[in] n_threads Number of threads used to compute the properties.
+     *     Default is 0, which uses all hardware threads.
+     * @param[in] species_threshold Tabulate the equilibrium species mass 
+     *     fractions, dropping mass fractions below this threshold and species 
+     *     that never exceed it. Each species is stored on the part of the 
+     *     grid where it is present (see compactSupport). Default is a 
+     *     negative value, which does not tabulate the species.
+     * @param[in] cache_directory Directory of the persistent equilibrium 
+     *     cache. Grid points already in the cache are not recomputed and new
+     *     points are added to it. Default is empty, which disables the cache.
+     * @param[in] first_row First pressure row to compute. Default is 0.
+     * @param[in] last_row Last pressure row to compute. Default is -1, the 
+     *     last row of the range. Computing a subset of the rows produces a 
+     *     shard of the table, see mergeShards.
+     * @param[in] checkpoint_file Append each completed pressure row to this 
+     *     file; it is deleted once the table is written. Default is empty, 
+     *     which does not checkpoint.
+     * @param[in] resume Skip the rows completed in an existing checkpoint 
+     *     file of the same run. Default is false.
+     * @param[in] compute Compute the properties on construction. Default is
+     *     true. Pass false to generate the table with stream() instead.
      */
     GasMixture(std::string& pyrolysis_gas_mixture,
                double T_low = 200.0,
@@ -50,14 +119,22 @@ public:
                int nP = 6,
                std::string p_scale = "log10",
                std::string mu_algorithm = "Chapmann-Enskog_CG", 
-               std::string k_algorithm = "Wilke");
+               std::string k_algorithm = "Wilke",
+               int n_threads = 0,
+               double species_threshold = -1.0,
+               std::string cache_directory = "",
+               int first_row = 0,
+               int last_row = -1,
+               std::string checkpoint_file = "",
+               bool resume = false,
+               bool compute = true);
 
     /**
      * Deconstructor
      */
     ~GasMixture() {
-        delete thermo;
         delete transport;
+        delete thermo;
     }
 
     /** 
@@ -108,23 +185,103 @@ public:
      * Using the specified temperature and pressure ranges, compute the equilibrium 
      * mixture properties of the pyrolysis gas mixture at each pressure and temperature
      * point. The properties are stored in two-dimensional arrays with pressure as the
-     * outer dimension and temperature as the inner dimension.
+     * outer dimension and temperature as the inner dimension. Pressure rows are 
+     * computed in parallel, each thread with its own Mutation++ objects. 
+     * When a cache directory is set, points found in the cache are reused.
+     * When checkpointing, rows completed by a previous run are restored 
+     * instead of computed.
+     * 
+     * The thermal conductivity is the equilibrium (frozen plus reactive) 
+     * conductivity; the reactive component is also stored separately.
      */
     void computeProperties();
 
     /**
-     * Write the properties to a HDF5 file.
+     * Write the properties to a HDF5 file, with the provenance of the table 
+     * as attributes of its mixture group.
      * 
      * @param[in] gas_table Name of the gas table database file.
      */
     void write(std::string gas_table="gas_table.h5", std::string gas_mixture_name="");
 
+    /**
+     * Compute the properties and write each pressure row to the HDF5 file as
+     * soon as it is finished (see TableStream), without holding the table in
+     * memory. Used instead of computeProperties() and write() for large grids.
+     * With a species threshold, the species rows go to the scratch file 
+     * `gas_table`.species.tmp and only the species kept are copied to the 
+     * database at the end.
+     * 
+     * @param[in] gas_table Name of the gas table database file.
+     */
+    void stream(std::string gas_table="gas_table.h5", std::string gas_mixture_name="");
+
+    /**
+     * Compute the properties of several mixtures together, as by 
+     * computeProperties() on each (which must have been constructed with 
+     * compute = false). Every block of `block_size` temperature points of 
+     * every pressure row of every mixture is a task of one work-stealing
+     * pool (see parallelTasks), so all threads stay busy until the last 
+     * table is complete. The cost of a block is its number of points not in 
+     * the equilibrium cache times their expected time: the mean time per 
+     * point over the block temperatures in the cost profile of the mixture 
+     * (see setCostProfile), or else in the profile of its last generation. 
+     * Mixtures without either use the mean time per point of the others, 
+     * and the point count alone is used when no mixture has a profile.
+     * Each thread creates its own Mutation++ objects for a mixture the first
+     * time it works on it.
+     * 
+     * @param[in] n_threads Number of threads. Default is 0, which uses all
+     *     hardware threads.
+     */
+    static void computeAll(const std::vector<GasMixture*>& mixtures, int n_threads = 0, int block_size = 16);
+
+    /**
+     * Timing of the setup, computation and output of the table, and of each
+     * grid point.
+     */
+    const GenerationProfile& profile() const { 
+        return timing;
+    }
+
+    /**
+     * Cost the tasks of computeAll with the point times of `costs`, e.g. the 
+     * profile of an earlier generation of the mixture read with 
+     * GenerationProfile::readJson. Its grid need not be that of this table.
+     */
+    void setCostProfile(const GenerationProfile& costs) { 
+        cost_profile = costs;
+    }
+
+    /**
+     * Generation parameters of the table, with the full pressure range of a
+     * shard. Known on construction, before any property is computed, so a 
+     * caller can check whether an existing database already holds the table
+     * (see tableUpToDate).
+     */
+    const TableProvenance& provenance() const { 
+        return origin;
+    }
+
 private:
     std::string pyrolysis_gas;
     std::string viscosity_algorithm;
     std::string conductivity_algorithm;
     std::string pressure_scale;
     std::string temperature_scale;
+    int threads;
+    double species_cutoff;
+    std::string cache_dir;
+    std::unique_ptr<MemoCache> memo;
+    int row_offset;
+    int total_rows;
+    std::string checkpoint_name;
+    bool resume_run;
+    std::unique_ptr<RowCheckpoint> checkpoint;
+    int n_species;
+    GenerationProfile timing;
+    GenerationProfile cost_profile;
+    TableProvenance origin;
 
     Mutation::Thermodynamics::Thermodynamics* thermo;
     Mutation::Transport::Transport* transport;
@@ -140,10 +297,50 @@ private:
     std::vector< std::vector<double> > viscosity;
     std::vector< std::vector<double> > molecular_weight;
     std::vector< std::vector<double> > density;
+    std::vector< std::vector<double> > conductivity;
+    std::vector< std::vector<double> > reactive_conductivity;
+    std::vector< std::vector< std::vector<double> > > species;
 
-    void linear_range(double &low, double &high, std::vector<double>& var);
-    
-    void log_range(double &low, double &high, std::vector<double>& var);
+    /**
+     * Property tables in row order: the properties of GasProperties followed
+     * by the tabulated species.
+     */
+    std::vector< std::vector< std::vector<double> >* > rowTables();
+
+    /**
+     * Size the property tables for the pressure rows.
+     */
+    void allocateTables();
+
+    /**
+     * Copy a finished row into the property tables.
+     */
+    void storeRow(int j, const double* row);
+
+    /**
+     * Open the equilibrium cache and the checkpoint, if requested, of a run
+     * with elemental mole fractions Xe.
+     */
+    void openRowStores(const std::vector<double>& Xe);
+
+    /**
+     * Compute (or restore from the checkpoint) every pressure row in parallel
+     * and pass each finished row to `sink`, concurrently. A row holds the 
+     * temperature points of each table in rowTables() order.
+     */
+    void generateRows(const std::function<void(int, const double*)>& sink);
+
+    /**
+     * Compute the temperature points [i_begin, i_end) of row j (by default 
+     * all of them) into `row`.
+     */
+    void computeRow(int j, 
+                    Mutation::Thermodynamics::Thermodynamics& thermo,
+                    Mutation::Transport::Transport& transport, 
+                    const double* Xe,
+                    double* row,
+                    int i_begin = 0,
+                    int i_end = -1);
 
 };
 
@@ -0,0 +1,115 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "surface_gas.h"
+#include "grid.h"
+#include "parallel.h"
+
+namespace IcarusPyro { 
+
+SurfaceMixture::SurfaceMixture(std::string& surface_gas_mixture,
+                               double T_low,
+                               double T_high, 
+                               int nT,
+                               std::string T_scale, 
+                               double p_low, 
+                               double p_high,
+                               int nP,
+                               std::string p_scale,
+                               double Bg_low,
+                               double Bg_high,
+                               int nBg,
+                               std::string Bg_scale,
+                               std::string edge_composition,
+                               std::string pyrolysis_composition,
+                               int n_threads)
+    : surface_gas(surface_gas_mixture),
+      temperature_scale(T_scale),
+      pressure_scale(p_scale),
+      bprime_g_scale(Bg_scale),
+      threads(n_threads),
+      thermo(nullptr),
+      bprimeTable(surface_gas_mixture)
+{
+    thermo = createMutation();
+
+    int nE = thermo->nElements();
+    Yke.resize(nE);
+    Ykg.resize(nE);
+    if (!thermo->getComposition(edge_composition, Yke.data(), Mutation::Thermodynamics::Composition::MASS)) { 
+        throw std::runtime_error("Composition " + edge_composition + " is not defined in " + surface_gas);
+    }
+    if (!thermo->getComposition(pyrolysis_composition, Ykg.data(), Mutation::Thermodynamics::Composition::MASS)) { 
+        throw std::runtime_error("Composition " + pyrolysis_composition + " is not defined in " + surface_gas);
+    }
+
+    makeRange(T_low, T_high, nT, T_scale, temperature);
+    makeRange(p_low, p_high, nP, p_scale, pressure);
+    makeRange(Bg_low, Bg_high, nBg, Bg_scale, bprime_g);
+    computeProperties();
+}
+
+Mutation::Thermodynamics::Thermodynamics* SurfaceMixture::createMutation() const
+{
+    Mutation::MixtureOptions* opts = new Mutation::MixtureOptions(surface_gas);
+    Mutation::Thermodynamics::Thermodynamics* th = 
+        new Mutation::Thermodynamics::Thermodynamics(opts->getSpeciesDescriptor(), 
+                                                     opts->getThermodynamicDatabase(),
+                                                     opts->getStateModel());
+    delete opts;
+    return th;
+}
+
+void SurfaceMixture::computeProperties()
+{
+    int bg_size = bprime_g.size();
+    int p_size = pressure.size();
+    int n_rows = bg_size * p_size;
+
+    bprime_c.resize(bg_size);
+    wall_enthalpy.resize(bg_size);
+    for (int k = 0; k < bg_size; k++) { 
+        bprime_c[k].resize(p_size);
+        wall_enthalpy[k].resize(p_size);
+    }
+
+    int nthreads = std::min(numThreads(threads), n_rows);
+    std::vector<std::unique_ptr<Mutation::Thermodynamics::Thermodynamics>> thermos;
+    for (int t = 1; t < nthreads; t++) { 
+        thermos.emplace_back(createMutation());
+    }
+
+    parallelFor(n_rows, nthreads, [&](int t, int row) { 
+        Mutation::Thermodynamics::Thermodynamics& th = (t == 0) ? *thermo : *thermos[t-1];
+        computeRow(row / p_size, row % p_size, th);
+    });
+}
+
+void SurfaceMixture::computeRow(int k, int j, Mutation::Thermodynamics::Thermodynamics& thermo)
+{
+    int T_size = temperature.size();
+    double p = pressure[j];
+    double Bg = bprime_g[k];
+
+    bprime_c[k][j].resize(T_size);
+    wall_enthalpy[k][j].resize(T_size);
+
+    for (int i = 0; i < T_size; i++) { 
+        double Bc, hw;
+        thermo.surfaceMassBalance(Yke.data(), Ykg.data(), temperature[i], p, Bg, Bc, hw);
+        bprime_c[k][j][i] = Bc;
+        wall_enthalpy[k][j][i] = hw;
+    }
+}
+
+void SurfaceMixture::write(std::string database, std::string surface_mixture_name)
+{
+    bprimeTable.load(temperature_scale, pressure_scale, bprime_g_scale, 
+                     temperature, pressure, bprime_g, 
+                     bprime_c, wall_enthalpy);
+    bprimeTable.write(database, surface_mixture_name);
+}
+
+} // namespace IcarusPyro
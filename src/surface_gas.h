@@ -0,0 +1,115 @@
+#ifndef ICARUSPYRO_SURFACE_GAS_H
+#define ICARUSPYRO_SURFACE_GAS_H
+
+#include <string>
+#include <vector>
+
+#include "MixtureOptions.h"
+#include "Thermodynamics.h"
+
+#include "bprime_table.h"
+
+namespace IcarusPyro {
+
+class SurfaceMixture {
+public:
+
+    /** 
+     * Constructor for the gas-surface interaction mixture object.
+     * 
+     * Upon return, the Mutation++ objects are initialized, and the B' solution 
+     * at each point in the wall temperature, pressure and B'_g ranges is 
+     * computed from the surface mass balance with equilibrium chemistry.
+     * 
+     * @param[in] surface_gas_mixture The name of the Mutation++ mixture file. 
+     *     The mixture must include the solid (e.g., graphite) species.
+     * @param[in] T_low Lowest value in the wall temperature range. Default is 300.
+     * @param[in] T_high Highest value in the wall temperature range. Default is 4000.
+     * @param[in] nT Number of discrete temperature points within range. Default
+     *     is 75.
+     * @param[in] T_scale Temperature range distributed either on a linear or 
+     *     log scale. Default is linear.
+     * @param[in] p_low Lowest value in the pressure range. Default is 1.01325. 
+     * @param[in] p_high Highest value in the pressure range. Default is 1013250.0
+     * @param[in] nP Number of discrete pressure points within range. Default 
+     *     is 6.
+     * @param[in] p_scale Pressure range distributed either on a linear or log 
+     *     scale. Default is log10. 
+     * @param[in] Bg_low Lowest value in the B'_g range. Default is 0.
+     * @param[in] Bg_high Highest value in the B'_g range. Default is 10.
+     * @param[in] nBg Number of discrete B'_g points within range. Default is 21.
+     * @param[in] Bg_scale B'_g range distributed either on a linear or log 
+     *     scale. Default is linear.
+     * @param[in] edge_composition Name of the boundary layer edge elemental 
+     *     composition in the mixture file. Default is BLedge.
+     * @param[in] pyrolysis_composition Name of the pyrolysis gas elemental 
+     *     composition in the mixture file. Default is Pyrolysis.
+     * @param[in] n_threads Number of threads used to compute the properties.
+     *     Default is 0, which uses all hardware threads.
+     */
+    SurfaceMixture(std::string& surface_gas_mixture,
+                   double T_low = 300.0,
+                   double T_high = 4000.0, 
+                   int nT = 75,
+                   std::string T_scale = "linear", 
+                   double p_low = 1.01325, 
+                   double p_high = 1013250.0,
+                   int nP = 6,
+                   std::string p_scale = "log10",
+                   double Bg_low = 0.0,
+                   double Bg_high = 10.0,
+                   int nBg = 21,
+                   std::string Bg_scale = "linear",
+                   std::string edge_composition = "BLedge",
+                   std::string pyrolysis_composition = "Pyrolysis",
+                   int n_threads = 0);
+
+    /**
+     * Deconstructor
+     */
+    ~SurfaceMixture() {
+        delete thermo;
+    }
+
+    /**
+     * Using the specified wall temperature, pressure and B'_g ranges, solve the
+     * surface mass balance at each point. The B'_c and wall enthalpy are stored
+     * as [B'_g][pressure][temperature]. The (B'_g, pressure) rows are computed
+     * in parallel, each thread with its own Mutation++ object.
+     */
+    void computeProperties();
+
+    /**
+     * Write the B' table to a HDF5 file. Other mixtures in the file are kept.
+     * 
+     * @param[in] database Name of the database file.
+     */
+    void write(std::string database="gas_table.h5", std::string surface_mixture_name="");
+
+private:
+    std::string surface_gas;
+    std::string temperature_scale;
+    std::string pressure_scale;
+    std::string bprime_g_scale;
+    int threads;
+
+    Mutation::Thermodynamics::Thermodynamics* thermo;
+
+    BprimeTable bprimeTable;
+
+    std::vector<double> temperature;
+    std::vector<double> pressure;
+    std::vector<double> bprime_g;
+    std::vector<double> Yke;
+    std::vector<double> Ykg;
+    std::vector< std::vector< std::vector<double> > > bprime_c;
+    std::vector< std::vector< std::vector<double> > > wall_enthalpy;
+
+    Mutation::Thermodynamics::Thermodynamics* createMutation() const;
+
+    void computeRow(int k, int j, Mutation::Thermodynamics::Thermodynamics& thermo);
+};
+
+} // namespace IcarusPyro
+
+#endif
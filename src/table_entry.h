@@ -1,24 +1,96 @@
 #ifndef __TABLE_ENTRY_H__
 #define __TABLE_ENTRY_H__
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <string>
+#include <utility>
 
 namespace IcarusPyro {
 
+/**
+ * Alignment, in bytes, of table storage. Each axis and data block of a table
+ * starts on a cache line.
+ */
+const size_t TABLE_ALIGNMENT = 64;
+
+/**
+ * Number of elements of T in n elements rounded up to the table alignment.
+ */
+template<class T>
+size_t alignedCount(size_t n) { 
+    const size_t block = TABLE_ALIGNMENT / sizeof(T);
+    return (n + block - 1) / block * block;
+}
+
+/**
+ * Allocate zero-initialised storage for n elements of T on the table 
+ * alignment. Release with alignedFree.
+ */
+template<class T>
+T* alignedAlloc(size_t n) { 
+    void* ptr(nullptr);
+    if (posix_memalign(&ptr, TABLE_ALIGNMENT, std::max<size_t>(n, 1) * sizeof(T)) != 0) { 
+        throw std::bad_alloc();
+    }
+    T* data = static_cast<T*>(ptr);
+    std::fill(data, data + n, T());
+    return data;
+}
+
+template<class T>
+void alignedFree(T* data) { 
+    free(data);
+}
+
+/**
+ * Two-dimensional array indexed (x, y). The storage is either owned (and 
+ * aligned) or a view of external storage, e.g. a GasTable arena. Copies are
+ * always owning deep copies; moves transfer the storage.
+ */
 template<class T>
 class array2d { 
 public:
-    array2d(int nxx, int nyy) : nx(nxx), ny(nyy) {
-        size = nx * ny;
-        data = new T[size];
+    array2d(int nxx, int nyy) 
+        : nx(nxx), ny(nyy), size(static_cast<size_t>(nxx) * nyy), owner(true) {
+        data = alignedAlloc<T>(size);
+    }
+
+    /**
+     * View of `storage`, which must hold nx * ny elements and outlive the array.
+     */
+    array2d(int nxx, int nyy, T* storage) 
+        : nx(nxx), ny(nyy), size(static_cast<size_t>(nxx) * nyy), owner(false), data(storage) {}
+
+    array2d(const array2d<T>& rhs) 
+        : nx(rhs.nx), ny(rhs.ny), size(rhs.size), owner(true) { 
+        data = alignedAlloc<T>(size);
+        std::copy(rhs.data, rhs.data + size, data);
+    }
+
+    array2d(array2d<T>&& rhs) 
+        : nx(rhs.nx), ny(rhs.ny), size(rhs.size), owner(rhs.owner), data(rhs.data) { 
+        rhs.release();
+    }
+
+    array2d<T>& operator=(array2d<T> rhs) { 
+        swap(rhs);
+        return *this;
+    }
+
+    ~array2d() { 
+        if (owner) alignedFree(data);
     }
 
-    array2d(const array2d<T>& rhs) { 
-        nx = rhs.nx;
-        ny = rhs.ny;
-        size = static_cast<size_t>(nx * ny);
-        data = new T[size];
-        for (unsigned int i = 0; i < size; i++) data[i] = rhs.data[i];
+    void swap(array2d<T>& rhs) { 
+        std::swap(nx, rhs.nx);
+        std::swap(ny, rhs.ny);
+        std::swap(size, rhs.size);
+        std::swap(owner, rhs.owner);
+        std::swap(data, rhs.data);
     }
 
     T operator()(int x, int y) const { 
@@ -29,37 +101,236 @@ public:
         return data[y + ny * x];
     }
 
-    ~array2d() { 
-        delete [] data;
-    }
+    T* values() { return data; }
+
+    const T* values() const { return data; }
+
+    bool ownsStorage() const { return owner; }
 
 private: 
     int nx, ny;
     size_t size;
+    bool owner;
     T* data;
+
+    void release() { 
+        nx = ny = 0;
+        size = 0;
+        owner = false;
+        data = nullptr;
+    }
+};
+
+/**
+ * Location of a point within a table: the lower corner (i, j) of the 
+ * enclosing cell, the linear interpolation weights along each axis and the 
+ * derivative of the x-weight with respect to x (zero when clamped). Tables 
+ * sharing the same axes can reuse one index for every property.
+ */
+struct TableIndex {
+    int i, j;
+    double wx, wy;
+    double dwx;
 };
 
+/**
+ * Table of a property z(x, y) on a rectilinear grid.
+ * 
+ * The axes and data live in one aligned block, laid out as x, y, z with each
+ * part starting on the table alignment (see storageSize). The block is owned
+ * by the table or, for tables loaded into a GasTable arena, a view of external
+ * storage. Copies are owning deep copies; moves transfer the block.
+ */
 template<class T>
 class TableEntry { 
 public: 
     TableEntry(int nxx, int nyy, std::string xvar, std::string yvar, std::string xscale, std::string yscale) 
+        : TableEntry(nxx, nyy, xvar, yvar, xscale, yscale, nullptr) {}
+
+    /**
+     * Table viewing `storage`, which must hold storageSize(nxx, nyy) 
+     * zero-initialised elements on the table alignment and outlive the table.
+     * A null `storage` allocates an owned block.
+     */
+    TableEntry(int nxx, int nyy, std::string xvar, std::string yvar, std::string xscale, std::string yscale, T* storage) 
         : nx(nxx), 
           ny(nyy),
           x_variable(xvar),
           y_variable(yvar),
           x_scale(xscale),
-          y_scale(yscale)
+          y_scale(yscale),
+          nz(static_cast<size_t>(nxx) * nyy),
+          x(nullptr),
+          y(nullptr),
+          z(nullptr),
+          grid(0, 0, nullptr),
+          block(storage ? storage : alignedAlloc<T>(storageSize(nxx, nyy))),
+          owner(storage == nullptr),
+          x_log(xscale == "log10"),
+          y_log(yscale == "log10"),
+          x_step(0.0),
+          y_step(0.0)
     {
-        nz = static_cast<size_t>(nx * ny);
-        x = new T[nx];
-        y = new T[ny];
-        z = new array2d<T>(nx, ny);
+        attach();
+    }
+
+    TableEntry(const TableEntry<T>& rhs) 
+        : TableEntry(rhs.nx, rhs.ny, rhs.x_variable, rhs.y_variable, rhs.x_scale, rhs.y_scale, nullptr) { 
+        std::copy(rhs.block, rhs.block + storageSize(nx, ny), block);
+        x_step = rhs.x_step;
+        y_step = rhs.y_step;
+    }
+
+    TableEntry(TableEntry<T>&& rhs) 
+        : nx(rhs.nx), 
+          ny(rhs.ny),
+          x_variable(std::move(rhs.x_variable)),
+          y_variable(std::move(rhs.y_variable)),
+          x_scale(std::move(rhs.x_scale)),
+          y_scale(std::move(rhs.y_scale)),
+          nz(rhs.nz),
+          x(rhs.x),
+          y(rhs.y),
+          z(&grid),
+          grid(std::move(rhs.grid)),
+          block(rhs.block),
+          owner(rhs.owner),
+          x_log(rhs.x_log),
+          y_log(rhs.y_log),
+          x_step(rhs.x_step),
+          y_step(rhs.y_step)
+    {
+        rhs.nx = rhs.ny = 0;
+        rhs.nz = 0;
+        rhs.x = rhs.y = nullptr;
+        rhs.z = nullptr;
+        rhs.block = nullptr;
+        rhs.owner = false;
+    }
+
+    TableEntry<T>& operator=(TableEntry<T> rhs) { 
+        std::swap(nx, rhs.nx);
+        std::swap(ny, rhs.ny);
+        std::swap(x_variable, rhs.x_variable);
+        std::swap(y_variable, rhs.y_variable);
+        std::swap(x_scale, rhs.x_scale);
+        std::swap(y_scale, rhs.y_scale);
+        std::swap(nz, rhs.nz);
+        std::swap(x, rhs.x);
+        std::swap(y, rhs.y);
+        grid.swap(rhs.grid);
+        std::swap(block, rhs.block);
+        std::swap(owner, rhs.owner);
+        std::swap(x_log, rhs.x_log);
+        std::swap(y_log, rhs.y_log);
+        std::swap(x_step, rhs.x_step);
+        std::swap(y_step, rhs.y_step);
+        z = &grid;
+        return *this;
     }
 
     ~TableEntry() {
-        delete [] x;
-        delete [] y;
-        delete z;
+        if (owner) alignedFree(block);
+    }
+
+    /**
+     * Number of elements of the storage block of an nx by ny table.
+     */
+    static size_t storageSize(int nx, int ny) { 
+        return alignedCount<T>(nx) + alignedCount<T>(ny) + alignedCount<T>(static_cast<size_t>(nx) * ny);
+    }
+
+    /**
+     * Change the scales of the axes (linear or log10).
+     */
+    void setScales(const std::string& xscale, const std::string& yscale) { 
+        x_scale = xscale;
+        y_scale = yscale;
+        x_log = (xscale == "log10");
+        y_log = (yscale == "log10");
+        detectUniformAxes();
+    }
+
+    /**
+     * Check whether each axis is uniform in its scale (linear, or in log10),
+     * in which case locate() computes the cell directly rather than 
+     * searching for it. Call after the axes are set or changed; until then 
+     * (or if they change after) locate() gives the same results, only 
+     * without the shortcut.
+     */
+    void detectUniformAxes() { 
+        x_step = uniformStep(x, nx, x_log);
+        y_step = uniformStep(y, ny, y_log);
+    }
+
+    /**
+     * True if locate() computes the cell along x (or y) directly.
+     */
+    bool uniformX() const { return x_step > 0.0; }
+    bool uniformY() const { return y_step > 0.0; }
+
+    /**
+     * True if the table owns its storage rather than viewing an arena.
+     */
+    bool ownsStorage() const { 
+        return owner;
+    }
+
+    /**
+     * Find the table cell containing the point (xp, yp). Axes on a log10 
+     * scale are interpolated in log space. Points outside of the table 
+     * range are clamped to the nearest edge.
+     */
+    TableIndex locate(T xp, T yp) const {
+        TableIndex idx;
+        double dwy;
+        if (x_step > 0.0) { 
+            uniformAxis(x, nx, x_log, x_step, xp, idx.i, idx.wx, idx.dwx);
+        } else { 
+            locateAxis(x, nx, x_log, xp, idx.i, idx.wx, idx.dwx);
+        }
+        if (y_step > 0.0) { 
+            uniformAxis(y, ny, y_log, y_step, yp, idx.j, idx.wy, dwy);
+        } else { 
+            locateAxis(y, ny, y_log, yp, idx.j, idx.wy, dwy);
+        }
+        return idx;
+    }
+
+    /**
+     * Bilinear interpolation of the table data at a previously located point.
+     */
+    T interpolate(const TableIndex& idx) const {
+        int i1 = (nx > 1) ? idx.i + 1 : idx.i;
+        int j1 = (ny > 1) ? idx.j + 1 : idx.j;
+        T z0 = (*z)(idx.i, idx.j) + idx.wx * ((*z)(i1, idx.j) - (*z)(idx.i, idx.j));
+        T z1 = (*z)(idx.i, j1) + idx.wx * ((*z)(i1, j1) - (*z)(idx.i, j1));
+        return z0 + idx.wy * (z1 - z0);
+    }
+
+    T interpolate(T xp, T yp) const {
+        return interpolate(locate(xp, yp));
+    }
+
+    /**
+     * Derivative of the bilinear interpolant with respect to x at a 
+     * previously located point.
+     */
+    T derivativeX(const TableIndex& idx) const {
+        int i1 = (nx > 1) ? idx.i + 1 : idx.i;
+        int j1 = (ny > 1) ? idx.j + 1 : idx.j;
+        T dz0 = (*z)(i1, idx.j) - (*z)(idx.i, idx.j);
+        T dz1 = (*z)(i1, j1) - (*z)(idx.i, j1);
+        return idx.dwx * (dz0 + idx.wy * (dz1 - dz0));
+    }
+
+    /**
+     * True when both tables are defined on identical independent variables.
+     */
+    bool sameAxes(const TableEntry<T>& rhs) const {
+        if (nx != rhs.nx || ny != rhs.ny) return false;
+        if (x_scale != rhs.x_scale || y_scale != rhs.y_scale) return false;
+        return std::equal(x, x + nx, rhs.x) && std::equal(y, y + ny, rhs.y);
     }
 
     int nx, ny;
@@ -69,7 +340,133 @@ public:
     T* x;
     T* y;
     array2d<T>* z;
+
+    /**
+     * Find the interval k of the axis v[0..n) containing p, the linear (or
+     * log-linear) weight w within it and the derivative dw/dp. Points outside
+     * of the axis are clamped to the nearest edge.
+     */
+    static void locateAxis(const T* v, int n, bool log_scale, T p, int& k, double& w, double& dw) {
+        if (n < 2 || p <= v[0]) {
+            k = 0;
+            w = 0.0;
+            dw = 0.0;
+            return;
+        }
+        if (p >= v[n-1]) {
+            k = n - 2;
+            w = 1.0;
+            dw = 0.0;
+            return;
+        }
+        k = static_cast<int>(std::upper_bound(v, v + n, p) - v) - 1;
+        axisWeight(v, k, log_scale, p, w, dw);
+    }
+
+    /**
+     * As locateAxis, starting from the interval k of a previous point: the
+     * interval is checked first and the neighbouring ones walked for up to
+     * MAX_WALK steps before falling back to a binary search. The result is 
+     * the same as locateAxis for any k.
+     */
+    static void walkAxis(const T* v, int n, bool log_scale, T p, int& k, double& w, double& dw) {
+        if (n < 2 || p <= v[0] || p >= v[n-1] || k < 0 || k > n - 2) {
+            locateAxis(v, n, log_scale, p, k, w, dw);
+            return;
+        }
+        int steps = 0;
+        while (p < v[k] && steps++ < MAX_WALK) k--;
+        while (p >= v[k+1] && steps++ < MAX_WALK) k++;
+        if (p < v[k] || p >= v[k+1]) {
+            k = static_cast<int>(std::upper_bound(v, v + n, p) - v) - 1;
+        }
+        axisWeight(v, k, log_scale, p, w, dw);
+    }
+
+    /**
+     * As locateAxis on an axis uniform in its scale, with `inv_step` the 
+     * inverse of its spacing (see detectUniformAxes): the interval follows 
+     * from the position of p, corrected by one for rounding at the nodes. 
+     * The result is the same as locateAxis.
+     */
+    static void uniformAxis(const T* v, int n, bool log_scale, double inv_step, T p, 
+                            int& k, double& w, double& dw) {
+        if (n < 2 || p <= v[0] || p >= v[n-1]) {
+            locateAxis(v, n, log_scale, p, k, w, dw);
+            return;
+        }
+        double s = log_scale ? std::log(p / v[0]) : p - v[0];
+        k = std::min(std::max(static_cast<int>(s * inv_step), 0), n - 2);
+        if (p < v[k]) { 
+            if (k > 0) k--;
+        } else if (p >= v[k+1]) { 
+            if (k < n - 2) k++;
+        }
+        if (p < v[k] || p >= v[k+1]) {
+            k = static_cast<int>(std::upper_bound(v, v + n, p) - v) - 1;
+        }
+        axisWeight(v, k, log_scale, p, w, dw);
+    }
+
+    /**
+     * Find the table cell containing the point (xp, yp) starting from the 
+     * cell (i, j) of a previous point, see walkAxis. Equal to locate(xp, yp).
+     */
+    TableIndex locateFrom(T xp, T yp, int i, int j) const {
+        TableIndex idx;
+        double dwy;
+        idx.i = i;
+        idx.j = j;
+        walkAxis(x, nx, x_log, xp, idx.i, idx.wx, idx.dwx);
+        walkAxis(y, ny, y_log, yp, idx.j, idx.wy, dwy);
+        return idx;
+    }
+
+    /**
+     * Number of neighbouring intervals walkAxis checks before searching.
+     */
+    static const int MAX_WALK = 4;
+
+private:
+    array2d<T> grid;
+    T* block;
+    bool owner;
+    bool x_log, y_log;
+    // Inverse spacing of uniform axes in their scale, or zero.
+    double x_step, y_step;
+
+    // Inverse spacing of an axis uniform to round-off in its scale (in the 
+    // natural log for log10 axes), or zero.
+    static double uniformStep(const T* v, int n, bool log_scale) { 
+        if (n < 3 || !(v[n-1] > v[0])) return 0.0;
+        if (log_scale && !(v[0] > 0.0)) return 0.0;
+        double range = log_scale ? std::log(v[n-1] / v[0]) : v[n-1] - v[0];
+        double step = range / (n - 1);
+        for (int i = 1; i < n - 1; i++) { 
+            double s = log_scale ? std::log(v[i] / v[0]) : v[i] - v[0];
+            if (std::abs(s - i * step) > 1.0e-9 * range) return 0.0;
+        }
+        return 1.0 / step;
+    }
+
+    static void axisWeight(const T* v, int k, bool log_scale, T p, double& w, double& dw) {
+        if (log_scale) {
+            double dlog = std::log(v[k+1] / v[k]);
+            w = std::log(p / v[k]) / dlog;
+            dw = 1.0 / (p * dlog);
+        } else {
+            w = (p - v[k]) / (v[k+1] - v[k]);
+            dw = 1.0 / (v[k+1] - v[k]);
+        }
+    }
+
+    void attach() { 
+        x = block;
+        y = block + alignedCount<T>(nx);
+        grid = array2d<T>(nx, ny, y + alignedCount<T>(ny));
+        z = &grid;
+    }
 };
 
 } // namespace IcarusPyro
-#endif
\ No newline at end of file
+#endif
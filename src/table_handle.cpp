@@ -0,0 +1,76 @@
+#include <stdexcept>
+
+#include "table_handle.h"
+
+namespace IcarusPyro {
+
+GasTableHandle::GasTableHandle(GasTable* table, int max_readers)
+    : current(table),
+      epoch(1),
+      slots(max_readers)
+{
+    if (!table) {
+        throw std::runtime_error("A gas table handle needs an initial table.");
+    }
+    if (max_readers < 1) {
+        throw std::runtime_error("A gas table handle needs at least one reader slot.");
+    }
+}
+
+GasTableHandle::~GasTableHandle()
+{
+    for (size_t k = 0; k < retired.size(); k++) {
+        delete retired[k].table;
+    }
+    delete current.load();
+}
+
+void GasTableHandle::publish(GasTable* table)
+{
+    if (!table) {
+        throw std::runtime_error("Cannot publish a null gas table.");
+    }
+    std::lock_guard<std::mutex> lock(writer);
+    const GasTable* previous = current.exchange(table);
+    // Readers that announce an epoch after this increment load the pointer
+    // after the exchange, so only those at or before `swapped` can hold the
+    // previous table.
+    unsigned long swapped = epoch.fetch_add(1);
+    retired.push_back(Retired{const_cast<GasTable*>(previous), swapped});
+    reclaimRetired();
+}
+
+std::future<void> GasTableHandle::reload(const std::string& pyrolysis_gas_mixture, const std::string& database)
+{
+    return std::async(std::launch::async, [this, pyrolysis_gas_mixture, database]() {
+        GasTable table = loadGasTableAsync(pyrolysis_gas_mixture, database).get();
+        publish(new GasTable(std::move(table)));
+    });
+}
+
+int GasTableHandle::reclaim()
+{
+    std::lock_guard<std::mutex> lock(writer);
+    return reclaimRetired();
+}
+
+int GasTableHandle::reclaimRetired()
+{
+    unsigned long oldest = epoch.load();
+    for (size_t r = 0; r < slots.size(); r++) {
+        unsigned long e = slots[r].epoch.load();
+        if (e != 0 && e < oldest) oldest = e;
+    }
+    size_t kept = 0;
+    for (size_t k = 0; k < retired.size(); k++) {
+        if (retired[k].epoch < oldest) {
+            delete retired[k].table;
+        } else {
+            retired[kept++] = retired[k];
+        }
+    }
+    retired.resize(kept);
+    return static_cast<int>(kept);
+}
+
+} // namespace IcarusPyro
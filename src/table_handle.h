@@ -0,0 +1,168 @@
+#ifndef ICARUSPYRO_TABLE_HANDLE_H
+#define ICARUSPYRO_TABLE_HANDLE_H
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gas_table.h"
+
+namespace IcarusPyro {
+
+/**
+ * Handle to the current gas table of a running solver, which can be replaced
+ * (e.g. by a corrected or extended table) while lookups are in flight.
+ *
+ * Readers take an immutable snapshot of the current table through an atomic
+ * pointer, with no lock on the lookup path: a snapshot announces the global
+ * epoch in the reader's slot, then loads the pointer. publish() swaps the
+ * pointer and retires the old table with the epoch of the swap; a retired
+ * table is deleted once no reader slot holds an epoch at or before it, i.e.
+ * once every snapshot that may still see it has been released.
+ *
+ * Each concurrent reader uses its own slot, e.g. the thread index `t` of
+ * parallelFor, and holds at most one snapshot at a time. Publishing is
+ * serialised between writers but never waits for readers.
+ *
+ *     GasTableHandle handle(new GasTable("tacot24", "gas_table.h5"), n_threads);
+ *     // Any time, from any thread. The future is kept: the destructor of the
+ *     // future of a reload waits for it, so a discarded one would block here.
+ *     std::future<void> reloaded = handle.reload("tacot24", "gas_table_v2.h5");
+ *     parallelFor(n, n_threads, [&](int t, int i) {
+ *         GasTableHandle::Snapshot table = handle.snapshot(t);
+ *         table->lookup(T[i], p[i], props[i]);
+ *     });
+ *     reloaded.get();  // before the handle goes out of scope
+ */
+class GasTableHandle {
+public:
+    /**
+     * Immutable view of the table that was current when it was taken. The
+     * table stays valid until the snapshot is destroyed.
+     */
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& rhs) : slot(rhs.slot), table(rhs.table) {
+            rhs.slot = nullptr;
+            rhs.table = nullptr;
+        }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        ~Snapshot() {
+            if (slot) slot->store(0, std::memory_order_release);
+        }
+
+        const GasTable* get() const { return table; }
+        const GasTable* operator->() const { return table; }
+        const GasTable& operator*() const { return *table; }
+
+    private:
+        friend class GasTableHandle;
+        Snapshot(std::atomic<unsigned long>* reader_slot, const GasTable* current)
+            : slot(reader_slot), table(current) {}
+
+        std::atomic<unsigned long>* slot;
+        const GasTable* table;
+    };
+
+    /**
+     * @param[in] table Initial table, owned by the handle.
+     * @param[in] max_readers Number of reader slots, i.e. of threads that can
+     *     hold a snapshot at the same time.
+     */
+    GasTableHandle(GasTable* table, int max_readers);
+
+    GasTableHandle(const GasTableHandle&) = delete;
+    GasTableHandle& operator=(const GasTableHandle&) = delete;
+
+    /**
+     * Delete the current and retired tables. No snapshot may outlive the
+     * handle.
+     */
+    ~GasTableHandle();
+
+    /**
+     * Snapshot of the current table for reader slot `reader`, in
+     * [0, readers()). Lock free and wait free.
+     */
+    Snapshot snapshot(int reader) const {
+        if (reader < 0 || reader >= readers()) {
+            throw std::runtime_error("Invalid gas table reader slot " + std::to_string(reader) + ".");
+        }
+        std::atomic<unsigned long>* slot = &slots[reader].epoch;
+        slot->store(epoch.load());
+        return Snapshot(slot, current.load());
+    }
+
+    /**
+     * Make `table` (owned by the handle) the current table. Snapshots taken
+     * before keep the previous table, which is deleted once they are all
+     * released.
+     */
+    void publish(GasTable* table);
+
+    /**
+     * Read the table of a mixture from a database in the background (see
+     * loadGasTableAsync) and publish it. get() on the returned future
+     * rethrows the error of the read, in which case the current table is
+     * kept.
+     *
+     * The reload refers to the handle, which must outlive it: wait on the
+     * future before the handle is destroyed. As for any std::async future,
+     * its destructor waits for the reload, so keep the future (or call 
+     * reload from a thread of its own) to overlap the read with lookups.
+     */
+    std::future<void> reload(const std::string& pyrolysis_gas_mixture, const std::string& database);
+
+    /**
+     * Delete the retired tables that no snapshot can see. Called by
+     * publish(); call it to release memory once the readers have moved on.
+     *
+     * @return Number of tables still retired.
+     */
+    int reclaim();
+
+    int readers() const {
+        return static_cast<int>(slots.size());
+    }
+
+    /**
+     * Number of tables published since construction.
+     */
+    unsigned long version() const {
+        return epoch.load() - 1;
+    }
+
+private:
+    // Reader slots are padded to a cache line, so that readers do not
+    // share lines.
+    struct ReaderSlot {
+        std::atomic<unsigned long> epoch;
+        char padding[64 - sizeof(std::atomic<unsigned long>)];
+        ReaderSlot() : epoch(0) {}
+    };
+
+    struct Retired {
+        GasTable* table;
+        unsigned long epoch;
+    };
+
+    std::atomic<const GasTable*> current;
+    // Epochs start at 1: a slot holding 0 is not reading.
+    std::atomic<unsigned long> epoch;
+    mutable std::vector<ReaderSlot> slots;
+
+    std::mutex writer;
+    std::vector<Retired> retired;
+
+    // Delete the retired tables older than every reader, with `writer` held.
+    int reclaimRetired();
+};
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gas_table.h"
+#include "table_merge.h"
+#include "table_provenance.h"
+
+using namespace H5;
+
+namespace IcarusPyro {
+
+namespace {
+
+int readIntAttribute(Group* group, const H5std_string& name)
+{
+    int value = 0;
+    Attribute attr = group->openAttribute(name);
+    attr.read(PredType::NATIVE_INT, &value);
+    return value;
+}
+
+void writeIntAttribute(Group* group, const H5std_string& name, int value)
+{
+    if (group->attrExists(name)) group->removeAttr(name);
+    Attribute attr = group->createAttribute(name, PredType::NATIVE_INT, DataSpace(H5S_SCALAR));
+    attr.write(PredType::NATIVE_INT, &value);
+}
+
+void writeRowAttributes(Group* gas, int first_row, int total_rows)
+{
+    HDF5Names H5Names;
+    writeIntAttribute(gas, H5Names.first_row, first_row);
+    writeIntAttribute(gas, H5Names.total_rows, total_rows);
+}
+
+/**
+ * Merge the children of the shard groups `parts` (in row order) into `out`.
+ * Groups holding a table entry are concatenated; any other group, e.g. the
+ * species, is merged recursively. Shards keep every species, whatever the
+ * species threshold, so that they hold the same tables: the merged species
+ * tables are compacted, and dropped if zero everywhere, as a single run 
+ * would write them.
+ */
+void mergeGroups(const std::vector<Group*>& parts, Group* out, const std::string& path, bool species = false)
+{
+    HDF5Names H5Names;
+    Group* first = parts[0];
+    hsize_t n = first->getNumObjs();
+    for (size_t k = 1; k < parts.size(); k++) {
+        if (parts[k]->getNumObjs() != n) {
+            throw std::runtime_error("Shards of " + path + " hold different properties.");
+        }
+    }
+
+    for (hsize_t c = 0; c < n; c++) {
+        H5std_string name = first->getObjnameByIdx(c);
+        std::string child_path = path + "/" + name;
+        if (first->childObjType(name) != H5O_TYPE_GROUP) {
+            throw std::runtime_error("Cannot merge dataset " + child_path + ".");
+        }
+
+        std::vector<std::unique_ptr<Group>> children;
+        for (size_t k = 0; k < parts.size(); k++) {
+            if (H5Lexists(parts[k]->getId(), name.c_str(), H5P_DEFAULT) <= 0) {
+                throw std::runtime_error("Shard is missing " + child_path + ".");
+            }
+            children.emplace_back(new Group(parts[k]->openGroup(name)));
+        }
+
+        if (children[0]->attrExists(H5Names.nx)) {
+            std::vector<TableEntry<double>*> entries;
+            for (size_t k = 0; k < parts.size(); k++) {
+                entries.push_back(readTableEntry(parts[k], name));
+            }
+            TableEntry<double>* merged(nullptr);
+            try {
+                merged = concatenateRows(entries, child_path);
+            } catch (...) {
+                for (size_t k = 0; k < entries.size(); k++) delete entries[k];
+                throw;
+            }
+            for (size_t k = 0; k < entries.size(); k++) delete entries[k];
+            if (species) {
+                TableEntry<double>* compact = compactSupport(*merged);
+                delete merged;
+                merged = compact;
+            }
+            if (merged) writeTableEntry(out, name, merged);
+            delete merged;
+        } else {
+            std::vector<Group*> groups;
+            for (size_t k = 0; k < children.size(); k++) groups.push_back(children[k].get());
+            std::unique_ptr<Group> sub(new Group(out->createGroup(name)));
+            mergeGroups(groups, sub.get(), child_path, name == H5Names.species);
+        }
+    }
+}
+
+} // namespace
+
+void writeShardInfo(const std::string& database,
+                    const std::string& gas_mixture_name,
+                    int first_row,
+                    int total_rows)
+{
+    std::unique_ptr<H5File> file(openDatabase(database));
+    if (!file) {
+        throw std::runtime_error("Could not open database " + database + ".");
+    }
+    std::unique_ptr<Group> gas(new Group(file->openGroup(gas_mixture_name)));
+    writeRowAttributes(gas.get(), first_row, total_rows);
+}
+
+bool isShard(Group* gas)
+{
+    HDF5Names H5Names;
+    if (!gas->attrExists(H5Names.first_row) || !gas->attrExists(H5Names.total_rows)) return false;
+    int nx, ny;
+    readTableShape(gas, H5Names.enthalpy, nx, ny);
+    return readIntAttribute(gas, H5Names.first_row) != 0 || readIntAttribute(gas, H5Names.total_rows) != ny;
+}
+
+TableEntry<double>* concatenateRows(const std::vector<TableEntry<double>*>& parts,
+                                    const std::string& name)
+{
+    if (parts.empty()) {
+        throw std::runtime_error("No table entries to merge for " + name + ".");
+    }
+
+    const TableEntry<double>* first = parts[0];
+    int ny = 0;
+    for (size_t k = 0; k < parts.size(); k++) {
+        const TableEntry<double>* part = parts[k];
+        if (part->nx != first->nx ||
+            part->x_variable != first->x_variable || part->y_variable != first->y_variable ||
+            part->x_scale != first->x_scale || part->y_scale != first->y_scale) {
+            throw std::runtime_error("Shards of " + name + " have different axes or attributes.");
+        }
+        for (int i = 0; i < first->nx; i++) {
+            if (part->x[i] != first->x[i]) {
+                throw std::runtime_error("Shards of " + name + " have different " + first->x_variable + " values.");
+            }
+        }
+        ny += part->ny;
+    }
+
+    TableEntry<double>* var = new TableEntry<double>(first->nx, ny,
+                                                     first->x_variable, first->y_variable,
+                                                     first->x_scale, first->y_scale);
+    for (int i = 0; i < first->nx; i++) {
+        var->x[i] = first->x[i];
+    }
+
+    int j = 0;
+    for (size_t k = 0; k < parts.size(); k++) {
+        const TableEntry<double>* part = parts[k];
+        for (int jj = 0; jj < part->ny; jj++, j++) {
+            var->y[j] = part->y[jj];
+            if (j > 0 && !(var->y[j] > var->y[j-1])) {
+                delete var;
+                throw std::runtime_error("Shards of " + name + " overlap or are out of order.");
+            }
+            for (int i = 0; i < first->nx; i++) {
+                (*var->z)(i, j) = (*part->z)(i, jj);
+            }
+        }
+    }
+    return var;
+}
+
+void mergeShards(const std::vector<std::string>& shards, const std::string& database)
+{
+    HDF5Names H5Names;
+    if (shards.empty()) {
+        throw std::runtime_error("No shards to merge.");
+    }
+
+    Exception::dontPrint();
+    std::vector<std::unique_ptr<H5File>> files;
+    for (size_t k = 0; k < shards.size(); k++) {
+        try {
+            files.emplace_back(new H5File(shards[k], H5F_ACC_RDONLY));
+        } catch (const FileIException&) {
+            throw std::runtime_error("Could not open shard " + shards[k] + ".");
+        }
+    }
+
+    std::unique_ptr<H5File> output(openDatabase(database));
+    if (!output) {
+        throw std::runtime_error("Could not open database " + database + ".");
+    }
+    std::unique_ptr<Group> root(new Group(output->openGroup("/")));
+
+    std::unique_ptr<Group> first_root(new Group(files[0]->openGroup("/")));
+    for (hsize_t m = 0; m < first_root->getNumObjs(); m++) {
+        H5std_string mixture = first_root->getObjnameByIdx(m);
+        std::cout << "Merging " << shards.size() << " shards of " << mixture << std::endl;
+
+        // Order the shards by their first row and check that they tile the table.
+        std::vector<std::pair<int, Group*>> rows;
+        std::vector<std::unique_ptr<Group>> groups;
+        int total_rows = -1;
+        for (size_t k = 0; k < files.size(); k++) {
+            if (H5Lexists(files[k]->getId(), mixture.c_str(), H5P_DEFAULT) <= 0) {
+                throw std::runtime_error("Shard " + shards[k] + " is missing " + mixture + ".");
+            }
+            groups.emplace_back(new Group(files[k]->openGroup(mixture)));
+            Group* gas = groups.back().get();
+            if (!gas->attrExists(H5Names.first_row) || !gas->attrExists(H5Names.total_rows)) {
+                throw std::runtime_error(shards[k] + " is not a shard of " + mixture + ".");
+            }
+            int total = readIntAttribute(gas, H5Names.total_rows);
+            if (total_rows >= 0 && total != total_rows) {
+                throw std::runtime_error("Shards of " + mixture + " have different numbers of rows.");
+            }
+            total_rows = total;
+            rows.push_back(std::make_pair(readIntAttribute(gas, H5Names.first_row), gas));
+        }
+        std::sort(rows.begin(), rows.end(),
+                  [](const std::pair<int, Group*>& a, const std::pair<int, Group*>& b) {
+                      return a.first < b.first;
+                  });
+
+        std::vector<Group*> parts;
+        int next_row = 0;
+        for (size_t k = 0; k < rows.size(); k++) {
+            std::unique_ptr<TableEntry<double>> enthalpy(readTableEntry(rows[k].second, H5Names.enthalpy));
+            if (rows[k].first != next_row) {
+                throw std::runtime_error("Shards of " + mixture + " do not cover every pressure row.");
+            }
+            next_row += enthalpy->ny;
+            parts.push_back(rows[k].second);
+        }
+        if (next_row != total_rows) {
+            throw std::runtime_error("Shards of " + mixture + " do not cover every pressure row.");
+        }
+
+        // The shards carry the provenance of the whole table, which must be
+        // the same for all of them: shards of different runs do not merge.
+        TableProvenance provenance;
+        bool has_provenance = readProvenance(parts[0], provenance);
+        for (size_t k = 1; k < parts.size(); k++) {
+            TableProvenance other;
+            bool has_other = readProvenance(parts[k], other);
+            if (has_other != has_provenance || (has_other && !other.matches(provenance))) {
+                throw std::runtime_error("Shards of " + mixture + " were generated with different parameters.");
+            }
+        }
+
+        std::unique_ptr<Group> gas(replaceGroup(root.get(), mixture));
+        mergeGroups(parts, gas.get(), mixture);
+        writeRowAttributes(gas.get(), 0, total_rows);
+        if (has_provenance) writeProvenance(gas.get(), provenance);
+    }
+}
+
+} // namespace IcarusPyro
@@ -0,0 +1,56 @@
+#ifndef ICARUSPYRO_TABLE_MERGE_H
+#define ICARUSPYRO_TABLE_MERGE_H
+
+#include <string>
+#include <vector>
+
+#include "gas_table.h"
+#include "table_entry.h"
+
+namespace IcarusPyro {
+
+/**
+ * Mark the mixture group `gas_mixture_name` of a database as holding the 
+ * pressure rows first_row, ..., first_row + ny - 1 of a table with 
+ * total_rows rows. Every generated table records its rows, so a full-range 
+ * run is the single shard (0, total_rows).
+ */
+void writeShardInfo(const std::string& database, 
+                    const std::string& gas_mixture_name, 
+                    int first_row, 
+                    int total_rows);
+
+/**
+ * True if the mixture group `gas` holds only part of the pressure rows of 
+ * its table (see writeShardInfo), i.e. it still has to be merged.
+ */
+bool isShard(Group* gas);
+
+/**
+ * Join table entries along the y (pressure) axis. The parts must have the 
+ * same x axis, variables and scales, and be ordered so that the y values 
+ * increase strictly. Throws std::runtime_error otherwise. The caller owns the
+ * returned entry.
+ * 
+ * @param[in] parts Table entries in row order.
+ * @param[in] name Name of the property, used in error messages.
+ */
+TableEntry<double>* concatenateRows(const std::vector<TableEntry<double>*>& parts, 
+                                    const std::string& name);
+
+/**
+ * Assemble the shards written by sharded table generation into one database.
+ * Every mixture of the first shard is merged: the shards must contain the 
+ * same properties, with matching axes, attributes and provenance, and 
+ * together cover every pressure row exactly once. Throws std::runtime_error 
+ * otherwise. The merged mixtures replace any groups of the same name in 
+ * `database`.
+ * 
+ * @param[in] shards Database files of the shards, in any order.
+ * @param[in] database Name of the merged database file.
+ */
+void mergeShards(const std::vector<std::string>& shards, const std::string& database);
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,178 @@
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "memo_cache.h"
+#include "table_merge.h"
+#include "table_provenance.h"
+
+namespace IcarusPyro {
+
+namespace {
+
+void writeStringAttribute(Group* group, const H5std_string& name, const std::string& value)
+{
+    if (group->attrExists(name)) group->removeAttr(name);
+    StrType stype(PredType::C_S1, H5T_VARIABLE);
+    stype.setCset(H5T_CSET_ASCII);
+    Attribute attr = group->createAttribute(name, stype, DataSpace(H5S_SCALAR));
+    H5std_string buffer(value);
+    attr.write(stype, buffer);
+}
+
+void writeDoubleAttribute(Group* group, const H5std_string& name, const double* values, hsize_t n)
+{
+    if (group->attrExists(name)) group->removeAttr(name);
+    DataSpace space = (n == 1) ? DataSpace(H5S_SCALAR) : DataSpace(1, &n);
+    Attribute attr = group->createAttribute(name, PredType::NATIVE_DOUBLE, space);
+    attr.write(PredType::NATIVE_DOUBLE, values);
+}
+
+void writeIntAttribute(Group* group, const H5std_string& name, int value)
+{
+    if (group->attrExists(name)) group->removeAttr(name);
+    Attribute attr = group->createAttribute(name, PredType::NATIVE_INT, DataSpace(H5S_SCALAR));
+    attr.write(PredType::NATIVE_INT, &value);
+}
+
+std::string readStringAttribute(Group* group, const H5std_string& name)
+{
+    Attribute attr = group->openAttribute(name);
+    H5std_string buffer("");
+    attr.read(attr.getDataType(), buffer);
+    return buffer;
+}
+
+std::vector<double> readDoubleAttribute(Group* group, const H5std_string& name)
+{
+    Attribute attr = group->openAttribute(name);
+    std::vector<double> values(attr.getSpace().getSimpleExtentNpoints());
+    attr.read(PredType::NATIVE_DOUBLE, values.data());
+    return values;
+}
+
+int readIntAttribute(Group* group, const H5std_string& name)
+{
+    int value = 0;
+    Attribute attr = group->openAttribute(name);
+    attr.read(PredType::NATIVE_INT, &value);
+    return value;
+}
+
+} // namespace
+
+TableProvenance TableProvenance::make(const std::string& mixture,
+                                      const std::vector<double>& Xe,
+                                      const std::string& mu_algorithm,
+                                      const std::string& k_algorithm)
+{
+    TableProvenance provenance;
+    provenance.generation_key = MemoCache::makeKey(mixture, Xe, mu_algorithm, k_algorithm);
+    std::ostringstream hash;
+    hash << std::hex << std::setw(16) << std::setfill('0') << hashMixtureData(mixture);
+    provenance.mixture_hash = hash.str();
+    provenance.elemental_fractions = Xe;
+    provenance.viscosity_algorithm = mu_algorithm;
+    provenance.conductivity_algorithm = k_algorithm;
+    return provenance;
+}
+
+bool TableProvenance::matches(const TableProvenance& other) const
+{
+    return generation_key == other.generation_key &&
+           T_low == other.T_low && T_high == other.T_high && nT == other.nT && T_scale == other.T_scale &&
+           p_low == other.p_low && p_high == other.p_high && nP == other.nP && p_scale == other.p_scale &&
+           species_threshold == other.species_threshold;
+}
+
+void writeProvenance(Group* gas, const TableProvenance& provenance)
+{
+    HDF5Names H5Names;
+    writeStringAttribute(gas, H5Names.generation_key, provenance.generation_key);
+    writeStringAttribute(gas, H5Names.mixture_hash, provenance.mixture_hash);
+    writeDoubleAttribute(gas, H5Names.elemental_fractions, provenance.elemental_fractions.data(),
+                         provenance.elemental_fractions.size());
+    writeStringAttribute(gas, H5Names.viscosity_algorithm, provenance.viscosity_algorithm);
+    writeStringAttribute(gas, H5Names.conductivity_algorithm, provenance.conductivity_algorithm);
+
+    double T_range[2] = {provenance.T_low, provenance.T_high};
+    double p_range[2] = {provenance.p_low, provenance.p_high};
+    writeDoubleAttribute(gas, H5Names.temperature_range, T_range, 2);
+    writeIntAttribute(gas, H5Names.temperature_points, provenance.nT);
+    writeStringAttribute(gas, H5Names.temperature_scale, provenance.T_scale);
+    writeDoubleAttribute(gas, H5Names.pressure_range, p_range, 2);
+    writeIntAttribute(gas, H5Names.pressure_points, provenance.nP);
+    writeStringAttribute(gas, H5Names.pressure_scale, provenance.p_scale);
+    writeDoubleAttribute(gas, H5Names.species_threshold, &provenance.species_threshold, 1);
+}
+
+bool readProvenance(Group* gas, TableProvenance& provenance)
+{
+    HDF5Names H5Names;
+    if (!gas->attrExists(H5Names.generation_key)) return false;
+
+    provenance.generation_key = readStringAttribute(gas, H5Names.generation_key);
+    provenance.mixture_hash = readStringAttribute(gas, H5Names.mixture_hash);
+    provenance.elemental_fractions = readDoubleAttribute(gas, H5Names.elemental_fractions);
+    provenance.viscosity_algorithm = readStringAttribute(gas, H5Names.viscosity_algorithm);
+    provenance.conductivity_algorithm = readStringAttribute(gas, H5Names.conductivity_algorithm);
+
+    std::vector<double> T_range = readDoubleAttribute(gas, H5Names.temperature_range);
+    std::vector<double> p_range = readDoubleAttribute(gas, H5Names.pressure_range);
+    if (T_range.size() != 2 || p_range.size() != 2) {
+        throw std::runtime_error("Invalid provenance ranges of " + gas->getObjName() + ".");
+    }
+    provenance.T_low = T_range[0];
+    provenance.T_high = T_range[1];
+    provenance.nT = readIntAttribute(gas, H5Names.temperature_points);
+    provenance.T_scale = readStringAttribute(gas, H5Names.temperature_scale);
+    provenance.p_low = p_range[0];
+    provenance.p_high = p_range[1];
+    provenance.nP = readIntAttribute(gas, H5Names.pressure_points);
+    provenance.p_scale = readStringAttribute(gas, H5Names.pressure_scale);
+    provenance.species_threshold = readDoubleAttribute(gas, H5Names.species_threshold)[0];
+    return true;
+}
+
+void writeProvenance(const std::string& database,
+                     const std::string& gas_mixture_name,
+                     const TableProvenance& provenance)
+{
+    std::unique_ptr<H5File> file(openDatabase(database));
+    if (!file) {
+        throw std::runtime_error("Could not open database " + database + ".");
+    }
+    std::unique_ptr<Group> gas(new Group(file->openGroup(gas_mixture_name)));
+    writeProvenance(gas.get(), provenance);
+}
+
+bool tableUpToDate(const std::string& database,
+                   const std::string& gas_mixture_name,
+                   const TableProvenance& provenance)
+{
+    // A missing database is an expected answer, not an error to report, but
+    // the caller's HDF5 error printing is left as it was.
+    H5E_auto2_t print_function;
+    void* print_data;
+    Exception::getAutoPrint(print_function, &print_data);
+    std::unique_ptr<H5File> file;
+    try {
+        Exception::dontPrint();
+        file.reset(new H5File(database, H5F_ACC_RDONLY));
+    } catch (const FileIException&) {
+        Exception::setAutoPrint(print_function, print_data);
+        return false;
+    }
+    Exception::setAutoPrint(print_function, print_data);
+    if (H5Lexists(file->getId(), gas_mixture_name.c_str(), H5P_DEFAULT) <= 0) return false;
+    std::unique_ptr<Group> gas(new Group(file->openGroup(gas_mixture_name)));
+    if (isShard(gas.get())) return false;
+
+    TableProvenance stored;
+    return readProvenance(gas.get(), stored) && stored.matches(provenance);
+}
+
+} // namespace IcarusPyro
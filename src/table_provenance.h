@@ -0,0 +1,84 @@
+#ifndef ICARUSPYRO_TABLE_PROVENANCE_H
+#define ICARUSPYRO_TABLE_PROVENANCE_H
+
+#include <string>
+#include <vector>
+
+#include "gas_table.h"
+
+namespace IcarusPyro {
+
+/**
+ * Parameters a gas table was generated with, stored as attributes of its
+ * mixture group so that tools can tell whether a database still holds the
+ * table a run asks for.
+ */
+struct TableProvenance {
+    /** Hash of the mixture file, composition and algorithms, see MemoCache::makeKey. */
+    std::string generation_key;
+    /** Hex digest of the Mutation++ mixture file and databases, see hashMixtureData. */
+    std::string mixture_hash;
+    std::vector<double> elemental_fractions;
+    std::string viscosity_algorithm;
+    std::string conductivity_algorithm;
+    double T_low = 0.0;
+    double T_high = 0.0;
+    int nT = 0;
+    std::string T_scale;
+    double p_low = 0.0;
+    double p_high = 0.0;
+    int nP = 0;
+    std::string p_scale;
+    double species_threshold = -1.0;
+
+    /**
+     * Provenance of a table of `mixture` with elemental mole fractions Xe.
+     * The grid is set by the caller. Throws std::runtime_error if the 
+     * mixture file cannot be found, see mixtureFilePath.
+     */
+    static TableProvenance make(const std::string& mixture,
+                                const std::vector<double>& Xe,
+                                const std::string& mu_algorithm,
+                                const std::string& k_algorithm);
+
+    /**
+     * True if a table of this provenance is the one `other` asks for: the
+     * same generation key, grid and species threshold. The remaining fields
+     * are covered by the key and stored for the reader.
+     */
+    bool matches(const TableProvenance& other) const;
+};
+
+/**
+ * Write the provenance attributes of the mixture group `gas`, replacing any
+ * existing ones.
+ */
+void writeProvenance(Group* gas, const TableProvenance& provenance);
+
+/**
+ * Read the provenance attributes of the mixture group `gas`.
+ *
+ * @return False if the group has none, e.g. it was written before they were
+ *     recorded.
+ */
+bool readProvenance(Group* gas, TableProvenance& provenance);
+
+/**
+ * Write the provenance of the mixture `gas_mixture_name` of a database.
+ */
+void writeProvenance(const std::string& database,
+                     const std::string& gas_mixture_name,
+                     const TableProvenance& provenance);
+
+/**
+ * True if the database holds a complete table (not a shard) of the mixture
+ * `gas_mixture_name` whose provenance matches `provenance`. False if the
+ * file, the mixture or its provenance do not exist.
+ */
+bool tableUpToDate(const std::string& database,
+                   const std::string& gas_mixture_name,
+                   const TableProvenance& provenance);
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "table_resample.h"
+
+namespace IcarusPyro {
+
+namespace {
+
+// Stencil of (up to) four nodes of the axis v[0..n) around p, in the scale
+// of the axis: the coordinates u[0..m) of the nodes, the cell c of p within
+// them and the coordinate up of p. Returns the first node of the stencil.
+int hermiteStencil(const double* v, int n, bool log_scale, double p, int& m, double u[4], int& c, double& up)
+{
+    p = std::min(std::max(p, v[0]), v[n-1]);
+    int k;
+    double w, dw;
+    TableEntry<double>::locateAxis(v, n, log_scale, p, k, w, dw);
+    m = std::min(n, 4);
+    int first = std::min(std::max(k - 1, 0), n - m);
+    c = k - first;
+    for (int a = 0; a < m; a++) u[a] = log_scale ? std::log10(v[first + a]) : v[first + a];
+    up = log_scale ? std::log10(p) : p;
+    return first;
+}
+
+// Slope at a node between secants s0 and s1 over intervals h0 and h1: the 
+// weighted harmonic mean of Fritsch and Butland, zero where the data turn so
+// that the interpolant does not overshoot.
+double hermiteSlope(double s0, double s1, double h0, double h1)
+{
+    if (s0 * s1 <= 0.0) return 0.0;
+    double w0 = 2.0 * h1 + h0;
+    double w1 = h1 + 2.0 * h0;
+    return (w0 + w1) / (w0 / s0 + w1 / s1);
+}
+
+// Monotone cubic Hermite interpolation at up within cell c of the stencil.
+double hermite(const double* u, const double* f, int m, int c, double up)
+{
+    if (m < 2) return f[0];
+    double h = u[c+1] - u[c];
+    double s = (f[c+1] - f[c]) / h;
+    double d0 = (c > 0) ? hermiteSlope((f[c] - f[c-1]) / (u[c] - u[c-1]), s, u[c] - u[c-1], h) : s;
+    double d1 = (c + 2 < m) ? hermiteSlope(s, (f[c+2] - f[c+1]) / (u[c+2] - u[c+1]), h, u[c+2] - u[c+1]) : s;
+    double t = (up - u[c]) / h;
+    double t2 = t * t;
+    double t3 = t2 * t;
+    return (2.0 * t3 - 3.0 * t2 + 1.0) * f[c] + (t3 - 2.0 * t2 + t) * h * d0
+         + (-2.0 * t3 + 3.0 * t2) * f[c+1] + (t3 - t2) * h * d1;
+}
+
+// Source nodes along an axis within [low, high], to round-off of the ends
+// (e.g. of a log10 range recomputed by makeRange).
+std::vector<double> checkPoints(const double* v, int n, double low, double high)
+{
+    double slack = 1.0e-12 * std::max(std::abs(low), std::abs(high));
+    std::vector<double> inside;
+    for (int k = 0; k < n; k++) {
+        if (v[k] >= low - slack && v[k] <= high + slack) inside.push_back(v[k]);
+    }
+    return inside;
+}
+
+// Tables on other axes, e.g. the cp and cv of legacy databases tabulated in
+// energy and density, and empty placeholders are not resampled.
+bool resampled(const TableEntry<double>* var)
+{
+    return var && var->nx > 1 && var->ny > 1 &&
+           var->x_variable == "temperature" && var->y_variable == "pressure";
+}
+
+} // namespace
+
+int powerOfTwoPoints(int n)
+{
+    int cells = 1;
+    while (cells + 1 < n) cells *= 2;
+    return cells + 1;
+}
+
+double cubicInterpolate(const TableEntry<double>& table, double x, double y)
+{
+    int mx, my, cx, cy;
+    double ux[4], uy[4], upx, upy;
+    int i0 = hermiteStencil(table.x, table.nx, table.x_scale == "log10", x, mx, ux, cx, upx);
+    int j0 = hermiteStencil(table.y, table.ny, table.y_scale == "log10", y, my, uy, cy, upy);
+    double rows[4];
+    for (int a = 0; a < mx; a++) {
+        double f[4];
+        for (int b = 0; b < my; b++) f[b] = (*table.z)(i0 + a, j0 + b);
+        rows[a] = hermite(uy, f, my, cy, upy);
+    }
+    return hermite(ux, rows, mx, cx, upx);
+}
+
+TableEntry<double>* resampleEntry(const TableEntry<double>& source,
+                                  const std::vector<double>& x, const std::string& x_scale,
+                                  const std::vector<double>& y, const std::string& y_scale)
+{
+    if (x.size() < 2 || y.size() < 2) {
+        throw std::runtime_error("Resampled axes need at least two points.");
+    }
+    TableEntry<double>* var = new TableEntry<double>(x.size(), y.size(), source.x_variable, source.y_variable,
+                                                     x_scale, y_scale);
+    std::copy(x.begin(), x.end(), var->x);
+    std::copy(y.begin(), y.end(), var->y);
+    for (int i = 0; i < var->nx; i++) {
+        for (int j = 0; j < var->ny; j++) (*var->z)(i, j) = cubicInterpolate(source, x[i], y[j]);
+    }
+    var->detectUniformAxes();
+    return var;
+}
+
+GasTable resampleTable(const GasTable& source,
+                       const std::vector<double>& temperature, const std::string& T_scale,
+                       const std::vector<double>& pressure, const std::string& p_scale,
+                       ValidationReport& report)
+{
+    if (!resampled(source.enthalpy)) {
+        throw std::runtime_error("The gas table of " + source.pyrolysis_gas + " has no enthalpy table.");
+    }
+
+    const char* names[] = {"cp", "cv", "eint", "enthalpy", "mw", "density",
+                           "viscosity", "conductivity", "reactive_conductivity"};
+    const char* entry_names[] = {"cp", "cv", "internal_energy", "enthalpy", "molecular_weight", "density",
+                                 "viscosity", "conductivity", "reactive_conductivity"};
+    const TableEntry<double>* entries[] = {source.cp, source.cv, source.eint, source.enthalpy, source.mw,
+                                           source.density, source.viscosity, source.conductivity,
+                                           source.reactive_conductivity};
+
+    GasTable table(source.pyrolysis_gas);
+    for (size_t s = 0; s < source.species.size(); s++) {
+        const TableEntry<double>* var = source.species[s];
+        table.species_names.push_back(source.species_names[s]);
+        table.species.push_back(resampled(var) ? resampleEntry(*var, temperature, T_scale, pressure, p_scale)
+                                               : new TableEntry<double>(*var));
+    }
+
+    report.points = 0;
+    report.properties.clear();
+    for (int k = 0; k < 9; k++) {
+        const TableEntry<double>* var = entries[k];
+        if (!var) continue;
+        if (!resampled(var)) {
+            table.setEntry(entry_names[k], new TableEntry<double>(*var));
+            continue;
+        }
+        TableEntry<double>* target = resampleEntry(*var, temperature, T_scale, pressure, p_scale);
+        table.setEntry(entry_names[k], target);
+
+        std::vector<double> xs = checkPoints(var->x, var->nx, temperature.front(), temperature.back());
+        std::vector<double> ys = checkPoints(var->y, var->ny, pressure.front(), pressure.back());
+        if (xs.empty() || ys.empty()) continue;
+        int first_x = std::lower_bound(var->x, var->x + var->nx, xs.front()) - var->x;
+        int first_y = std::lower_bound(var->y, var->y + var->ny, ys.front()) - var->y;
+        std::vector<std::pair<double, double>> points;
+        std::vector<double> values, references;
+        for (size_t j = 0; j < ys.size(); j++) {
+            for (size_t i = 0; i < xs.size(); i++) {
+                points.push_back(std::make_pair(xs[i], ys[j]));
+                values.push_back(target->interpolate(xs[i], ys[j]));
+                references.push_back((*var->z)(i + first_x, j + first_y));
+            }
+        }
+        report.points = std::max(report.points, static_cast<int>(points.size()));
+        report.properties.push_back(compareTables(names[k], points, values.data(), references.data(),
+                                                  errorFloor(*var)));
+    }
+    table.compactSpecies();
+    return table;
+}
+
+} // namespace IcarusPyro
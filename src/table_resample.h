@@ -0,0 +1,51 @@
+#ifndef ICARUSPYRO_TABLE_RESAMPLE_H
+#define ICARUSPYRO_TABLE_RESAMPLE_H
+
+#include <string>
+#include <vector>
+
+#include "gas_table.h"
+#include "table_validation.h"
+
+namespace IcarusPyro {
+
+/**
+ * Smallest number of points 2^k + 1 (i.e. 2^k cells) at least n.
+ */
+int powerOfTwoPoints(int n);
+
+/**
+ * Interpolate a table at (x, y) with tensor-product monotone piecewise cubic
+ * Hermite polynomials (Fritsch-Butland slopes) in the scale of each axis
+ * (linear, or log10). Unlike cubic Lagrange interpolation it does not ring
+ * across steep changes, e.g. of a density spanning decades over a coarse
+ * pressure axis. Exact at the nodes and for data linear in the scale of the
+ * axes; points outside of the table are clamped.
+ */
+double cubicInterpolate(const TableEntry<double>& table, double x, double y);
+
+/**
+ * Resample a table onto the axes x and y with cubicInterpolate.
+ */
+TableEntry<double>* resampleEntry(const TableEntry<double>& source,
+                                  const std::vector<double>& x, const std::string& x_scale,
+                                  const std::vector<double>& y, const std::string& y_scale);
+
+/**
+ * Resample every temperature and pressure table of a gas table, including the
+ * species tables, onto new axes, e.g. uniform ones on which lookups locate
+ * cells without searching (see TableEntry::detectUniformAxes). Tables on other
+ * axes and empty placeholders of missing properties are copied as they are.
+ *
+ * @param[out] report Error of each resampled property, looked up as in the
+ *     solver, relative to the source data at the source nodes within the new
+ *     range. The printed "reference" is the source value.
+ */
+GasTable resampleTable(const GasTable& source,
+                       const std::vector<double>& temperature, const std::string& T_scale,
+                       const std::vector<double>& pressure, const std::string& p_scale,
+                       ValidationReport& report);
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <unordered_map>
+
+#include "table_stats.h"
+
+namespace IcarusPyro { 
+
+namespace { 
+
+std::atomic<uint64_t> next_stats_id(1);
+
+// Counters of the calling thread, by stats id. The slots co-own the counters:
+// once a thread holds the last reference, the table is gone.
+std::unordered_map<uint64_t, std::shared_ptr<LookupCounters>>& threadSlots()
+{
+    thread_local std::unordered_map<uint64_t, std::shared_ptr<LookupCounters>> slots;
+    return slots;
+}
+
+void writeArray(std::ostream& out, const std::vector<double>& v)
+{
+    out << "[";
+    for (size_t k = 0; k < v.size(); k++) { 
+        out << (k ? ", " : "") << v[k];
+    }
+    out << "]";
+}
+
+} // namespace
+
+TableStats::TableStats(const std::vector<double>& x, const std::vector<double>& y, int max_bins)
+    : x(x), 
+      y(y),
+      id(next_stats_id++)
+{
+    makeBins(static_cast<int>(x.size()), max_bins, n_bins_x, bin_x);
+    makeBins(static_cast<int>(y.size()), max_bins, n_bins_y, bin_y);
+}
+
+void TableStats::makeBins(int n, int max_bins, int& n_bins, std::vector<int>& bins)
+{
+    // The cells of an axis of n points are 0, ..., n - 2 (0 when n < 2).
+    int n_cells = std::max(n - 1, 1);
+    n_bins = std::max(std::min(n_cells, max_bins), 1);
+    bins.resize(n_cells);
+    for (int i = 0; i < n_cells; i++) { 
+        bins[i] = static_cast<int>(static_cast<long>(i) * n_bins / n_cells);
+    }
+}
+
+LookupCounters& TableStats::local()
+{
+    // Stats objects are identified by a unique id rather than their address,
+    // so a new table never picks up the counters of a destroyed one. The 
+    // slots of destroyed tables are dropped before a new one is added.
+    std::unordered_map<uint64_t, std::shared_ptr<LookupCounters>>& slots = threadSlots();
+    auto it = slots.find(id);
+    if (it != slots.end()) return *it->second;
+
+    for (auto slot = slots.begin(); slot != slots.end(); ) { 
+        if (slot->second.use_count() == 1) slot = slots.erase(slot);
+        else ++slot;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.emplace_back(std::make_shared<LookupCounters>(static_cast<size_t>(n_bins_x) * n_bins_y));
+    slots[id] = threads.back();
+    return *threads.back();
+}
+
+size_t TableStats::threadTables()
+{
+    return threadSlots().size();
+}
+
+LookupCounters TableStats::total() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    LookupCounters sum(static_cast<size_t>(n_bins_x) * n_bins_y);
+    for (size_t t = 0; t < threads.size(); t++) sum.add(*threads[t]);
+    return sum;
+}
+
+void TableStats::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t t = 0; t < threads.size(); t++) threads[t]->clear();
+}
+
+void TableStats::writeJson(std::ostream& out, 
+                           const std::string& x_variable, 
+                           const std::string& y_variable) const
+{
+    LookupCounters sum = total();
+    size_t n_threads;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        n_threads = threads.size();
+    }
+
+    // Axis values at the edges of the bins.
+    auto edges = [](const std::vector<double>& v, const std::vector<int>& bins) { 
+        std::vector<double> e;
+        if (v.empty()) return e;
+        e.push_back(v.front());
+        for (size_t i = 1; i < bins.size(); i++) { 
+            if (bins[i] != bins[i-1]) e.push_back(v[i]);
+        }
+        e.push_back(v.back());
+        return e;
+    };
+
+    out << std::setprecision(10);
+    out << "{\n";
+    out << "  \"threads\": " << n_threads << ",\n";
+    out << "  \"lookups\": " << sum.lookups << ",\n";
+    out << "  \"fallbacks\": " << sum.fallbacks << ",\n";
+    out << "  \"clamps\": {\n";
+    out << "    \"" << x_variable << "\": {\"below\": " << sum.x_below << ", \"above\": " << sum.x_above << "},\n";
+    out << "    \"" << y_variable << "\": {\"below\": " << sum.y_below << ", \"above\": " << sum.y_above << "}\n";
+    out << "  },\n";
+    out << "  \"histogram\": {\n";
+    out << "    \"" << x_variable << "_edges\": ";
+    writeArray(out, edges(x, bin_x));
+    out << ",\n";
+    out << "    \"" << y_variable << "_edges\": ";
+    writeArray(out, edges(y, bin_y));
+    out << ",\n";
+    out << "    \"counts\": [";
+    for (int bx = 0; bx < n_bins_x; bx++) { 
+        out << (bx ? ",\n               [" : "\n               [");
+        for (int by = 0; by < n_bins_y; by++) { 
+            out << (by ? ", " : "") << sum.cells[static_cast<size_t>(bx) * n_bins_y + by];
+        }
+        out << "]";
+    }
+    out << "]\n";
+    out << "  }\n";
+    out << "}\n";
+}
+
+} // namespace IcarusPyro
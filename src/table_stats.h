@@ -0,0 +1,186 @@
+#ifndef ICARUSPYRO_TABLE_STATS_H
+#define ICARUSPYRO_TABLE_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "table_entry.h"
+
+/**
+ * Instrumentation of the gas table lookups is compiled in only when 
+ * ICARUSPYRO_INSTRUMENT is defined (CMake option IcarusPyro_WITH_INSTRUMENTATION).
+ * Otherwise ICARUSPYRO_RECORD discards its argument and the lookup path is 
+ * unchanged.
+ */
+#ifdef ICARUSPYRO_INSTRUMENT
+#define ICARUSPYRO_RECORD(...) __VA_ARGS__
+#else
+#define ICARUSPYRO_RECORD(...)
+#endif
+
+namespace IcarusPyro {
+
+/**
+ * Usage counters of a gas table. Clamps count the lookups below or above the
+ * range of each axis; `cells` is a coarse (x-major) histogram of the table 
+ * cells that were looked up.
+ * 
+ * The counters are atomic so that total() and reset() may run while other 
+ * threads record. Each thread only adds to its own counters, so relaxed 
+ * increments suffice; a copy is a snapshot of the counts.
+ */
+struct LookupCounters { 
+    std::atomic<uint64_t> lookups;
+    std::atomic<uint64_t> fallbacks;
+    std::atomic<uint64_t> x_below, x_above;
+    std::atomic<uint64_t> y_below, y_above;
+    std::vector<std::atomic<uint64_t>> cells;
+
+    explicit LookupCounters(size_t n_bins = 0) 
+        : lookups(0), fallbacks(0), x_below(0), x_above(0), y_below(0), y_above(0), cells(n_bins) { 
+        clear();
+    }
+
+    LookupCounters(const LookupCounters& rhs) : LookupCounters(rhs.cells.size()) { 
+        add(rhs);
+    }
+
+    LookupCounters& operator=(const LookupCounters& rhs) { 
+        if (this != &rhs) { 
+            std::vector<std::atomic<uint64_t>> bins(rhs.cells.size());
+            cells.swap(bins);
+            clear();
+            add(rhs);
+        }
+        return *this;
+    }
+
+    /**
+     * Add the counts of `rhs`, which has as many cells.
+     */
+    void add(const LookupCounters& rhs) { 
+        increment(lookups, load(rhs.lookups));
+        increment(fallbacks, load(rhs.fallbacks));
+        increment(x_below, load(rhs.x_below));
+        increment(x_above, load(rhs.x_above));
+        increment(y_below, load(rhs.y_below));
+        increment(y_above, load(rhs.y_above));
+        for (size_t b = 0; b < cells.size(); b++) increment(cells[b], load(rhs.cells[b]));
+    }
+
+    /**
+     * Zero the counts.
+     */
+    void clear() { 
+        for (std::atomic<uint64_t>* c : {&lookups, &fallbacks, &x_below, &x_above, &y_below, &y_above}) { 
+            c->store(0, std::memory_order_relaxed);
+        }
+        for (size_t b = 0; b < cells.size(); b++) cells[b].store(0, std::memory_order_relaxed);
+    }
+
+    static void increment(std::atomic<uint64_t>& counter, uint64_t n = 1) { 
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    static uint64_t load(const std::atomic<uint64_t>& counter) { 
+        return counter.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Per-thread lookup statistics of a table. 
+ * 
+ * Every thread records into its own counters, so recording takes no lock 
+ * (except once, the first time a thread records); total() sums the threads.
+ * The counters are shared by the table and the recording thread, so neither
+ * outlives them; a thread drops the counters of destroyed tables the next 
+ * time it records into a new one.
+ * The cells of the table are grouped into at most max_bins bins along each 
+ * axis for the histogram.
+ */
+class TableStats { 
+public:
+    /**
+     * @param[in] x, y Axes of the table.
+     * @param[in] max_bins Maximum number of histogram bins per axis.
+     */
+    TableStats(const std::vector<double>& x, const std::vector<double>& y, int max_bins = 32);
+
+    TableStats(const TableStats&) = delete;
+    TableStats& operator=(const TableStats&) = delete;
+
+    /**
+     * Record a lookup of the point (xp, yp) located in the cell of `idx`.
+     */
+    void recordLookup(double xp, double yp, const TableIndex& idx) { 
+        LookupCounters& c = local();
+        LookupCounters::increment(c.lookups);
+        if (xp < x.front()) LookupCounters::increment(c.x_below);
+        else if (xp > x.back()) LookupCounters::increment(c.x_above);
+        if (yp < y.front()) LookupCounters::increment(c.y_below);
+        else if (yp > y.back()) LookupCounters::increment(c.y_above);
+        LookupCounters::increment(c.cells[bin_x[idx.i] * n_bins_y + bin_y[idx.j]]);
+    }
+
+    /**
+     * Record a lookup sent to the table fallback.
+     */
+    void recordFallback() { 
+        LookupCounters::increment(local().fallbacks);
+    }
+
+    /**
+     * Sum of the counters of every thread.
+     */
+    LookupCounters total() const;
+
+    /**
+     * Zero the counters. Lookups in flight may or may not be counted.
+     */
+    void reset();
+
+    /**
+     * Write the totals, the clamp counts and the histogram (with the axis 
+     * values at the bin edges) as JSON.
+     * 
+     * @param[in] x_variable, y_variable Names of the axes in the output.
+     */
+    void writeJson(std::ostream& out, 
+                   const std::string& x_variable = "temperature", 
+                   const std::string& y_variable = "pressure") const;
+
+    bool sameAxes(const std::vector<double>& xv, const std::vector<double>& yv) const { 
+        return xv == x && yv == y;
+    }
+
+    /**
+     * Number of tables whose counters the calling thread holds, including 
+     * destroyed tables not yet dropped.
+     */
+    static size_t threadTables();
+
+    int binsX() const { return n_bins_x; }
+
+    int binsY() const { return n_bins_y; }
+
+private:
+    std::vector<double> x, y;
+    int n_bins_x, n_bins_y;
+    std::vector<int> bin_x, bin_y;
+    uint64_t id;
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<LookupCounters>> threads;
+
+    LookupCounters& local();
+
+    static void makeBins(int n, int max_bins, int& n_bins, std::vector<int>& bins);
+};
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+#include "parallel.h"
+#include "pyrolysis_gas.h"
+#include "table_validation.h"
+
+namespace IcarusPyro {
+
+namespace {
+
+// Fraction of the largest tabulated value below which the reference value is
+// not used as the scale of the relative error.
+const double ERROR_FLOOR = 1.0e-6;
+
+/**
+ * Midpoints of the intervals of an axis, or its single value.
+ */
+std::vector<double> midpoints(const double* v, int n, bool log_scale)
+{
+    std::vector<double> mid;
+    if (n == 1) mid.push_back(v[0]);
+    for (int k = 0; k + 1 < n; k++) {
+        mid.push_back(log_scale ? std::sqrt(v[k] * v[k+1]) : 0.5 * (v[k] + v[k+1]));
+    }
+    return mid;
+}
+
+double sample(std::mt19937& generator, double low, double high, bool log_scale)
+{
+    if (log_scale) {
+        std::uniform_real_distribution<double> u(std::log10(low), std::log10(high));
+        return std::pow(10.0, u(generator));
+    }
+    std::uniform_real_distribution<double> u(low, high);
+    return u(generator);
+}
+
+} // namespace
+
+double errorFloor(const TableEntry<double>& table)
+{
+    double largest = 0.0;
+    for (int j = 0; j < table.ny; j++) {
+        for (int i = 0; i < table.nx; i++) largest = std::max(largest, std::abs((*table.z)(i, j)));
+    }
+    return ERROR_FLOOR * largest;
+}
+
+PropertyError compareTables(const std::string& name,
+                            const std::vector<std::pair<double, double>>& points,
+                            const double* values,
+                            const double* references,
+                            double floor)
+{
+    PropertyError e = {name, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    size_t n_points = points.size();
+    double sum = 0.0;
+    for (size_t n = 0; n < n_points; n++) {
+        double value = values[n];
+        double reference = references[n];
+        double error = (value == reference) ? 0.0
+                     : std::abs(value - reference) / std::max(std::abs(reference), floor);
+        sum += error * error;
+        if (error > e.max_error || n == 0) {
+            e.max_error = error;
+            e.worst_temperature = points[n].first;
+            e.worst_pressure = points[n].second;
+            e.worst_table = value;
+            e.worst_reference = reference;
+        }
+    }
+    e.rms_error = (n_points > 0) ? std::sqrt(sum / n_points) : 0.0;
+    return e;
+}
+
+bool ValidationReport::passed(double tolerance) const
+{
+    for (size_t k = 0; k < properties.size(); k++) {
+        if (!(properties[k].max_error <= tolerance)) return false;
+    }
+    return true;
+}
+
+void ValidationReport::print(std::ostream& out, double tolerance) const
+{
+    out << "Validated " << properties.size() << " properties at " << points << " points" << std::endl;
+    out << std::left << std::setw(24) << "property"
+        << std::right << std::setw(12) << "max" << std::setw(12) << "rms"
+        << std::setw(12) << "T" << std::setw(14) << "p"
+        << std::setw(15) << "table" << std::setw(15) << "reference" << std::endl;
+    for (size_t k = 0; k < properties.size(); k++) {
+        const PropertyError& e = properties[k];
+        out << std::left << std::setw(24) << e.name << std::right << std::scientific << std::setprecision(3)
+            << std::setw(12) << e.max_error << std::setw(12) << e.rms_error
+            << std::fixed << std::setprecision(2) << std::setw(12) << e.worst_temperature
+            << std::scientific << std::setprecision(4) << std::setw(14) << e.worst_pressure
+            << std::setprecision(6) << std::setw(15) << e.worst_table << std::setw(15) << e.worst_reference
+            << (e.max_error <= tolerance ? "" : "  FAIL") << std::endl;
+        out.unsetf(std::ios::floatfield);
+    }
+}
+
+std::vector<std::pair<double, double>> validationPoints(const TableEntry<double>& table,
+                                                        int n_random,
+                                                        unsigned seed)
+{
+    bool x_log = (table.x_scale == "log10");
+    bool y_log = (table.y_scale == "log10");
+    std::vector<double> x_mid = midpoints(table.x, table.nx, x_log);
+    std::vector<double> y_mid = midpoints(table.y, table.ny, y_log);
+
+    std::vector<std::pair<double, double>> points;
+    points.reserve(x_mid.size() * y_mid.size() + std::max(n_random, 0));
+    for (size_t j = 0; j < y_mid.size(); j++) {
+        for (size_t i = 0; i < x_mid.size(); i++) {
+            points.push_back(std::make_pair(x_mid[i], y_mid[j]));
+        }
+    }
+
+    std::mt19937 generator(seed);
+    for (int k = 0; k < n_random; k++) {
+        double x = sample(generator, table.x[0], table.x[table.nx-1], x_log);
+        double y = sample(generator, table.y[0], table.y[table.ny-1], y_log);
+        points.push_back(std::make_pair(x, y));
+    }
+    return points;
+}
+
+ValidationReport validateTable(const GasTable& table,
+                               const std::string& mixture,
+                               const std::string& mu_algorithm,
+                               const std::string& k_algorithm,
+                               int n_random,
+                               int n_threads,
+                               unsigned seed)
+{
+    if (!table.enthalpy || table.enthalpy->nx < 2) {
+        throw std::runtime_error("The gas table of " + table.pyrolysis_gas + " has no enthalpy table.");
+    }
+
+    const char* names[] = {"cp", "cv", "eint", "enthalpy", "mw", "density",
+                           "viscosity", "conductivity", "reactive_conductivity"};
+    const TableEntry<double>* entries[] = {table.cp, table.cv, table.eint, table.enthalpy, table.mw,
+                                           table.density, table.viscosity, table.conductivity,
+                                           table.reactive_conductivity};
+    double GasProperties::* members[] = {&GasProperties::cp, &GasProperties::cv, &GasProperties::eint,
+                                         &GasProperties::enthalpy, &GasProperties::mw,
+                                         &GasProperties::density, &GasProperties::viscosity,
+                                         &GasProperties::conductivity,
+                                         &GasProperties::reactive_conductivity};
+
+    // Tables on other axes, e.g. imported from a legacy database, and empty
+    // placeholders of missing properties are skipped.
+    std::vector<int> validated;
+    std::vector<double> floors;
+    for (int k = 0; k < 9; k++) {
+        const TableEntry<double>* var = entries[k];
+        if (!var || var->nx < 2 || var->x_variable != "temperature" || var->y_variable != "pressure") {
+            continue;
+        }
+        validated.push_back(k);
+        floors.push_back(errorFloor(*var));
+    }
+
+    std::vector<std::pair<double, double>> points = validationPoints(*table.enthalpy, n_random, seed);
+    int n_points = points.size();
+    size_t n_props = validated.size();
+    std::vector<double> table_values(n_points * n_props);
+    std::vector<double> reference_values(n_points * n_props);
+
+    // As in GasMixture::generateRows, each thread gets its own Mutation++
+    // objects, created serially before the threads start.
+    int nthreads = std::min(numThreads(n_threads), std::max(n_points, 1));
+    std::vector<std::unique_ptr<Mutation::Thermodynamics::Thermodynamics>> thermos;
+    std::vector<std::unique_ptr<Mutation::Transport::Transport>> transports;
+    for (int t = 0; t < nthreads; t++) {
+        Mutation::Thermodynamics::Thermodynamics* th(nullptr);
+        Mutation::Transport::Transport* tr(nullptr);
+        createMutation(mixture, mu_algorithm, k_algorithm, th, tr);
+        thermos.emplace_back(th);
+        transports.emplace_back(tr);
+    }
+    std::vector<double> Xe = pyrolysisElementFractions(*thermos[0]);
+
+    parallelFor(n_points, nthreads, [&](int t, int n) {
+        double T = points[n].first;
+        double p = points[n].second;
+        GasProperties props;
+        equilibriumProperties(*thermos[t], *transports[t], T, p, Xe.data(), props);
+        for (size_t m = 0; m < n_props; m++) {
+            int k = validated[m];
+            table_values[m * n_points + n] = entries[k]->interpolate(T, p);
+            reference_values[m * n_points + n] = props.*members[k];
+        }
+    });
+
+    ValidationReport report;
+    report.points = n_points;
+    for (size_t m = 0; m < n_props; m++) {
+        report.properties.push_back(compareTables(names[validated[m]], points,
+                                                  &table_values[m * n_points],
+                                                  &reference_values[m * n_points], floors[m]));
+    }
+    return report;
+}
+
+} // namespace IcarusPyro
@@ -0,0 +1,104 @@
+#ifndef ICARUSPYRO_TABLE_VALIDATION_H
+#define ICARUSPYRO_TABLE_VALIDATION_H
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gas_table.h"
+
+namespace IcarusPyro {
+
+/**
+ * Interpolation error of one property over the validation points.
+ *
+ * The relative error of a point is |table - reference| / max(|reference|,
+ * floor), where the floor is a small fraction of the largest tabulated value
+ * so that properties crossing zero (e.g. the enthalpy) are not dominated by
+ * points where the reference vanishes.
+ */
+struct PropertyError {
+    std::string name;
+    double max_error;
+    double rms_error;
+    double worst_temperature;
+    double worst_pressure;
+    double worst_table;
+    double worst_reference;
+};
+
+/**
+ * Accuracy of a gas table against direct equilibrium calculations.
+ */
+struct ValidationReport {
+    int points;
+    std::vector<PropertyError> properties;
+
+    /**
+     * True if the maximum relative error of every property is within
+     * `tolerance`.
+     */
+    bool passed(double tolerance) const;
+
+    /**
+     * Print a table of the maximum and RMS errors and of the worst point of
+     * each property, marking those above `tolerance`.
+     */
+    void print(std::ostream& out, double tolerance) const;
+};
+
+/**
+ * Relative error floor of a property tabulated in `table`: a small fraction 
+ * of its largest absolute value, see PropertyError.
+ */
+double errorFloor(const TableEntry<double>& table);
+
+/**
+ * Error of the values of a property, e.g. interpolated from a table, against 
+ * reference values at the same (temperature, pressure) points, relative to 
+ * max(|reference|, floor). The worst point is the first one of largest error.
+ *
+ * @param[in] values, references Values at points[n], n = 0, ..., points.size() - 1.
+ */
+PropertyError compareTables(const std::string& name,
+                            const std::vector<std::pair<double, double>>& points,
+                            const double* values,
+                            const double* references,
+                            double floor);
+
+/**
+ * Off-grid (temperature, pressure) validation points of a table: the
+ * midpoint of every cell, in the scale of each axis, followed by `n_random`
+ * points drawn uniformly (in the scale of each axis) over the table range.
+ *
+ * @param[in] seed Seed of the random points, so that runs are repeatable.
+ */
+std::vector<std::pair<double, double>> validationPoints(const TableEntry<double>& table,
+                                                        int n_random,
+                                                        unsigned seed = 1);
+
+/**
+ * Compare the interpolated properties of `table` with direct Mutation++
+ * equilibrium at the validation points of its enthalpy table. The points are
+ * evaluated in parallel, each thread with its own Mutation++ objects set up
+ * as for table generation (see GasMixture). Only properties tabulated on the
+ * temperature and pressure axes are validated.
+ *
+ * @param[in] mixture The name of the Mutation++ mixture file the table was
+ *     generated from.
+ * @param[in] n_random Number of random points in addition to the midpoints.
+ * @param[in] n_threads Number of threads. Default is 0, which uses all
+ *     hardware threads.
+ */
+ValidationReport validateTable(const GasTable& table,
+                               const std::string& mixture,
+                               const std::string& mu_algorithm,
+                               const std::string& k_algorithm,
+                               int n_random = 1000,
+                               int n_threads = 0,
+                               unsigned seed = 1);
+
+} // namespace IcarusPyro
+
+#endif
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <fstream>
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../bprime_table.h"
+#include "../gas_table.h"
+
+using namespace IcarusPyro;
+
+TEST_CASE("1: Write and read a B' table alongside a gas table.", "[BprimeTable]") {
+
+    std::vector<double> T(4), p(3), Bg(3);
+    for (int i = 0; i < 4; i++) T[i] = 500.0 + 500.0 * i;
+    p[0] = 1.0e3;
+    p[1] = 1.0e4;
+    p[2] = 1.0e5;
+    Bg[0] = 0.0;
+    Bg[1] = 0.5;
+    Bg[2] = 1.0;
+
+    std::vector<std::vector<std::vector<double>>> Bc(3), hw(3);
+    for (int k = 0; k < 3; k++) { 
+        Bc[k].resize(3);
+        hw[k].resize(3);
+        for (int j = 0; j < 3; j++) { 
+            for (int i = 0; i < 4; i++) { 
+                Bc[k][j].push_back(0.1 * Bg[k] + 1.0e-4 * T[i] + 0.01 * std::log10(p[j]));
+                hw[k][j].push_back(1000.0 * T[i] + 1.0e5 * Bg[k]);
+            }
+        }
+    }
+
+    // Gas and surface tables share one database file.
+    GasTable gas("gas-mixture");
+    std::vector<std::vector<double>> z(3, std::vector<double>(4, 1.0));
+    gas.load("enthalpy", "temperature", "pressure", "linear", "log10", T, p, z);
+    gas.write("bprime_test.h5");
+
+    BprimeTable surface("surface-mixture");
+    surface.load("linear", "log10", "linear", T, p, Bg, Bc, hw);
+    surface.write("bprime_test.h5");
+
+    GasTable gas_in("gas-mixture", "bprime_test.h5");
+    REQUIRE(gas_in.enthalpy->nx == 4);
+
+    BprimeTable table("surface-mixture", "bprime_test.h5");
+    REQUIRE(table.bg.size() == 3);
+    REQUIRE(table.bg_scale == "linear");
+
+    std::vector<double> Tw(2), pw(2), Bgw(2), Bc_out, hw_out;
+    Tw[0] = 750.0;
+    pw[0] = std::sqrt(1.0e3 * 1.0e4);
+    Bgw[0] = 0.25;
+    Tw[1] = 2000.0;
+    pw[1] = 1.0e5;
+    Bgw[1] = 1.0;
+    table.lookup(Tw, pw, Bgw, Bc_out, hw_out);
+
+    // The data are linear in T, log10(p) and B'g, so interpolation is exact.
+    for (int f = 0; f < 2; f++) { 
+        REQUIRE(Bc_out[f] == Approx(0.1 * Bgw[f] + 1.0e-4 * Tw[f] + 0.01 * std::log10(pw[f])));
+        REQUIRE(hw_out[f] == Approx(1000.0 * Tw[f] + 1.0e5 * Bgw[f]));
+    }
+
+    REQUIRE_THROWS(BprimeTable("gas-mixture", "bprime_test.h5"));
+}
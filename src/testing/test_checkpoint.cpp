@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <fstream>
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../checkpoint.h"
+
+using namespace IcarusPyro;
+
+TEST_CASE("1: Completed rows are restored on resume.", "[RowCheckpoint]") {
+
+    std::string file_name("rows.checkpoint");
+    std::vector<double> row0 = {1.0, 2.0, 3.0};
+    std::vector<double> row2 = {7.0, 8.0, 9.0};
+    {
+        RowCheckpoint checkpoint(file_name, 42, 3, false);
+        REQUIRE(checkpoint.completedRows() == 0);
+        checkpoint.save(2, row2.data());
+        checkpoint.save(0, row0.data());
+    }
+
+    {
+        // A partial row left by an interrupted write is dropped.
+        std::ofstream file(file_name.c_str(), std::ios::binary | std::ios::app);
+        int row = 1;
+        file.write(reinterpret_cast<const char*>(&row), sizeof(row));
+        file.write(reinterpret_cast<const char*>(row0.data()), sizeof(double));
+    }
+
+    {
+        RowCheckpoint checkpoint(file_name, 42, 3, true);
+        REQUIRE(checkpoint.completedRows() == 2);
+        REQUIRE(checkpoint.completed(0));
+        REQUIRE_FALSE(checkpoint.completed(1));
+        REQUIRE(checkpoint.row(2)[1] == 8.0);
+        REQUIRE(checkpoint.row(1) == nullptr);
+    }
+
+    {
+        // A different run does not resume from the file, and neither does a
+        // run started without resume.
+        RowCheckpoint checkpoint(file_name, 43, 3, true);
+        REQUIRE(checkpoint.completedRows() == 0);
+    }
+    {
+        RowCheckpoint checkpoint(file_name, 42, 3, true);
+        REQUIRE(checkpoint.completedRows() == 0);
+        checkpoint.remove();
+    }
+    std::ifstream file(file_name.c_str());
+    REQUIRE_FALSE(file);
+}
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../compressed_table.h"
+#include "../table_validation.h"
+
+using namespace IcarusPyro;
+
+TEST_CASE("1: Compress a smooth table within the error bound.", "[CompressedEntry]") {
+
+    int nx = 200, ny = 4;
+    TableEntry<double> table(nx, ny, "temperature", "pressure", "linear", "log10");
+    for (int i = 0; i < nx; i++) table.x[i] = 200.0 + 20.0 * i;
+    for (int j = 0; j < ny; j++) table.y[j] = std::pow(10.0, 2 + j);
+    for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < nx; i++) {
+            (*table.z)(i, j) = 1.0e-5 * std::sqrt(table.x[i]) * (1.0 + 0.1 * j);
+        }
+    }
+
+    // The fits follow the dense table, which interpolates linearly between
+    // the grid points: a tolerance below the interpolation error of the grid
+    // keeps it dense.
+    CompressedEntry exact(table, 1.0e-6);
+    REQUIRE(exact.segments() == 0);
+    REQUIRE(exact.memoryBytes() <= exact.denseBytes() + sizeof(double) * nx);
+
+    double tolerance = 1.0e-4;
+    CompressedEntry compressed(table, tolerance);
+    REQUIRE(compressed.maxError() <= tolerance);
+    REQUIRE(compressed.memoryBytes() * 5 < compressed.denseBytes());
+
+    for (int j = 0; j < ny; j++) {
+        double bound = tolerance * (*table.z)(nx-1, j);
+        for (int i = 0; i < nx; i++) {
+            REQUIRE(std::abs(compressed.interpolate(table.x[i], table.y[j]) - (*table.z)(i, j)) <= bound);
+            REQUIRE(std::abs(exact.interpolate(table.x[i], table.y[j]) - (*table.z)(i, j)) == 0.0);
+            if (i == nx - 1) continue;
+            double x = 0.5 * (table.x[i] + table.x[i+1]);
+            REQUIRE(std::abs(compressed.interpolate(x, table.y[j]) - table.interpolate(x, table.y[j])) <= bound);
+            REQUIRE(exact.interpolate(x, table.y[j]) == Approx(table.interpolate(x, table.y[j])).epsilon(1.0e-12));
+        }
+    }
+
+    // Rows are blended as in the dense table.
+    double x = 1234.5, y = std::sqrt(1.0e2 * 1.0e3);
+    REQUIRE(compressed.interpolate(x, y) == Approx(table.interpolate(x, y)).epsilon(1.0e-4));
+    REQUIRE(compressed.interpolate(1.0e5, 1.0e9) == Approx((*table.z)(nx-1, ny-1)).epsilon(1.0e-4));
+}
+
+TEST_CASE("2: Kinks in a table fall back to short segments.", "[CompressedEntry]") {
+
+    int nx = 50;
+    TableEntry<double> table(nx, 2, "temperature", "pressure", "linear", "linear");
+    for (int i = 0; i < nx; i++) {
+        table.x[i] = i;
+        // A kink, and a row without smooth pieces.
+        (*table.z)(i, 0) = (i < 25) ? 1.0 : 1.0 + 0.5 * (i - 25);
+        (*table.z)(i, 1) = (i % 2 == 0) ? 1.0 : -1.0;
+    }
+    table.y[0] = 1.0;
+    table.y[1] = 2.0;
+
+    CompressedEntry compressed(table, 1.0e-8);
+    REQUIRE(compressed.maxError() <= 1.0e-8);
+    REQUIRE(compressed.segments() == 2);
+    for (int i = 0; i < nx; i++) {
+        for (int j = 0; j < 2; j++) {
+            REQUIRE(compressed.interpolate(table.x[i], table.y[j]) == Approx((*table.z)(i, j)).epsilon(1.0e-7));
+            double x = table.x[i] + 0.3;
+            REQUIRE(compressed.interpolate(x, table.y[j]) == Approx(table.interpolate(x, table.y[j])).epsilon(1.0e-7));
+        }
+    }
+}
+
+TEST_CASE("3: Compress the properties of a gas table.", "[CompressedGasTable]") {
+
+    GasTable table("24sp-tacot-pyro", "gas_table.h5");
+    CompressedGasTable compressed(table, 1.0e-4);
+    REQUIRE(compressed.memoryBytes() < compressed.denseBytes());
+
+    // At the grid points and off the grid, e.g. the cell midpoints, the fits 
+    // stay within the tolerance of the dense table.
+    std::vector<std::pair<double, double>> points = validationPoints(*table.enthalpy, 500);
+    const TableEntry<double>* dense[] = {table.cp, table.cv, table.eint, table.enthalpy, table.mw, 
+                                         table.density, table.viscosity, table.conductivity, 
+                                         table.reactive_conductivity};
+    const CompressedEntry* fits[] = {compressed.cp.get(), compressed.cv.get(), compressed.eint.get(), 
+                                     compressed.enthalpy.get(), compressed.mw.get(), 
+                                     compressed.density.get(), compressed.viscosity.get(), 
+                                     compressed.conductivity.get(), compressed.reactive_conductivity.get()};
+    int checked = 0;
+    for (int k = 0; k < 9; k++) {
+        if (!dense[k] || dense[k]->nx < 2 || dense[k]->x_variable != "temperature") continue;
+        const TableEntry<double>& var = *dense[k];
+        checked++;
+        REQUIRE(fits[k]->memoryBytes() <= fits[k]->denseBytes() + sizeof(double) * var.nx);
+        for (int j = 0; j < var.ny; j++) {
+            double largest = 0.0;
+            for (int i = 0; i < var.nx; i++) largest = std::max(largest, std::abs((*var.z)(i, j)));
+            for (int i = 0; i < var.nx; i++) {
+                REQUIRE(std::abs(fits[k]->interpolate(var.x[i], var.y[j]) - (*var.z)(i, j)) <= 1.0e-4 * largest);
+            }
+        }
+        double largest = 0.0;
+        for (int j = 0; j < var.ny; j++) {
+            for (int i = 0; i < var.nx; i++) largest = std::max(largest, std::abs((*var.z)(i, j)));
+        }
+        for (size_t n = 0; n < points.size(); n++) {
+            double T = points[n].first, p = points[n].second;
+            REQUIRE(std::abs(fits[k]->interpolate(T, p) - var.interpolate(T, p)) <= 1.0e-4 * largest);
+        }
+    }
+    REQUIRE(checked >= 3);
+}
@@ -0,0 +1,81 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../ensemble.h"
+#include "../gas_table.h"
+#include "../pyrolysis_gas.h"
+
+using namespace IcarusPyro;
+
+TEST_CASE("1: Perturbed compositions are repeatable and normalized.", "[GasEnsemble]") {
+
+    std::vector<double> Xe = {0.206, 0.679, 0.115, 0.0};
+    std::vector< std::vector<double> > X = perturbComposition(Xe, 5, 0.1, 3);
+    REQUIRE(X.size() == 5);
+    for (size_t s = 0; s < X.size(); s++) {
+        double sum = 0.0;
+        for (size_t e = 0; e < Xe.size(); e++) {
+            REQUIRE(X[s][e] >= 0.0);
+            sum += X[s][e];
+        }
+        REQUIRE(sum == Approx(1.0));
+        REQUIRE(X[s][3] == 0.0);
+        REQUIRE(X[s] != Xe);
+    }
+    REQUIRE(perturbComposition(Xe, 5, 0.1, 3) == X);
+    REQUIRE(perturbComposition(Xe, 5, 0.1, 4) != X);
+}
+
+TEST_CASE("2: The nominal variant of an ensemble matches the gas table.", "[GasEnsemble]") {
+
+    std::string gas_mixture = "tacot24";
+    GasMixture TACOT(gas_mixture, 300, 4000, 12, "linear", 1.01325, 1013250, 3, "log10", "Wilke");
+    TACOT.write("ensemble_reference.h5");
+    GasTable reference(gas_mixture, "ensemble_reference.h5");
+
+    std::vector<std::string> algorithms = {"Wilke", "Gupta-Yos"};
+    GasEnsemble ensemble(gas_mixture, 300, 4000, 12, "linear", 1.01325, 1013250, 3, "log10",
+                         algorithms, "Wilke", 2, 0.05, 1, 2);
+    REQUIRE(ensemble.variants() == 6);
+    REQUIRE(ensemble.variantName(0) == "xe0_Wilke");
+    REQUIRE(ensemble.variantName(3) == "xe1_Gupta-Yos");
+    ensemble.compute();
+    ensemble.write("ensemble_gas_table.h5", "tacot24_ensemble");
+
+    GasTable nominal("tacot24_ensemble/xe0_Wilke", "ensemble_gas_table.h5");
+    GasTable perturbed("tacot24_ensemble/xe1_Wilke", "ensemble_gas_table.h5");
+    GasTable gupta_yos("tacot24_ensemble/xe0_Gupta-Yos", "ensemble_gas_table.h5");
+    bool perturbed_differs = false;
+    bool gupta_yos_differs = false;
+    for (int j = 0; j < reference.density->ny; j++) {
+        for (int i = 0; i < reference.density->nx; i++) {
+            REQUIRE((*nominal.density->z)(i, j) == (*reference.density->z)(i, j));
+            REQUIRE((*nominal.enthalpy->z)(i, j) == (*reference.enthalpy->z)(i, j));
+            REQUIRE((*nominal.viscosity->z)(i, j) == (*reference.viscosity->z)(i, j));
+            REQUIRE((*nominal.conductivity->z)(i, j) == (*reference.conductivity->z)(i, j));
+            // Another composition changes the equilibrium, another viscosity 
+            // algorithm only the viscosity.
+            if ((*perturbed.mw->z)(i, j) != (*nominal.mw->z)(i, j)) perturbed_differs = true;
+            if ((*gupta_yos.viscosity->z)(i, j) != (*nominal.viscosity->z)(i, j)) gupta_yos_differs = true;
+            REQUIRE((*gupta_yos.enthalpy->z)(i, j) == (*nominal.enthalpy->z)(i, j));
+        }
+    }
+    REQUIRE(perturbed_differs);
+    REQUIRE(gupta_yos_differs);
+    REQUIRE(perturbed.enthalpy->nx == 12);
+    REQUIRE(perturbed.enthalpy->ny == 3);
+
+    std::unique_ptr<H5File> file(new H5File("ensemble_gas_table.h5", H5F_ACC_RDONLY));
+    Group variant = file->openGroup("tacot24_ensemble/xe1_Gupta-Yos");
+    Attribute attr = variant.openAttribute("elemental_fractions");
+    std::vector<double> X(attr.getSpace().getSimpleExtentNpoints());
+    attr.read(PredType::NATIVE_DOUBLE, X.data());
+    REQUIRE(X == ensemble.compositions()[1]);
+    H5std_string algorithm;
+    attr = variant.openAttribute("viscosity_algorithm");
+    attr.read(attr.getStrType(), algorithm);
+    REQUIRE(algorithm == "Gupta-Yos");
+}
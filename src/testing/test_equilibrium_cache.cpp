@@ -0,0 +1,89 @@
+#include <iostream>
+#include <fstream>
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../equilibrium_cache.h"
+#include "../gas_table.h"
+
+using namespace IcarusPyro;
+
+namespace { 
+
+class CountingFallback : public GasTableFallback { 
+public:
+    CountingFallback() : calls(0) {}
+
+    void evaluate(double temperature, double pressure, GasProperties& props) { 
+        calls++;
+        props.enthalpy = -1.0;
+        props.density = pressure / temperature;
+    }
+
+    int calls;
+};
+
+} // namespace
+
+TEST_CASE("1: Least recently used states are evicted.", "[StateCache]") {
+
+    StateCache cache(2, 1.0, 1.0e-3);
+    GasProperties props;
+    props.enthalpy = 1.0;
+
+    REQUIRE_FALSE(cache.find(100.2, 1.0e5, props));
+    cache.insert(100.2, 1.0e5, props);
+    props.enthalpy = 2.0;
+    cache.insert(200.0, 1.0e5, props);
+
+    // Same bin as the first state.
+    REQUIRE(cache.find(100.7, 1.0e5 * 1.0001, props));
+    REQUIRE(props.enthalpy == 1.0);
+
+    props.enthalpy = 3.0;
+    cache.insert(300.0, 1.0e5, props);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.evictions() == 1);
+    REQUIRE_FALSE(cache.find(200.0, 1.0e5, props));
+    REQUIRE(cache.find(100.5, 1.0e5, props));
+
+    REQUIRE(cache.hits() == 2);
+    REQUIRE(cache.misses() == 2);
+
+    double T = 100.2;
+    double p = 1.0e5;
+    cache.quantize(T, p);
+    REQUIRE(T == Approx(100.5));
+}
+
+TEST_CASE("2: Out-of-range lookups use the table fallback.", "[GasTable]") {
+
+    GasTable table("test-mixture");
+    std::vector<double> x(2), y(2);
+    x[0] = 300.0;
+    x[1] = 3000.0;
+    y[0] = 1.0e3;
+    y[1] = 1.0e5;
+    std::vector<std::vector<double>> z(2, std::vector<double>(2, 5.0));
+    table.load("enthalpy", "temperature", "pressure", "linear", "log10", x, y, z);
+    table.load("density", "temperature", "pressure", "linear", "log10", x, y, z);
+
+    GasProperties props;
+    table.lookup(5000.0, 1.0e4, props);
+    REQUIRE(props.enthalpy == 5.0);
+
+    CountingFallback fallback;
+    table.setFallback(&fallback);
+    table.lookup(1000.0, 1.0e4, props);
+    REQUIRE(props.enthalpy == 5.0);
+    REQUIRE(fallback.calls == 0);
+
+    table.lookup(5000.0, 1.0e4, props);
+    REQUIRE(props.enthalpy == -1.0);
+    REQUIRE(props.density == Approx(2.0));
+    table.lookup(1000.0, 10.0, props);
+    REQUIRE(fallback.calls == 2);
+}
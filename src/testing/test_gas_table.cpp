@@ -1,12 +1,16 @@
 #include <iostream>
 #include <fstream>
 
+#include <cmath>
+#include <memory>
+#include <random>
 #include <string>
 
 #include <catch2/catch.hpp>
 
 #include "../pyrolysis_gas.h"
 #include "../gas_table.h"
+#include "../parallel.h"
 
 using namespace IcarusPyro;
 
@@ -57,14 +61,355 @@ TEST_CASE("2: Load a pyrolysis gas mixture database.", "[GasTable]") {
     std::string gas_database = "gas_table.h5";
     GasTable TACOT(gas_mixture, gas_database);
 
-    std::cout << "Specific Heat at Constant Pressure" << std::endl;
-    std::cout << "  Dependent Variables : " << TACOT.cv->x_variable << ", " << TACOT.cv->y_variable << std::endl;
-    std::cout << "  Number of Points : " << TACOT.cv->nx << ", " << TACOT.cv->ny << std::endl;
-    // //std::cout << "  " << (*(TACOT.cv->z))(868,1) << std::endl;
-    // // for (int i = 0; i < TACOT.cp->ny; i++) { 
-    // //     std::cout << i << " " << TACOT.cv->y[i] << std::endl;
-    // // }
+    std::cout << "Enthalpy" << std::endl;
+    std::cout << "  Dependent Variables : " << TACOT.enthalpy->x_variable << ", " << TACOT.enthalpy->y_variable << std::endl;
+    std::cout << "  Number of Points : " << TACOT.enthalpy->nx << ", " << TACOT.enthalpy->ny << std::endl;
+
+    // The cp and cv of this database are tabulated on (energy, density): 
+    // lookups at (temperature, pressure) must not interpolate them.
+    {
+        H5File file(gas_database, H5F_ACC_RDONLY);
+        Group gas = file.openGroup(gas_mixture);
+        std::unique_ptr<TableEntry<double>> cv(readTableEntry(&gas, "cv"));
+        REQUIRE(cv->x_variable == "energy");
+        REQUIRE(cv->y_variable == "density");
+    }
+    REQUIRE(TACOT.cp == nullptr);
+    REQUIRE(TACOT.cv == nullptr);
+    REQUIRE(TACOT.enthalpy->x_variable == "temperature");
+    GasProperties props;
+    TACOT.lookup(1500.0, 5.0e4, props);
+    REQUIRE(props.cp == 0.0);
+    REQUIRE(props.cv == 0.0);
+    GasDerivedState state;
+    REQUIRE_THROWS_AS(TACOT.derivedProperties(std::vector<double>(1, 1500.0), std::vector<double>(1, 5.0e4), state), 
+                      std::runtime_error);
 
     TACOT.write("new_gas_table.h5");
 }
 
+
+TEST_CASE("3: Thermal conductivity and species mass fraction tables.", "[GasTable]") {
+
+    std::string gas_mixture = "tacot24";
+    GasTable TACOT(gas_mixture);
+
+    std::vector<double> x(3), y(2);
+    x[0] = 300.0;
+    x[1] = 3000.0;
+    x[2] = 5000.0;
+    y[0] = 10132.50;
+    y[1] = 101325.0;
+    std::vector<std::vector<double>> k(2, std::vector<double>(3, 0.1));
+    std::vector<std::vector<double>> Y(2, std::vector<double>(3, 0.0));
+    Y[1][2] = 0.5;
+
+    TACOT.load("conductivity", "temperature", "pressure", "linear", "log10", x, y, k);
+    TACOT.loadSpecies("CO", "temperature", "pressure", "linear", "log10", x, y, Y);
+    TACOT.write("species_gas_table.h5");
+
+    GasTable table(gas_mixture, "species_gas_table.h5");
+    REQUIRE(table.conductivity->interpolate(1000.0, 5.0e4) == Approx(0.1));
+    REQUIRE(table.species_names.size() == 1);
+    REQUIRE(table.speciesIndex("CO") == 0);
+    REQUIRE(table.speciesIndex("H2") == -1);
+    REQUIRE(table.species[0]->interpolate(5000.0, 101325.0) == Approx(0.5));
+}
+
+TEST_CASE("4: Stream table rows out of order.", "[TableStream]") {
+
+    std::vector<double> x = {300.0, 1000.0, 3000.0};
+    std::vector<double> y = {1.0e3, 1.0e4, 1.0e5};
+    {
+        H5File file("stream_gas_table.h5", H5F_ACC_TRUNC);
+        Group gas = file.createGroup("stream-mixture");
+        TableStream stream(&gas, "enthalpy", "temperature", "pressure", "linear", "log10", x);
+        for (int j = 2; j >= 0; j--) { 
+            double row[3] = {10.0 * j, 10.0 * j + 1.0, 10.0 * j + 2.0};
+            stream.writeRow(j, y[j], row);
+        }
+    }
+
+    GasTable table("stream-mixture", "stream_gas_table.h5");
+    REQUIRE(table.enthalpy->nx == 3);
+    REQUIRE(table.enthalpy->ny == 3);
+    REQUIRE(table.enthalpy->y_scale == "log10");
+    REQUIRE(table.enthalpy->y[2] == 1.0e5);
+    REQUIRE((*table.enthalpy->z)(1, 2) == 21.0);
+    REQUIRE(table.enthalpy->interpolate(1000.0, std::sqrt(1.0e3 * 1.0e4)) == Approx(6.0));
+}
+
+TEST_CASE("5: Tables move and copy without sharing storage.", "[TableEntry]") {
+
+    TableEntry<double> a(3, 2, "temperature", "pressure", "linear", "log10");
+    REQUIRE(reinterpret_cast<size_t>(a.x) % TABLE_ALIGNMENT == 0);
+    REQUIRE(reinterpret_cast<size_t>(a.z->values()) % TABLE_ALIGNMENT == 0);
+    a.x[2] = 3000.0;
+    (*a.z)(2, 1) = 5.0;
+
+    TableEntry<double> b(a);
+    (*b.z)(2, 1) = 6.0;
+    REQUIRE((*a.z)(2, 1) == 5.0);
+
+    std::vector<TableEntry<double>> tables;
+    tables.push_back(std::move(a));
+    tables.push_back(b);
+    tables.emplace_back(1, 1, "temperature", "pressure", "linear", "linear");
+    REQUIRE(a.z == nullptr);
+    REQUIRE(tables[0].x[2] == 3000.0);
+    REQUIRE((*tables[0].z)(2, 1) == 5.0);
+    REQUIRE((*tables[1].z)(2, 1) == 6.0);
+
+    tables[2] = tables[0];
+    (*tables[0].z)(2, 1) = 7.0;
+    REQUIRE((*tables[2].z)(2, 1) == 5.0);
+    REQUIRE(tables[2].ownsStorage());
+
+    // A moved-from table can be assigned to and used again.
+    TableEntry<double> c(2, 2, "temperature", "pressure", "linear", "linear");
+    c.x[1] = c.y[1] = 1.0;
+    (*c.z)(1, 0) = 2.0;
+    (*c.z)(1, 1) = 4.0;
+    TableEntry<double> d(std::move(c));
+    REQUIRE(c.z == nullptr);
+    c = d;
+    REQUIRE(c.z != nullptr);
+    REQUIRE(c.z->values() != d.z->values());
+    REQUIRE(c.interpolate(0.5, 0.5) == Approx(1.5));
+
+    // A table loaded from a database views the arena of its GasTable.
+    GasTable loaded("24sp-tacot-pyro", "gas_table.h5");
+    REQUIRE_FALSE(loaded.enthalpy->ownsStorage());
+    double h = loaded.enthalpy->interpolate(1000.0, 101325.0);
+    GasTable moved(std::move(loaded));
+    REQUIRE(loaded.enthalpy == nullptr);
+    REQUIRE(moved.enthalpy->interpolate(1000.0, 101325.0) == h);
+}
+
+TEST_CASE("6: Load a gas table on a background thread.", "[GasTable]") {
+
+    std::future<GasTable> pending = loadGasTableAsync("24sp-tacot-pyro", "gas_table.h5");
+    std::future<GasTable> missing = loadGasTableAsync("24sp-tacot-pyro", "no_such_table.h5");
+    REQUIRE_THROWS_AS(missing.get(), std::runtime_error);
+
+    GasTable table = pending.get();
+    GasTable direct("24sp-tacot-pyro", "gas_table.h5");
+    REQUIRE(table.enthalpy->sameAxes(*direct.enthalpy));
+    REQUIRE(table.enthalpy->interpolate(1000.0, 101325.0) == direct.enthalpy->interpolate(1000.0, 101325.0));
+    REQUIRE(table.species_names == direct.species_names);
+}
+
+TEST_CASE("7: Derived properties from one pass over the tables.", "[GasTable]") {
+
+    std::string gas_mixture = "tacot24";
+    GasMixture TACOT(gas_mixture, 300, 4000, 20, "linear", 1.01325, 1013250, 3, "log10", "Wilke");
+    TACOT.write("derived_gas_table.h5");
+    GasTable table(gas_mixture, "derived_gas_table.h5");
+    REQUIRE(table.sharedAxes());
+
+    std::vector<double> T = {300.0, 1234.5, 2500.0, 4000.0};
+    std::vector<double> p = {1.01325, 5000.0, 101325.0, 1013250.0};
+    GasDerivedState state;
+    table.derivedProperties(T, p, state);
+    REQUIRE(state.gamma.size() == T.size());
+    for (size_t k = 0; k < T.size(); k++) { 
+        GasProperties props;
+        table.lookup(T[k], p[k], props);
+        double R = 8314.462618 / props.mw;
+        REQUIRE(state.gamma[k] == Approx(props.cp / props.cv));
+        REQUIRE(state.gas_constant[k] == Approx(R));
+        REQUIRE(state.sound_speed[k] == Approx(std::sqrt(props.cp / props.cv * R * T[k])));
+        REQUIRE(state.kinematic_viscosity[k] == Approx(props.viscosity / props.density));
+    }
+
+    // Pre-tabulated derived quantities are exact at the nodes and close in 
+    // between.
+    table.tabulateDerived();
+    REQUIRE(table.derivedTabulated());
+    GasDerivedState tabulated;
+    table.derivedProperties(T, p, tabulated);
+    REQUIRE(tabulated.gamma[0] == Approx(state.gamma[0]));
+    REQUIRE(tabulated.sound_speed[3] == Approx(state.sound_speed[3]));
+    REQUIRE(tabulated.sound_speed[1] == Approx(state.sound_speed[1]).epsilon(1.0e-3));
+    REQUIRE(tabulated.gamma[2] == Approx(state.gamma[2]).epsilon(1.0e-3));
+
+    GasTable moved(std::move(table));
+    REQUIRE(moved.derivedTabulated());
+
+    // Without a molecular weight table the gas constant follows from the 
+    // density.
+    GasTable legacy(gas_mixture, "derived_gas_table.h5");
+    legacy.setEntry("molecular_weight", nullptr);
+    legacy.derivedProperties(std::vector<double>(1, 1000.0), std::vector<double>(1, 101325.0), state);
+    GasProperties props;
+    legacy.lookup(1000.0, 101325.0, props);
+    REQUIRE(state.gas_constant[0] == Approx(101325.0 / (props.density * 1000.0)));
+}
+
+TEST_CASE("8: Batched lookups start from the cached cell of each point.", "[GasTable]") {
+
+    GasTable table("24sp-tacot-pyro", "gas_table.h5");
+    const TableEntry<double>& h = *table.enthalpy;
+
+    // Walking from any starting interval finds the same cell as a search.
+    double T_mid = 0.5 * (h.x[0] + h.x[h.nx-1]);
+    double p_mid = std::sqrt(h.y[0] * h.y[h.ny-1]);
+    TableIndex found = h.locate(T_mid, p_mid);
+    for (int i = -1; i < h.nx; i += 7) { 
+        TableIndex walked = h.locateFrom(T_mid, p_mid, i, 0);
+        REQUIRE(walked.i == found.i);
+        REQUIRE(walked.j == found.j);
+        REQUIRE(walked.wx == found.wx);
+        REQUIRE(walked.wy == found.wy);
+    }
+
+    // Points drift a little between steps, some jump and some leave the table.
+    const size_t n = 1000;
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> T(n), p(n);
+    for (size_t k = 0; k < n; k++) { 
+        T[k] = h.x[0] + unit(generator) * (h.x[h.nx-1] - h.x[0]);
+        p[k] = h.y[0] * std::pow(h.y[h.ny-1] / h.y[0], unit(generator));
+    }
+    TableIndexCache cells;
+    cells.resize(n);
+    std::vector<GasProperties> props(n);
+    for (int step = 0; step < 4; step++) { 
+        parallelFor(4, 4, [&](int /*t*/, int chunk) { 
+            table.lookup(T, p, chunk * n / 4, (chunk + 1) * n / 4, cells, props);
+        });
+        for (size_t k = 0; k < n; k++) { 
+            GasProperties direct;
+            table.lookup(T[k], p[k], direct);
+            REQUIRE(props[k].enthalpy == direct.enthalpy);
+            REQUIRE(props[k].density == direct.density);
+            REQUIRE(props[k].viscosity == direct.viscosity);
+            TableIndex idx = table.locate(T[k], p[k]);
+            REQUIRE(cells.i[k] == idx.i);
+            REQUIRE(cells.j[k] == idx.j);
+        }
+        for (size_t k = 0; k < n; k++) { 
+            T[k] *= (k % 50 == 0) ? 0.5 + unit(generator) : 1.0 + 0.002 * (unit(generator) - 0.5);
+            p[k] *= (k % 97 == 0) ? 1.0e3 : 1.0;
+        }
+    }
+
+    REQUIRE_THROWS_AS(table.lookup(T, p, 0, n + 1, cells, props), std::runtime_error);
+    cells.reset();
+    REQUIRE(cells.i[0] == -1);
+}
+
+TEST_CASE("9: Rewriting a database replaces the mixture group or the whole file.", "[GasTable]") {
+
+    std::vector<double> x = {300.0, 1000.0, 3000.0};
+    std::vector<double> y = {1.0e3, 1.0e5};
+    std::vector<std::vector<double>> z(2, std::vector<double>(3, 1.0));
+    std::vector<std::vector<double>> Y(2, std::vector<double>(3, 0.5));
+
+    GasTable first("rewrite-mixture");
+    first.load("enthalpy", "temperature", "pressure", "linear", "log10", x, y, z);
+    first.loadSpecies("CO", "temperature", "pressure", "linear", "log10", x, y, Y);
+    first.write("rewrite_gas_table.h5", "", true);
+    GasTable other("other-mixture");
+    other.load("enthalpy", "temperature", "pressure", "linear", "log10", x, y, z);
+    other.write("rewrite_gas_table.h5");
+
+    // A smaller table of the same mixture leaves nothing of the first behind.
+    GasTable second("rewrite-mixture");
+    second.load("enthalpy", "temperature", "pressure", "linear", "log10", x, y, z);
+    second.write("rewrite_gas_table.h5");
+    GasTable reread("rewrite-mixture", "rewrite_gas_table.h5");
+    REQUIRE(reread.species_names.empty());
+    REQUIRE(GasTable("other-mixture", "rewrite_gas_table.h5").enthalpy->nx == 3);
+
+    second.write("rewrite_gas_table.h5", "", true);
+    REQUIRE_THROWS(GasTable("other-mixture", "rewrite_gas_table.h5"));
+}
+
+TEST_CASE("10: Species tables are stored on their compact support.", "[GasTable]") {
+
+    std::vector<double> x = {300.0, 600.0, 1000.0, 2000.0, 3000.0, 5000.0};
+    std::vector<double> y = {1.0e2, 1.0e3, 1.0e4, 1.0e5};
+    std::vector<std::vector<double>> Y(4, std::vector<double>(6, 0.0));
+    Y[1][3] = 0.2;
+    Y[2][3] = 0.4;
+    Y[2][4] = 0.1;
+    std::vector<std::vector<double>> none(4, std::vector<double>(6, 0.0));
+
+    GasTable table("compact-mixture");
+    table.loadSpecies("CO", "temperature", "pressure", "linear", "log10", x, y, Y);
+    table.loadSpecies("N2", "temperature", "pressure", "linear", "log10", x, y, none);
+    TableEntry<double> dense(*table.species[0]);
+    table.compactSpecies();
+
+    REQUIRE(table.species_names.size() == 1);
+    REQUIRE(table.speciesIndex("N2") == -1);
+    const TableEntry<double>& compact = *table.species[table.speciesIndex("CO")];
+    REQUIRE(compact.nx == 4);
+    REQUIRE(compact.ny == 4);
+    REQUIRE(compact.x[0] == 1000.0);
+    REQUIRE(compact.x[3] == 5000.0);
+
+    for (double T = 200.0; T <= 6000.0; T += 137.0) { 
+        for (double lp = 1.5; lp <= 5.5; lp += 0.25) { 
+            double p = std::pow(10.0, lp);
+            REQUIRE(compact.interpolate(T, p) == Approx(dense.interpolate(T, p)).margin(1.0e-15));
+        }
+    }
+
+    table.write("compact_gas_table.h5");
+    GasTable reread("compact-mixture", "compact_gas_table.h5");
+    REQUIRE(reread.species_names.size() == 1);
+    REQUIRE(reread.species[0]->nx == 4);
+    REQUIRE(reread.species[0]->interpolate(2000.0, 1.0e4) == Approx(0.4));
+}
+
+TEST_CASE("11: Tables missing from a database are left out of the shared axes.", "[GasTable]") {
+
+    std::string gas_mixture = "tacot24";
+    GasMixture TACOT(gas_mixture, 300, 3000, 10, "linear", 1.01325, 1013250, 3, "log10", "Wilke");
+    TACOT.write("missing_gas_table.h5");
+    GasTable full(gas_mixture, "missing_gas_table.h5");
+    {
+        // A database written before these tables were added.
+        H5File file("missing_gas_table.h5", H5F_ACC_RDWR);
+        Group gas = file.openGroup(gas_mixture);
+        gas.unlink("mw");
+        gas.unlink("conductivity");
+        gas.unlink("reactive_conductivity");
+    }
+
+    GasTable table(gas_mixture, "missing_gas_table.h5");
+    REQUIRE(table.mw == nullptr);
+    REQUIRE(table.conductivity == nullptr);
+    REQUIRE(table.reactive_conductivity == nullptr);
+    REQUIRE(table.sharedAxes());
+
+    GasProperties props, reference;
+    table.lookup(1234.5, 5.0e4, props);
+    full.lookup(1234.5, 5.0e4, reference);
+    REQUIRE(props.mw == 0.0);
+    REQUIRE(props.conductivity == 0.0);
+    REQUIRE(props.enthalpy == reference.enthalpy);
+    REQUIRE(props.viscosity == reference.viscosity);
+}
+
+TEST_CASE("12: A table whose data does not match its axes is rejected.", "[GasTable]") {
+
+    std::string gas_mixture = "tacot24";
+    GasMixture TACOT(gas_mixture, 300, 3000, 10, "linear", 1.01325, 1013250, 3, "log10", "Wilke");
+    TACOT.write("truncated_gas_table.h5");
+    {
+        // A viscosity table truncated to a single row.
+        H5File file("truncated_gas_table.h5", H5F_ACC_RDWR);
+        Group viscosity = file.openGroup(gas_mixture + "/viscosity");
+        viscosity.unlink("z");
+        hsize_t dims[2] = {1, 10};
+        DataSpace space(2, dims);
+        std::vector<double> row(10, 1.0e-5);
+        DataSet z = viscosity.createDataSet("z", PredType::NATIVE_DOUBLE, space);
+        z.write(row.data(), PredType::NATIVE_DOUBLE);
+    }
+    REQUIRE_THROWS_AS(GasTable(gas_mixture, "truncated_gas_table.h5"), std::runtime_error);
+}
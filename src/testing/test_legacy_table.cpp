@@ -0,0 +1,70 @@
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include "../gas_table.h"
+#include "../legacy_table.h"
+
+using namespace IcarusPyro;
+
+TEST_CASE("1: Import the legacy gas table file.", "[LegacyTable]") {
+
+    std::string name = convertLegacyTable("gas_table.db", "imported_gas_table.h5");
+    REQUIRE(name == "24sp-tacot-pyro");
+
+    GasTable legacy(name, "gas_table.h5");
+    GasTable imported(name, "imported_gas_table.h5");
+
+    REQUIRE(imported.enthalpy->nx == 217);
+    REQUIRE(imported.enthalpy->ny == 4);
+    REQUIRE(imported.enthalpy->x_variable == "temperature");
+    REQUIRE(imported.enthalpy->y_scale == "log10");
+
+    // The (energy, density) cp is not the (temperature, pressure) cp of GasTable.
+    REQUIRE(imported.cp == nullptr);
+    REQUIRE(imported.cv == nullptr);
+    GasProperties props;
+    imported.lookup(1500.0, 5.0e4, props);
+    REQUIRE(props.cp == 0.0);
+    REQUIRE(props.cv == 0.0);
+    REQUIRE(props.enthalpy == Approx(imported.enthalpy->interpolate(1500.0, 5.0e4)));
+    {
+        H5File file("imported_gas_table.h5", H5F_ACC_RDONLY);
+        Group gas = file.openGroup(name);
+        std::unique_ptr<TableEntry<double>> cp(readTableEntry(&gas, "cp_energy_density"));
+        REQUIRE(cp->x_variable == "energy");
+        REQUIRE(cp->y_variable == "density");
+        REQUIRE(cp->nx == 869);
+        REQUIRE(cp->ny == 61);
+        REQUIRE(H5Lexists(gas.getId(), "cp", H5P_DEFAULT) == 0);
+    }
+
+    // Values are kept in double precision rather than rounded to float.
+    REQUIRE(imported.enthalpy->x[1] == 337.5);
+    REQUIRE(imported.enthalpy->y[0] == 1.01325e3);
+    REQUIRE((*imported.enthalpy->z)(1, 1) == -7.0276e6);
+    REQUIRE((*imported.enthalpy->z)(1, 1) == Approx((*legacy.enthalpy->z)(1, 1)));
+    REQUIRE(imported.viscosity->interpolate(1500.0, 5.0e4) == Approx(legacy.viscosity->interpolate(1500.0, 5.0e4)).epsilon(1.0e-6));
+
+    GasTable loaded(name);
+    loadLegacyTable("gas_table.db", loaded);
+    REQUIRE(loaded.density->nx == imported.density->nx);
+    REQUIRE(loaded.density->interpolate(1500.0, 5.0e4) == imported.density->interpolate(1500.0, 5.0e4));
+    REQUIRE(loaded.mw == nullptr);
+    REQUIRE(loaded.cp == nullptr);
+    REQUIRE(loaded.cv == nullptr);
+}
+
+TEST_CASE("2: Malformed legacy sections are reported.", "[LegacyTable]") {
+
+    {
+        std::ofstream file("bad_gas_table.db");
+        file << "[GAS]\nbad-mixture\n\n[ENTHALPY]\ntable-lookup-2D\n2\n2\n300.0\n400.0\n"
+             << "1.0E+03 1.0E+04\n300.0 1.0 2.0\n400.0 3.0\n";
+    }
+    REQUIRE_THROWS_AS(convertLegacyTable("bad_gas_table.db", "bad_gas_table.h5"), std::runtime_error);
+    REQUIRE_THROWS_AS(LegacyTableReader("missing_gas_table.db"), std::runtime_error);
+}
@@ -1,7 +1,9 @@
 #include <iostream>
 #include <fstream>
+#include <cmath>
 
 #include <string>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -18,3 +20,112 @@ TEST_CASE("1: Read YAML database entries for a material.", "[io]") {
     REQUIRE(TACOT.get_name() == material_name);
 
 }
+
+namespace {
+
+// Root of the surface energy balance of one face by bisection.
+double bisectSurfaceTemperature(double q, double a, double G, double T_in)
+{
+    double low = 0.0, high = 1.0e5;
+    for (int k = 0; k < 200; k++) {
+        double T = 0.5 * (low + high);
+        double f = q - a * T * T * T * T - G * (T - T_in);
+        if (f > 0.0) low = T; else high = T;
+    }
+    return 0.5 * (low + high);
+}
+
+} // namespace
+
+TEST_CASE("2: Solve the surface energy balance of a batch of faces.", "[Material]") {
+
+    Material TACOT("tacot.yaml");
+    REQUIRE(TACOT.emissivity(0.0) == Approx(0.8));
+    REQUIRE(TACOT.emissivity(1.0) == Approx(0.9));
+    REQUIRE(TACOT.absorptivity(0.5) == Approx(0.85));
+
+    const double sigma = 5.670374419e-8;
+    std::vector<double> q_conv = {1.0e6, 5.0e5, 2.0e4, 0.0, -1.0e2};
+    std::vector<double> q_rad = {0.0, 2.0e5, 1.0e5, 5.0e4, 0.0};
+    std::vector<double> chi = {0.0, 0.25, 0.5, 1.0, 0.75};
+    size_t n = q_conv.size();
+
+    SECTION("Radiative equilibrium") {
+        std::vector<double> T;
+        std::vector<double> none;
+        double T_env = 300.0;
+        int sweeps = TACOT.computeSurfaceTemperature(q_conv, q_rad, chi, none, none, T, T_env);
+        REQUIRE(T.size() == n);
+        REQUIRE(sweeps <= 50);
+        for (size_t k = 0; k < n; k++) {
+            double eps = TACOT.emissivity(chi[k]);
+            double q = q_conv[k] + TACOT.absorptivity(chi[k]) * q_rad[k];
+            REQUIRE(T[k] == Approx(std::pow(q / (eps * sigma) + std::pow(T_env, 4), 0.25)).epsilon(1e-9));
+        }
+    }
+
+    SECTION("Conduction into the material") {
+        std::vector<double> G = {50.0, 500.0, 5000.0, 10.0, 100.0};
+        std::vector<double> T_in = {300.0, 800.0, 1500.0, 2000.0, 400.0};
+        std::vector<double> T;
+        TACOT.computeSurfaceTemperature(q_conv, q_rad, chi, G, T_in, T);
+        for (size_t k = 0; k < n; k++) {
+            double a = sigma * TACOT.emissivity(chi[k]);
+            double q = q_conv[k] + TACOT.absorptivity(chi[k]) * q_rad[k];
+            REQUIRE(T[k] == Approx(bisectSurfaceTemperature(q, a, G[k], T_in[k])).epsilon(1e-9));
+        }
+
+        // From a guess below the solution, e.g. that of the previous step.
+        std::vector<double> T_guess(n, 100.0);
+        TACOT.computeSurfaceTemperature(q_conv, q_rad, chi, G, T_in, T_guess);
+        for (size_t k = 0; k < n; k++) REQUIRE(T_guess[k] == Approx(T[k]).epsilon(1e-9));
+
+        std::vector<double> T_short;
+        REQUIRE_THROWS(TACOT.computeSurfaceTemperature(q_conv, q_rad, chi, G, T_in, T_short, 0.0, 1e-10, 1));
+    }
+
+    SECTION("Faces without a positive solution") {
+        // Without conduction, a face that receives no net flux would have
+        // f'(0) = 0 at its starting point.
+        std::vector<double> none;
+        std::vector<double> T;
+        std::vector<double> q_none = {0.0};
+        std::vector<double> q_out = {-1.0e3};
+        std::vector<double> zero = {0.0};
+        REQUIRE_THROWS(TACOT.computeSurfaceTemperature(q_none, zero, zero, none, none, T));
+        REQUIRE_THROWS(TACOT.computeSurfaceTemperature(q_out, zero, zero, none, none, T));
+        std::vector<double> G = {100.0};
+        std::vector<double> T_in = {5.0};
+        REQUIRE_THROWS(TACOT.computeSurfaceTemperature(q_out, zero, zero, G, T_in, T));
+
+        // A zero guess is replaced by the upper bound.
+        std::vector<double> q_in = {1.0e5};
+        std::vector<double> T_zero = {0.0};
+        TACOT.computeSurfaceTemperature(q_in, zero, zero, none, none, T_zero);
+        REQUIRE(T_zero[0] == Approx(std::pow(1.0e5 / (TACOT.emissivity(0.0) * sigma), 0.25)).epsilon(1e-9));
+    }
+
+    SECTION("Inputs of different sizes") {
+        std::vector<double> T;
+        std::vector<double> none;
+        std::vector<double> short_chi(n - 1, 0.0);
+        REQUIRE_THROWS(TACOT.computeSurfaceTemperature(q_conv, q_rad, short_chi, none, none, T));
+    }
+}
+
+TEST_CASE("3: Reject materials without virgin and char densities.", "[io]") {
+
+    {
+        std::ofstream file("no_density.yaml");
+        file << "name : no_density\n"
+             << "heat_of_formation : {virgin : 0.0, char : 0.0}\n";
+    }
+    REQUIRE_THROWS(Material("no_density.yaml"));
+
+    {
+        std::ofstream file("bad_density.yaml");
+        file << "name : bad_density\n"
+             << "density : {virgin : 0.0, char : 0.0}\n";
+    }
+    REQUIRE_THROWS(Material("bad_density.yaml"));
+}
@@ -0,0 +1,183 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <catch2/catch.hpp>
+
+#include "../memo_cache.h"
+
+using namespace IcarusPyro;
+
+namespace {
+
+void writeFile(const std::string& path, const std::string& text)
+{
+    std::ofstream file(path.c_str());
+    file << text;
+}
+
+// Points MPP_DATA_DIRECTORY at `directory` for the lifetime of the object.
+class DataDirectory {
+public:
+    DataDirectory(const std::string& directory) {
+        const char* value = std::getenv("MPP_DATA_DIRECTORY");
+        had_value = (value != nullptr);
+        if (had_value) previous = value;
+        setenv("MPP_DATA_DIRECTORY", directory.c_str(), 1);
+    }
+    ~DataDirectory() {
+        if (had_value) setenv("MPP_DATA_DIRECTORY", previous.c_str(), 1);
+        else unsetenv("MPP_DATA_DIRECTORY");
+    }
+private:
+    bool had_value;
+    std::string previous;
+};
+
+} // namespace
+
+TEST_CASE("1: Cached points persist between runs.", "[MemoCache]") {
+
+    std::string mixture("memo_test_mixture.xml");
+    writeFile(mixture, "<mixture><species>CO2 CO O2 O C</species></mixture>\n");
+
+    std::vector<double> Xe(3, 0.0);
+    Xe[0] = 0.2;
+    std::string key = MemoCache::makeKey(mixture, Xe, "Wilke", "Wilke");
+    REQUIRE(key.size() == 16);
+    REQUIRE(key == MemoCache::makeKey(mixture, Xe, "Wilke", "Wilke"));
+    REQUIRE(key != MemoCache::makeKey(mixture, Xe, "Chapmann-Enskog_CG", "Wilke"));
+    Xe[1] = 0.1;
+    REQUIRE(key != MemoCache::makeKey(mixture, Xe, "Wilke", "Wilke"));
+
+    std::string directory("memo_cache_test");
+    std::remove((directory + "/" + key + ".memo").c_str());
+
+    double values[2];
+    {
+        MemoCache cache(directory, key, 2);
+        REQUIRE(cache.size() == 0);
+        REQUIRE_FALSE(cache.find(300.0, 1.0e5, values));
+
+        std::vector<double> records = {300.0, 1.0e5, 1.0, 2.0, 
+                                       350.0, 1.0e5, 3.0, 4.0};
+        cache.append(records);
+    }
+
+    {
+        MemoCache cache(directory, key, 2);
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.find(350.0, 1.0e5, values));
+        REQUIRE(values[0] == 3.0);
+        REQUIRE(values[1] == 4.0);
+
+        // Grid points regenerated with a different rounding still match.
+        REQUIRE(cache.find(300.0 + 1.0e-10, 1.0e5 * (1.0 + 1.0e-13), values));
+        REQUIRE(values[0] == 1.0);
+        REQUIRE_FALSE(cache.find(300.0, 2.0e5, values));
+    }
+
+    {
+        // A different record size invalidates the file.
+        MemoCache cache(directory, key, 3);
+        REQUIRE(cache.size() == 0);
+    }
+    std::ifstream file((directory + "/" + key + ".memo").c_str());
+    REQUIRE_FALSE(file);
+}
+
+TEST_CASE("2: Cache keys follow the Mutation++ data files.", "[MemoCache]") {
+
+    std::string data("memo_mpp_data");
+    mkdir(data.c_str(), 0755);
+    mkdir((data + "/mixtures").c_str(), 0755);
+    mkdir((data + "/thermo").c_str(), 0755);
+    mkdir((data + "/transport").c_str(), 0755);
+    writeFile(data + "/mixtures/memo-air.xml", "<mixture><species>N2 O2 NO N O</species></mixture>\n");
+    writeFile(data + "/thermo/nasa9.dat", "N2 coefficients 1\n");
+    writeFile(data + "/transport/collisions.xml", "<collisions/>\n");
+
+    DataDirectory environment(data);
+    std::vector<double> Xe = {0.79, 0.21};
+    std::string key = MemoCache::makeKey("memo-air", Xe, "Wilke", "Wilke");
+    REQUIRE(key == MemoCache::makeKey("memo-air", Xe, "Wilke", "Wilke"));
+
+    writeFile(data + "/thermo/nasa9.dat", "N2 coefficients 2\n");
+    std::string thermo_key = MemoCache::makeKey("memo-air", Xe, "Wilke", "Wilke");
+    REQUIRE(thermo_key != key);
+
+    writeFile(data + "/transport/collisions.xml", "<collisions>Q11</collisions>\n");
+    REQUIRE(MemoCache::makeKey("memo-air", Xe, "Wilke", "Wilke") != thermo_key);
+
+    REQUIRE_THROWS(MemoCache::makeKey("no-such-mixture", Xe, "Wilke", "Wilke"));
+}
+
+TEST_CASE("3: Processes append to one cache file without corrupting it.", "[MemoCache]") {
+
+    std::string directory("memo_cache_test");
+    std::string key("concurrent-appends");
+    std::remove((directory + "/" + key + ".memo").c_str());
+    MemoCache(directory, key, 1);
+
+    const int n_processes = 4;
+    const int n_appends = 200;
+    std::vector<pid_t> children;
+    for (int c = 0; c < n_processes; c++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            MemoCache cache(directory, key, 1);
+            for (int k = 0; k < n_appends; k++) {
+                double T = 1000.0 * c + k;
+                cache.append({T, 1.0e5, T});
+            }
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+    for (size_t c = 0; c < children.size(); c++) waitpid(children[c], nullptr, 0);
+
+    MemoCache cache(directory, key, 1);
+    REQUIRE(cache.size() == n_processes * n_appends);
+    double value;
+    REQUIRE(cache.find(3000.0 + 17.0, 1.0e5, &value));
+    REQUIRE(value == 3017.0);
+}
+
+TEST_CASE("4: Appends after a partial record stay aligned.", "[MemoCache]") {
+
+    std::string directory("memo_cache_test");
+    std::string key("partial-record");
+    std::string file_name = directory + "/" + key + ".memo";
+    std::remove(file_name.c_str());
+    {
+        MemoCache cache(directory, key, 1);
+        cache.append({500.0, 1.0e5, 5.0});
+    }
+    {
+        // An interrupted run wrote the T and p of a record but not its value.
+        std::ofstream file(file_name.c_str(), std::ios::binary | std::ios::app);
+        double partial[2] = {550.0, 1.0e5};
+        file.write(reinterpret_cast<const char*>(partial), sizeof(partial));
+    }
+    {
+        MemoCache cache(directory, key, 1);
+        REQUIRE(cache.size() == 1);
+        cache.append({600.0, 1.0e5, 7.0});
+    }
+
+    MemoCache cache(directory, key, 1);
+    REQUIRE(cache.size() == 2);
+    double value;
+    REQUIRE(cache.find(500.0, 1.0e5, &value));
+    REQUIRE(value == 5.0);
+    REQUIRE(cache.find(600.0, 1.0e5, &value));
+    REQUIRE(value == 7.0);
+    REQUIRE_FALSE(cache.find(550.0, 1.0e5, &value));
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <fstream>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../pyro.h"
+
+using namespace IcarusPyro;
+
+TEST_CASE("1: Solid enthalpy and specific heat are consistent.", "[Material]") {
+
+    Material TACOT("tacot.yaml");
+
+    REQUIRE(TACOT.get_virgin_density() == Approx(280.0));
+    REQUIRE(TACOT.get_char_density() == Approx(220.0));
+    REQUIRE(TACOT.solid_enthalpy(298.15, 1.0) == Approx(-8.571e5));
+    REQUIRE(TACOT.solid_enthalpy(298.15, 0.0) == Approx(0.0).margin(1.0e-6));
+
+    double T = 1200.0;
+    double dT = 1.0e-2;
+    double dh = (TACOT.solid_enthalpy(T + dT, 0.5) - TACOT.solid_enthalpy(T - dT, 0.5)) / (2.0 * dT);
+    REQUIRE(dh == Approx(TACOT.solid_cp(T, 0.5)).epsilon(1.0e-6));
+}
+
+TEST_CASE("2: Porosity and decomposition rate.", "[Material]") {
+
+    Material TACOT("tacot.yaml");
+
+    REQUIRE(TACOT.porosity(TACOT.decomposition_fraction(280.0)) == Approx(0.80));
+    REQUIRE(TACOT.porosity(TACOT.decomposition_fraction(220.0)) == Approx(0.85));
+
+    // Below the minimum reaction temperatures and when fully charred there is no decomposition.
+    REQUIRE(TACOT.decomposition_rate(300.0, 280.0) == 0.0);
+    REQUIRE(TACOT.decomposition_rate(1500.0, 220.0) == 0.0);
+    REQUIRE(TACOT.decomposition_rate(1000.0, 260.0) < 0.0);
+}
+
+TEST_CASE("3: Batched evaluation of the solid and gas properties.", "[Pyro]") {
+
+    Pyro TACOT("tacot.yaml", "24sp-tacot-pyro", "tacot-gsi", "gas_table.h5");
+    REQUIRE(TACOT.get_bprime_table() == nullptr);
+    GasTable& gas = TACOT.get_gas_table();
+
+    std::vector<double> T(3);
+    std::vector<double> p(3, 1.01325e4);
+    std::vector<double> rho_s(3);
+    T[0] = 200.0;
+    T[1] = 1000.0;
+    T[2] = 2500.0;
+    rho_s[0] = 280.0;
+    rho_s[1] = 250.0;
+    rho_s[2] = 220.0;
+
+    PyroState state;
+    TACOT.evaluate(T, p, rho_s, state);
+
+    REQUIRE(state.gas_enthalpy.size() == 3);
+    for (int k = 0; k < 3; k++) { 
+        REQUIRE(state.gas_enthalpy[k] == Approx(gas.enthalpy->interpolate(T[k], p[k])));
+        REQUIRE(state.gas_density[k] == Approx(gas.density->interpolate(T[k], p[k])));
+        REQUIRE(state.mixture_density[k] == Approx(rho_s[k] + state.porosity[k] * state.gas_density[k]));
+    }
+    // Table nodes are reproduced exactly.
+    REQUIRE(state.gas_enthalpy[0] == Approx((*gas.enthalpy->z)(0, 1)));
+}
+
+TEST_CASE("4: Recover temperature from the total energy.", "[Pyro]") {
+
+    Pyro TACOT("tacot.yaml", "24sp-tacot-pyro", "tacot-gsi", "gas_table.h5");
+    Material& solid = TACOT.get_material();
+    GasTable& gas = TACOT.get_gas_table();
+
+    int n = 50;
+    std::vector<double> T(n), p(n), rho_s(n), phi(n), E(n);
+    for (int k = 0; k < n; k++) { 
+        T[k] = 300.0 + 60.0 * k;
+        p[k] = (k % 2 == 0) ? 1.01325e4 : 3.0e5;
+        rho_s[k] = 280.0 - 1.2 * k;
+        phi[k] = solid.porosity(solid.decomposition_fraction(rho_s[k]));
+        E[k] = rho_s[k] * solid.solid_enthalpy(T[k], solid.virgin_mass_fraction(rho_s[k]))
+             + phi[k] * (gas.density->interpolate(T[k], p[k]) * gas.enthalpy->interpolate(T[k], p[k]) - p[k]);
+    }
+
+    std::vector<double> T_out;
+    REQUIRE(TACOT.computeTemperature(E, rho_s, p, phi, T_out) == 0);
+    for (int k = 0; k < n; k++) { 
+        REQUIRE(T_out[k] == Approx(T[k]).epsilon(1.0e-8));
+    }
+
+    // Restart from a nearby guess, as from the previous time step.
+    for (int k = 0; k < n; k++) T_out[k] = T[k] + 25.0;
+    REQUIRE(TACOT.computeTemperature(E, rho_s, p, phi, T_out, 1.0e-10, 8) == 0);
+    REQUIRE(T_out[n/2] == Approx(T[n/2]).epsilon(1.0e-8));
+
+    // Energies above and below the table range have no root in the bracket.
+    double T_high = gas.enthalpy->x[gas.enthalpy->nx-1];
+    double T_low = gas.enthalpy->x[0];
+    auto energy = [&](int k, double T_k) { 
+        return rho_s[k] * solid.solid_enthalpy(T_k, solid.virgin_mass_fraction(rho_s[k]))
+             + phi[k] * (gas.density->interpolate(T_k, p[k]) * gas.enthalpy->interpolate(T_k, p[k]) - p[k]);
+    };
+    E[0] = energy(0, T_high) + 1.0e6;
+    E[1] = energy(1, T_low) - 1.0e6;
+    T_out.clear();
+    REQUIRE(TACOT.computeTemperature(E, rho_s, p, phi, T_out) == 2);
+    REQUIRE(T_out[0] == T_high);
+    REQUIRE(T_out[1] == T_low);
+    REQUIRE(T_out[2] == Approx(T[2]).epsilon(1.0e-8));
+}
+
+TEST_CASE("5: Missing gas mixtures are reported as runtime errors.", "[Pyro]") {
+
+    REQUIRE_THROWS_AS(Pyro("tacot.yaml", "no-such-mixture", "tacot-gsi", "gas_table.h5"), std::runtime_error);
+    REQUIRE_THROWS_AS(GasTable("no-such-mixture", "gas_table.h5"), std::runtime_error);
+}
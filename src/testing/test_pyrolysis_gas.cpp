@@ -1,11 +1,20 @@
+#include <cstdio>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
+#include "../gas_table.h"
 #include "../pyrolysis_gas.h"
+#include "../generation_jobs.h"
+#include "../parallel.h"
 
 using namespace IcarusPyro;
 
@@ -23,6 +32,192 @@ TEST_CASE("2: Load a pyrolysis gas mxiture.", "[GasMixture]") {
     TACOT.write("tacot_gas_table.h5");
 }
 
+TEST_CASE("3: Profile the generation of a gas table.", "[GasMixture]") {
+
+    std::string gas_mixture = "tacot24";
+    GasMixture TACOT(gas_mixture, 300, 4000, 20, "linear", 1.01325, 1013250, 3, "log10", "Wilke");
+    TACOT.write("profile_gas_table.h5");
+
+    const GenerationProfile& profile = TACOT.profile();
+    REQUIRE(profile.computedPoints() == 60);
+    REQUIRE(profile.phase("compute") > 0.0);
+    REQUIRE(profile.phase("write") > 0.0);
+
+    std::ostringstream json;
+    profile.writeJson(json, gas_mixture, 5);
+    REQUIRE(json.str().find("\"computed\": 60") != std::string::npos);
+    REQUIRE(json.str().find("\"slowest\"") != std::string::npos);
+}
+
+TEST_CASE("4: Generate a job list on a work-stealing pool.", "[GasMixture]") {
+
+    std::vector<double> cost = {1.0, 5.0, 0.0, 3.0, 2.0, 2.0, 8.0};
+    std::vector<int> runs(cost.size(), 0);
+    std::mutex mutex;
+    parallelTasks(cost, 3, [&](int /*t*/, int k) {
+        std::lock_guard<std::mutex> lock(mutex);
+        runs[k]++;
+    });
+    REQUIRE(std::count(runs.begin(), runs.end(), 1) == static_cast<int>(cost.size()));
+
+    {
+        GenerationProfile costs;
+        costs.reset({300.0, 4000.0}, {1.0e3}, 1);
+        costs.recordPoint(0, 0, 1.0e-3, 0.0);
+        costs.recordPoint(0, 1, 1.0e-2, 0.0);
+        std::ofstream profile("jobs_cost_profile.json");
+        costs.writeJson(profile, "tacot24");
+    }
+
+    std::ofstream list("generation_jobs.yaml");
+    list << "jobs:\n"
+         << "  - mixture: tacot24\n"
+         << "    database: jobs_gas_table.h5\n"
+         << "    cost_profile: jobs_cost_profile.json\n"
+         << "  - mixture: air5\n"
+         << "    gas_mixture_name: air\n"
+         << "    T_high: 3000\n"
+         << "    nT: 15\n";
+    list.close();
+
+    GenerationJob defaults;
+    defaults.database = "jobs_default_table.h5";
+    defaults.T_low = 300.0;
+    defaults.nT = 20;
+    defaults.nP = 3;
+    std::vector<GenerationJob> jobs = readJobList("generation_jobs.yaml", defaults);
+    REQUIRE(jobs.size() == 2);
+    REQUIRE(jobs[0].gas_mixture_name == "tacot24");
+    REQUIRE(jobs[0].nT == 20);
+    REQUIRE(jobs[0].cost_profile == "jobs_cost_profile.json");
+    REQUIRE(jobs[1].cost_profile.empty());
+    REQUIRE(jobs[1].database == "jobs_default_table.h5");
+    REQUIRE(jobs[1].gas_mixture_name == "air");
+    REQUIRE(jobs[1].T_high == 3000.0);
+    runJobs(jobs, "Wilke", "Wilke", 4, 3);
+
+    // The tables match a generation of each mixture on its own.
+    std::string gas_mixture = "tacot24";
+    GasMixture TACOT(gas_mixture, 300, 4000, 20, "linear", 1.01325, 1013250, 3, "log10", "Wilke");
+    TACOT.write("jobs_reference_table.h5");
+    GasTable pooled("tacot24", "jobs_gas_table.h5");
+    GasTable reference("tacot24", "jobs_reference_table.h5");
+    REQUIRE(pooled.enthalpy->sameAxes(*reference.enthalpy));
+    for (int j = 0; j < reference.enthalpy->ny; j++) {
+        for (int i = 0; i < reference.enthalpy->nx; i++) {
+            REQUIRE((*pooled.enthalpy->z)(i, j) == (*reference.enthalpy->z)(i, j));
+            REQUIRE((*pooled.viscosity->z)(i, j) == (*reference.viscosity->z)(i, j));
+        }
+    }
+
+    GasTable air("air", "jobs_default_table.h5");
+    REQUIRE(air.enthalpy->nx == 15);
+    REQUIRE(air.enthalpy->x[14] == 3000.0);
+}
+
+TEST_CASE("5: Streamed tables keep only the species above the threshold.", "[GasMixture]") {
+
+    // CO exceeds the threshold below 2000 K only, N2 nowhere.
+    std::string gas_mixture = "tacot24";
+    std::remove("written_species.h5");
+    std::remove("streamed_species.h5");
+    GasMixture written(gas_mixture, 300, 3000, 12, "linear", 1.0e2, 1.0e6, 4, "log10", "Wilke", "Wilke",
+                       1, 0.495);
+    written.write("written_species.h5");
+    GasMixture streamed(gas_mixture, 300, 3000, 12, "linear", 1.0e2, 1.0e6, 4, "log10", "Wilke", "Wilke",
+                        1, 0.495, "", 0, -1, "", false, false);
+    streamed.stream("streamed_species.h5");
+
+    // The species are filtered before they reach the database.
+    REQUIRE(!std::ifstream("streamed_species.h5.species.tmp").good());
+    {
+        H5File file("streamed_species.h5", H5F_ACC_RDONLY);
+        Group species = file.openGroup("tacot24/species");
+        REQUIRE(H5Lexists(species.getId(), "N2", H5P_DEFAULT) == 0);
+        REQUIRE(H5Lexists(species.getId(), "CO", H5P_DEFAULT) > 0);
+    }
+
+    GasTable expected(gas_mixture, "written_species.h5");
+    GasTable table(gas_mixture, "streamed_species.h5");
+    REQUIRE(table.species_names == expected.species_names);
+    for (size_t s = 0; s < table.species.size(); s++) { 
+        REQUIRE(table.species[s]->nx == expected.species[s]->nx);
+        for (double T = 300.0; T <= 3000.0; T += 150.0) { 
+            REQUIRE(table.species[s]->interpolate(T, 5.0e3) == Approx(expected.species[s]->interpolate(T, 5.0e3)));
+        }
+    }
+}
+
+TEST_CASE("6: Pool tasks are costed from profiled point times.", "[GasMixture]") {
+
+    // Points above 1000 K took ten times longer.
+    std::vector<double> T = {300.0, 600.0, 1000.0, 2000.0, 3000.0};
+    std::vector<double> p = {1.0e3, 1.0e5};
+    GenerationProfile costs;
+    REQUIRE(costs.meanPointCost(300.0, 3000.0) == 0.0);
+    costs.reset(T, p, 1);
+    for (int j = 0; j < 2; j++) { 
+        for (int i = 0; i < 5; i++) costs.recordPoint(j, i, (T[i] > 1000.0) ? 0.008 : 0.0008, (T[i] > 1000.0) ? 0.002 : 0.0002);
+    }
+    REQUIRE(costs.meanPointCost(300.0, 600.0) == Approx(0.001));
+    REQUIRE(costs.meanPointCost(2500.0, 2600.0) == Approx(0.01));
+    REQUIRE(costs.meanPointCost(800.0, 1500.0) == Approx((0.001 + 0.001 + 0.01) / 3.0));
+    REQUIRE(costs.meanPointCost(5000.0, 6000.0) == Approx(0.01));
+
+    // The profile of an earlier run is read back from its report.
+    std::stringstream json;
+    costs.writeJson(json, "tacot24");
+    GenerationProfile restored;
+    restored.readJson(json);
+    REQUIRE(restored.computedPoints() == 10);
+    REQUIRE(restored.meanPointCost(300.0, 600.0) == Approx(0.001));
+    REQUIRE(restored.meanPointCost(2500.0, 2600.0) == Approx(0.01));
+    std::istringstream bad("{\"heatmap\": {\"temperature\": [1, 2], \"pressure\": [1], \"seconds\": [[1]]}}");
+    REQUIRE_THROWS_AS(restored.readJson(bad), std::runtime_error);
+
+    // The cost model only orders the tasks: the tables are unchanged.
+    std::string gas_mixture = "tacot24";
+    GasMixture costed(gas_mixture, 300, 3000, 20, "linear", 1.0e3, 1.0e5, 2, "log10", "Wilke", "Wilke",
+                      1, -1.0, "", 0, -1, "", false, false);
+    GasMixture plain(gas_mixture, 300, 3000, 20, "linear", 1.0e3, 1.0e5, 2, "log10", "Wilke", "Wilke",
+                     1, -1.0, "", 0, -1, "", false, false);
+    costed.setCostProfile(restored);
+    GasMixture::computeAll({&costed, &plain}, 3, 4);
+    costed.write("costed_gas_table.h5");
+    plain.write("plain_gas_table.h5");
+    GasTable a(gas_mixture, "costed_gas_table.h5");
+    GasTable b(gas_mixture, "plain_gas_table.h5");
+    for (int j = 0; j < 2; j++) { 
+        for (int i = 0; i < 20; i++) REQUIRE((*a.enthalpy->z)(i, j) == (*b.enthalpy->z)(i, j));
+    }
+}
+
+TEST_CASE("7: A checkpoint is not resumed with another species threshold.", "[GasMixture]") {
+
+    // The checkpoint is left behind since the first table is not written.
+    std::string gas_mixture = "tacot24";
+    std::remove("threshold.checkpoint");
+    {
+        GasMixture interrupted(gas_mixture, 300, 3000, 12, "linear", 1.0e2, 1.0e6, 4, "log10", "Wilke", "Wilke",
+                               1, 0.495, "", 0, -1, "threshold.checkpoint");
+    }
+    GasMixture resumed(gas_mixture, 300, 3000, 12, "linear", 1.0e2, 1.0e6, 4, "log10", "Wilke", "Wilke",
+                       1, 0.1, "", 0, -1, "threshold.checkpoint", true);
+    resumed.write("resumed_species.h5");
+    GasMixture fresh(gas_mixture, 300, 3000, 12, "linear", 1.0e2, 1.0e6, 4, "log10", "Wilke", "Wilke",
+                     1, 0.1);
+    fresh.write("fresh_species.h5");
+
+    GasTable expected(gas_mixture, "fresh_species.h5");
+    GasTable table(gas_mixture, "resumed_species.h5");
+    REQUIRE(table.species_names == expected.species_names);
+    for (size_t s = 0; s < table.species.size(); s++) { 
+        for (double T = 300.0; T <= 3000.0; T += 150.0) { 
+            REQUIRE(table.species[s]->interpolate(T, 5.0e3) == expected.species[s]->interpolate(T, 5.0e3));
+        }
+    }
+}
+
 // TEST_CASE("3: Load a pyrolysis gas mixture database.", "[GasMixture]") {
 
 //     std::string gas_mixture = "tacot24";
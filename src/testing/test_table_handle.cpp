@@ -0,0 +1,93 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../table_handle.h"
+
+using namespace IcarusPyro;
+
+namespace {
+
+// Table whose enthalpy and density are both `value` everywhere.
+GasTable* constantTable(double value)
+{
+    GasTable* table = new GasTable("constant");
+    std::vector<double> x = {300.0, 3000.0};
+    std::vector<double> y = {1.0e3, 1.0e5};
+    std::vector<std::vector<double>> z(2, std::vector<double>(2, value));
+    table->load("enthalpy", "temperature", "pressure", "linear", "log10", x, y, z);
+    table->load("density", "temperature", "pressure", "linear", "log10", x, y, z);
+    return table;
+}
+
+} // namespace
+
+TEST_CASE("1: Snapshots keep a replaced table until they are released.", "[GasTableHandle]") {
+
+    GasTableHandle handle(constantTable(1.0), 2);
+    REQUIRE(handle.readers() == 2);
+    REQUIRE(handle.version() == 0);
+
+    {
+        GasTableHandle::Snapshot old = handle.snapshot(0);
+        handle.publish(constantTable(2.0));
+        REQUIRE(handle.version() == 1);
+        REQUIRE(old->enthalpy->interpolate(1000.0, 1.0e4) == 1.0);
+        REQUIRE(handle.snapshot(1)->enthalpy->interpolate(1000.0, 1.0e4) == 2.0);
+        REQUIRE(handle.reclaim() == 1);
+    }
+    REQUIRE(handle.reclaim() == 0);
+
+    REQUIRE_THROWS_AS(handle.publish(nullptr), std::runtime_error);
+    REQUIRE_THROWS_AS(handle.snapshot(2), std::runtime_error);
+    REQUIRE_THROWS_AS(handle.snapshot(-1), std::runtime_error);
+    REQUIRE_THROWS_AS(handle.reload("24sp-tacot-pyro", "no_such_table.h5").get(), std::runtime_error);
+    REQUIRE(handle.snapshot(0)->enthalpy->interpolate(1000.0, 1.0e4) == 2.0);
+
+    std::future<void> reloaded = handle.reload("24sp-tacot-pyro", "gas_table.h5");
+    reloaded.get();
+    REQUIRE(handle.version() == 2);
+    REQUIRE(handle.snapshot(0)->pyrolysis_gas == "24sp-tacot-pyro");
+}
+
+TEST_CASE("2: Readers see consistent tables while they are replaced.", "[GasTableHandle]") {
+
+    const int n_readers = 4;
+    const int n_versions = 200;
+    GasTableHandle handle(constantTable(0.0), n_readers);
+
+    std::atomic<bool> done(false);
+    std::atomic<int> started(0);
+    std::vector<int> failures(n_readers, 0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < n_readers; t++) {
+        readers.emplace_back([&, t]() {
+            double last = 0.0;
+            started++;
+            while (!done.load()) {
+                GasTableHandle::Snapshot table = handle.snapshot(t);
+                double h = table->enthalpy->interpolate(1000.0, 1.0e4);
+                double rho = table->density->interpolate(2000.0, 3.0e4);
+                if (h != rho || h < last) failures[t]++;
+                last = h;
+            }
+        });
+    }
+    while (started.load() < n_readers) std::this_thread::yield();
+    for (int v = 1; v <= n_versions; v++) {
+        handle.publish(constantTable(v));
+        std::this_thread::yield();
+    }
+    done.store(true);
+    for (size_t t = 0; t < readers.size(); t++) readers[t].join();
+
+    for (int t = 0; t < n_readers; t++) {
+        REQUIRE(failures[t] == 0);
+    }
+    REQUIRE(handle.version() == n_versions);
+    REQUIRE(handle.reclaim() == 0);
+    REQUIRE(handle.snapshot(0)->enthalpy->interpolate(1000.0, 1.0e4) == n_versions);
+}
@@ -0,0 +1,168 @@
+#include <cstdio>
+#include <iostream>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../gas_table.h"
+#include "../pyrolysis_gas.h"
+#include "../table_merge.h"
+#include "../table_provenance.h"
+
+using namespace IcarusPyro;
+
+namespace { 
+
+// Write rows [first, last] of a synthetic 3 x 4 table as a shard. The 
+// species H2 is nonzero only at (1000 K, 1e3 Pa) and N2 is zero everywhere.
+void writeShard(const std::string& database, int first, int last, double x_shift = 0.0)
+{
+    std::vector<double> x = {300.0 + x_shift, 1000.0, 3000.0};
+    std::vector<double> p = {1.0e2, 1.0e3, 1.0e4, 1.0e5};
+    std::vector<double> y(p.begin() + first, p.begin() + last + 1);
+    std::vector<std::vector<double>> z(y.size(), std::vector<double>(x.size()));
+    for (size_t j = 0; j < y.size(); j++) { 
+        for (size_t i = 0; i < x.size(); i++) { 
+            z[j][i] = 10.0 * (first + j) + i;
+        }
+    }
+
+    std::remove(database.c_str());
+    GasTable table("shard-mixture");
+    table.load("enthalpy", "temperature", "pressure", "linear", "log10", x, y, z);
+    table.load("density", "temperature", "pressure", "linear", "log10", x, y, z);
+    table.loadSpecies("CO", "temperature", "pressure", "linear", "log10", x, y, z);
+    std::vector<std::vector<double>> zero(y.size(), std::vector<double>(x.size(), 0.0));
+    std::vector<std::vector<double>> H2 = zero;
+    if (first <= 1 && last >= 1) H2[1 - first][1] = 0.5;
+    table.loadSpecies("H2", "temperature", "pressure", "linear", "log10", x, y, H2);
+    table.loadSpecies("N2", "temperature", "pressure", "linear", "log10", x, y, zero);
+    table.write(database);
+    writeShardInfo(database, "shard-mixture", first, p.size());
+}
+
+} // namespace
+
+TEST_CASE("1: Shards merge into the full table.", "[TableMerge]") {
+
+    writeShard("shard_0.h5", 0, 0);
+    writeShard("shard_1.h5", 1, 2);
+    writeShard("shard_2.h5", 3, 3);
+
+    std::remove("merged_table.h5");
+    std::vector<std::string> shards = {"shard_2.h5", "shard_0.h5", "shard_1.h5"};
+    mergeShards(shards, "merged_table.h5");
+
+    GasTable merged("shard-mixture", "merged_table.h5");
+    REQUIRE(merged.enthalpy->nx == 3);
+    REQUIRE(merged.enthalpy->ny == 4);
+    REQUIRE(merged.enthalpy->y_scale == "log10");
+    REQUIRE(merged.enthalpy->y[3] == 1.0e5);
+    for (int j = 0; j < 4; j++) { 
+        for (int i = 0; i < 3; i++) { 
+            REQUIRE((*merged.enthalpy->z)(i, j) == 10.0 * j + i);
+            REQUIRE((*merged.density->z)(i, j) == 10.0 * j + i);
+        }
+    }
+    REQUIRE(merged.speciesIndex("CO") == 0);
+    REQUIRE((*merged.species[0]->z)(2, 3) == 32.0);
+
+    // The species threshold applies to the merged table: H2, present in one
+    // shard only, is kept on its compact support and N2 is dropped.
+    REQUIRE(merged.species.size() == 2);
+    REQUIRE(merged.speciesIndex("N2") < 0);
+    TableEntry<double>* H2 = merged.species[merged.speciesIndex("H2")];
+    REQUIRE(H2->nx == 3);
+    REQUIRE(H2->ny == 3);
+    REQUIRE(H2->interpolate(1000.0, 1.0e3) == Approx(0.5));
+    REQUIRE(H2->interpolate(300.0, 1.0e5) == 0.0);
+
+    {
+        H5File file("merged_table.h5", H5F_ACC_RDONLY);
+        Group gas = file.openGroup("shard-mixture");
+        REQUIRE(!isShard(&gas));
+    }
+    {
+        H5File file("shard_1.h5", H5F_ACC_RDONLY);
+        Group gas = file.openGroup("shard-mixture");
+        REQUIRE(isShard(&gas));
+    }
+
+    // Missing rows, overlapping rows and mismatched axes are rejected.
+    shards = {"shard_0.h5", "shard_2.h5"};
+    REQUIRE_THROWS_AS(mergeShards(shards, "merged_table.h5"), std::runtime_error);
+    shards = {"shard_0.h5", "shard_1.h5", "shard_1.h5", "shard_2.h5"};
+    REQUIRE_THROWS_AS(mergeShards(shards, "merged_table.h5"), std::runtime_error);
+    writeShard("shard_1.h5", 1, 2, 1.0);
+    shards = {"shard_0.h5", "shard_1.h5", "shard_2.h5"};
+    REQUIRE_THROWS_AS(mergeShards(shards, "merged_table.h5"), std::runtime_error);
+}
+
+TEST_CASE("2: Merged gas mixture shards equal a single run.", "[TableMerge]") {
+
+    // CO exceeds the threshold below 2000 K only, N2 nowhere.
+    const double threshold = 0.495;
+    std::string mixture = "tacot24";
+    std::remove("single_run.h5");
+    GasMixture single(mixture, 300, 3000, 12, "linear", 1.0e2, 1.0e6, 5, "log10", "Wilke", "Wilke",
+                      1, threshold);
+    single.write("single_run.h5");
+
+    std::vector<std::string> shards = {"run_shard_0.h5", "run_shard_1.h5", "run_shard_2.h5"};
+    const int rows[3][2] = {{0, 1}, {2, 2}, {3, 4}};
+    for (int k = 0; k < 3; k++) { 
+        std::remove(shards[k].c_str());
+        GasMixture shard(mixture, 300, 3000, 12, "linear", 1.0e2, 1.0e6, 5, "log10", "Wilke", "Wilke",
+                         1, threshold, "", rows[k][0], rows[k][1]);
+        shard.write(shards[k]);
+    }
+    std::remove("merged_run.h5");
+    mergeShards(shards, "merged_run.h5");
+
+    // A full-range run records its rows like any shard.
+    {
+        H5File file("single_run.h5", H5F_ACC_RDONLY);
+        Group gas = file.openGroup(mixture);
+        int first_row = -1, total_rows = -1;
+        gas.openAttribute("first_row").read(PredType::NATIVE_INT, &first_row);
+        gas.openAttribute("total_rows").read(PredType::NATIVE_INT, &total_rows);
+        REQUIRE(first_row == 0);
+        REQUIRE(total_rows == 5);
+        REQUIRE(!isShard(&gas));
+    }
+
+    GasTable expected(mixture, "single_run.h5");
+    GasTable merged(mixture, "merged_run.h5");
+    REQUIRE(expected.speciesIndex("N2") < 0);
+    REQUIRE(expected.speciesIndex("CO") >= 0);
+    REQUIRE(merged.species.size() == expected.species.size());
+    for (double T = 300.0; T <= 3000.0; T += 135.0) { 
+        for (double p = 1.0e2; p <= 1.0e6; p *= 3.0) { 
+            GasProperties a, b;
+            expected.lookup(T, p, a);
+            merged.lookup(T, p, b);
+            REQUIRE(b.enthalpy == a.enthalpy);
+            REQUIRE(b.density == a.density);
+            REQUIRE(b.viscosity == a.viscosity);
+            for (size_t s = 0; s < expected.species.size(); s++) { 
+                int m = merged.speciesIndex(expected.species_names[s]);
+                REQUIRE(m >= 0);
+                REQUIRE(merged.species[m]->interpolate(T, p) == expected.species[s]->interpolate(T, p));
+            }
+        }
+    }
+
+    // Shards of runs with different parameters are rejected.
+    {
+        H5File file(shards[1], H5F_ACC_RDWR);
+        Group gas = file.openGroup(mixture);
+        TableProvenance provenance;
+        REQUIRE(readProvenance(&gas, provenance));
+        provenance.species_threshold = 0.1;
+        writeProvenance(&gas, provenance);
+    }
+    REQUIRE_THROWS_AS(mergeShards(shards, "merged_run.h5"), std::runtime_error);
+}
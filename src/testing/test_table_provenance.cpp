@@ -0,0 +1,141 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../generation_jobs.h"
+#include "../gas_table.h"
+#include "../memo_cache.h"
+#include "../pyrolysis_gas.h"
+#include "../table_merge.h"
+#include "../table_provenance.h"
+
+using namespace IcarusPyro;
+
+namespace {
+
+herr_t printNothing(hid_t, void*)
+{
+    return 0;
+}
+
+} // namespace
+
+TEST_CASE("1: Written tables record their provenance.", "[TableProvenance]") {
+
+    std::remove("provenance_gas_table.h5");
+    std::string gas_mixture = "tacot24";
+    GasMixture TACOT(gas_mixture, 300, 3000, 10, "linear", 1.01325, 1013250, 3, "log10", "Wilke", "Wilke");
+    const TableProvenance& provenance = TACOT.provenance();
+    REQUIRE(provenance.generation_key.size() == 16);
+    REQUIRE(provenance.mixture_hash.size() == 16);
+    REQUIRE(std::stoull(provenance.mixture_hash, nullptr, 16) == hashMixtureData(gas_mixture));
+    REQUIRE(provenance.nT == 10);
+    REQUIRE(provenance.nP == 3);
+
+    // Probing a missing database keeps the HDF5 error printing of the caller.
+    H5E_auto2_t saved_function;
+    void* saved_data;
+    Exception::getAutoPrint(saved_function, &saved_data);
+    H5E_auto2_t print_function = printNothing;
+    int print_data = 0;
+    Exception::setAutoPrint(print_function, &print_data);
+    REQUIRE(!tableUpToDate("provenance_gas_table.h5", "tacot24", provenance));
+    H5E_auto2_t probed_function = nullptr;
+    void* probed_data = nullptr;
+    Exception::getAutoPrint(probed_function, &probed_data);
+    Exception::setAutoPrint(saved_function, saved_data);
+    REQUIRE(probed_function == print_function);
+    REQUIRE(probed_data == &print_data);
+
+    TACOT.write("provenance_gas_table.h5");
+    REQUIRE(tableUpToDate("provenance_gas_table.h5", "tacot24", provenance));
+    REQUIRE(!tableUpToDate("provenance_gas_table.h5", "other", provenance));
+
+    H5File file("provenance_gas_table.h5", H5F_ACC_RDONLY);
+    Group gas = file.openGroup("tacot24");
+    TableProvenance stored;
+    REQUIRE(readProvenance(&gas, stored));
+    REQUIRE(stored.matches(provenance));
+    REQUIRE(stored.generation_key == provenance.generation_key);
+    REQUIRE(stored.mixture_hash == provenance.mixture_hash);
+    REQUIRE(stored.elemental_fractions == provenance.elemental_fractions);
+    REQUIRE(stored.viscosity_algorithm == "Wilke");
+    REQUIRE(stored.T_low == 300.0);
+    REQUIRE(stored.p_high == 1013250.0);
+    REQUIRE(stored.p_scale == "log10");
+    REQUIRE(stored.species_threshold == -1.0);
+
+    TableProvenance other = provenance;
+    other.nT = 11;
+    REQUIRE(!stored.matches(other));
+    other = provenance;
+    other.generation_key = "0000000000000000";
+    REQUIRE(!stored.matches(other));
+
+    // Shards are never up to date; the merged table is.
+    GasMixture shard0(gas_mixture, 300, 3000, 10, "linear", 1.01325, 1013250, 3, "log10", "Wilke", "Wilke",
+                      1, -1.0, "", 0, 0);
+    GasMixture shard1(gas_mixture, 300, 3000, 10, "linear", 1.01325, 1013250, 3, "log10", "Wilke", "Wilke",
+                      1, -1.0, "", 1, 2);
+    shard0.write("provenance_shard_0.h5");
+    shard1.write("provenance_shard_1.h5");
+    REQUIRE(!tableUpToDate("provenance_shard_0.h5", "tacot24", provenance));
+    mergeShards({"provenance_shard_0.h5", "provenance_shard_1.h5"}, "provenance_merged.h5");
+    REQUIRE(tableUpToDate("provenance_merged.h5", "tacot24", provenance));
+}
+
+TEST_CASE("2: Tables are generated only when the database is out of date.", "[TableProvenance]") {
+
+    std::remove("ensure_gas_table.h5");
+    GenerationJob job;
+    job.mixture = "tacot24";
+    job.database = "ensure_gas_table.h5";
+    job.T_low = 300.0;
+    job.T_high = 3000.0;
+    job.nT = 8;
+    job.nP = 3;
+
+    bool generated = false;
+    GasTable first = ensureGasTable(job, "Wilke", "Wilke", 1, "", &generated);
+    REQUIRE(generated);
+    REQUIRE(first.enthalpy->nx == 8);
+
+    GasTable second = ensureGasTable(job, "Wilke", "Wilke", 1, "", &generated);
+    REQUIRE(!generated);
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < 8; i++) REQUIRE((*second.enthalpy->z)(i, j) == (*first.enthalpy->z)(i, j));
+    }
+
+    job.nT = 9;
+    GasTable third = ensureGasTable(job, "Wilke", "Wilke", 1, "", &generated);
+    REQUIRE(generated);
+    REQUIRE(third.enthalpy->nx == 9);
+
+    ensureGasTable(job, "Gupta-Yos", "Wilke", 1, "", &generated);
+    REQUIRE(generated);
+
+    // Job lists skip the tables already up to date: a regenerated group
+    // would lose the marker attribute.
+    {
+        H5File file("ensure_gas_table.h5", H5F_ACC_RDWR);
+        Group gas = file.openGroup("tacot24");
+        int marker = 1;
+        Attribute attr = gas.createAttribute("marker", PredType::NATIVE_INT, DataSpace(H5S_SCALAR));
+        attr.write(PredType::NATIVE_INT, &marker);
+    }
+    std::vector<GenerationJob> jobs(1, job);
+    runJobs(jobs, "Gupta-Yos", "Wilke", 1, 16, "", true);
+    {
+        H5File file("ensure_gas_table.h5", H5F_ACC_RDONLY);
+        Group gas = file.openGroup("tacot24");
+        REQUIRE(gas.attrExists("marker"));
+    }
+    runJobs(jobs, "Wilke", "Wilke", 1, 16, "", true);
+    {
+        H5File file("ensure_gas_table.h5", H5F_ACC_RDONLY);
+        Group gas = file.openGroup("tacot24");
+        REQUIRE(!gas.attrExists("marker"));
+    }
+}
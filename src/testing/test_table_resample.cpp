@@ -0,0 +1,138 @@
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../grid.h"
+#include "../table_resample.h"
+
+using namespace IcarusPyro;
+
+TEST_CASE("1: Uniform axes locate cells without searching.", "[TableResample]") {
+
+    REQUIRE(powerOfTwoPoints(2) == 2);
+    REQUIRE(powerOfTwoPoints(3) == 3);
+    REQUIRE(powerOfTwoPoints(4) == 5);
+    REQUIRE(powerOfTwoPoints(17) == 17);
+    REQUIRE(powerOfTwoPoints(18) == 33);
+
+    std::vector<double> T, p;
+    makeRange(300.0, 4000.0, 38, "linear", T);
+    makeRange(1.0, 1.0e6, 25, "log10", p);
+    TableEntry<double> table(T.size(), p.size(), "temperature", "pressure", "linear", "log10");
+    std::copy(T.begin(), T.end(), table.x);
+    std::copy(p.begin(), p.end(), table.y);
+    REQUIRE_FALSE(table.uniformX());
+    table.detectUniformAxes();
+    REQUIRE(table.uniformX());
+    REQUIRE(table.uniformY());
+
+    // The direct cell is the searched one, at random points and at the nodes.
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> unit(-0.05, 1.05);
+    std::vector<double> xs(T), ys(p);
+    for (int k = 0; k < 2000; k++) {
+        xs.push_back(300.0 + unit(generator) * 3700.0);
+        ys.push_back(std::pow(10.0, 6.0 * unit(generator)));
+    }
+    for (size_t k = 0; k < xs.size(); k++) {
+        double y = ys[k % ys.size()];
+        TableIndex idx = table.locate(xs[k], y);
+        int i, j;
+        double wx, wy, dwx, dwy;
+        TableEntry<double>::locateAxis(table.x, table.nx, false, xs[k], i, wx, dwx);
+        TableEntry<double>::locateAxis(table.y, table.ny, true, y, j, wy, dwy);
+        REQUIRE(idx.i == i);
+        REQUIRE(idx.j == j);
+        REQUIRE(idx.wx == wx);
+        REQUIRE(idx.wy == wy);
+    }
+
+    table.x[5] += 1.0;
+    table.detectUniformAxes();
+    REQUIRE_FALSE(table.uniformX());
+    REQUIRE(table.uniformY());
+}
+
+TEST_CASE("2: Cubic resampling is accurate and does not overshoot.", "[TableResample]") {
+
+    std::vector<double> T = {300.0, 450.0, 800.0, 1000.0, 1700.0, 2500.0, 4000.0};
+    std::vector<double> p = {1.0, 30.0, 1.0e3, 1.0e5};
+    TableEntry<double> table(T.size(), p.size(), "temperature", "pressure", "linear", "log10");
+    std::copy(T.begin(), T.end(), table.x);
+    std::copy(p.begin(), p.end(), table.y);
+    auto f = [](double x, double y) { return 2.0 * x + 5.0 * std::log10(y); };
+    for (size_t i = 0; i < T.size(); i++) {
+        for (size_t j = 0; j < p.size(); j++) (*table.z)(i, j) = f(T[i], p[j]);
+    }
+
+    REQUIRE(cubicInterpolate(table, 800.0, 30.0) == Approx(f(800.0, 30.0)));
+    REQUIRE(cubicInterpolate(table, 1234.0, 456.0) == Approx(f(1234.0, 456.0)));
+    REQUIRE(cubicInterpolate(table, 3900.0, 2.0) == Approx(f(3900.0, 2.0)));
+    REQUIRE(cubicInterpolate(table, 5000.0, 1.0e6) == Approx(f(4000.0, 1.0e5)));
+
+    std::vector<double> x, y;
+    makeRange(300.0, 4000.0, 9, "linear", x);
+    makeRange(1.0, 1.0e5, 6, "log10", y);
+    std::unique_ptr<TableEntry<double>> uniform(resampleEntry(table, x, "linear", y, "log10"));
+    REQUIRE(uniform->uniformX());
+    REQUIRE(uniform->uniformY());
+    for (size_t i = 0; i < x.size(); i++) {
+        for (size_t j = 0; j < y.size(); j++) REQUIRE((*uniform->z)(i, j) == Approx(f(x[i], y[j])));
+    }
+
+    // Smooth data are resolved to higher order than by linear interpolation.
+    auto g = [](double x, double y) { return std::sin(x / 700.0) + std::log10(y); };
+    for (size_t i = 0; i < T.size(); i++) {
+        for (size_t j = 0; j < p.size(); j++) (*table.z)(i, j) = g(T[i], p[j]);
+    }
+    double cubic = std::abs(cubicInterpolate(table, 1350.0, 30.0) - g(1350.0, 30.0));
+    double linear = std::abs(table.interpolate(1350.0, 30.0) - g(1350.0, 30.0));
+    REQUIRE(cubic < 0.5 * linear);
+
+    // A step stays within the data on either side.
+    for (size_t i = 0; i < T.size(); i++) {
+        for (size_t j = 0; j < p.size(); j++) (*table.z)(i, j) = (T[i] < 1000.0) ? 1.0 : 10.0;
+    }
+    for (double xp = 300.0; xp <= 4000.0; xp += 25.0) {
+        double value = cubicInterpolate(table, xp, 30.0);
+        REQUIRE(value >= 1.0 - 1.0e-12);
+        REQUIRE(value <= 10.0 + 1.0e-12);
+    }
+}
+
+TEST_CASE("3: Resample a gas table onto a uniform grid.", "[TableResample]") {
+
+    GasTable source("24sp-tacot-pyro", "gas_table.h5");
+    const TableEntry<double>& h = *source.enthalpy;
+    std::vector<double> T, p;
+    makeRange(h.x[0], h.x[h.nx-1], powerOfTwoPoints(2 * h.nx), "linear", T);
+    makeRange(h.y[0], h.y[h.ny-1], powerOfTwoPoints(4 * h.ny), "log10", p);
+
+    ValidationReport report;
+    GasTable table = resampleTable(source, T, "linear", p, "log10", report);
+    REQUIRE(report.points > h.nx * h.ny);
+    REQUIRE(!report.properties.empty());
+    for (size_t k = 0; k < report.properties.size(); k++) {
+        REQUIRE(report.properties[k].rms_error <= report.properties[k].max_error);
+        // The enthalpy crosses zero, so its worst relative error is large.
+        if (report.properties[k].name == "enthalpy") REQUIRE(report.properties[k].rms_error < 0.02);
+        if (report.properties[k].name == "viscosity") REQUIRE(report.properties[k].max_error < 0.01);
+    }
+    REQUIRE(table.species_names == source.species_names);
+    REQUIRE(table.enthalpy->nx == static_cast<int>(T.size()));
+    REQUIRE(table.enthalpy->uniformX());
+
+    table.write("resampled_gas_table.h5");
+    GasTable loaded("24sp-tacot-pyro", "resampled_gas_table.h5");
+    REQUIRE(loaded.enthalpy->uniformX());
+    REQUIRE(loaded.enthalpy->uniformY());
+    GasProperties a, b;
+    table.lookup(1234.5, 2.0e4, a);
+    loaded.lookup(1234.5, 2.0e4, b);
+    REQUIRE(a.enthalpy == b.enthalpy);
+    REQUIRE(a.enthalpy == Approx(source.enthalpy->interpolate(1234.5, 2.0e4)).epsilon(0.05));
+}
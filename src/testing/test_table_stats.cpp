@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../gas_table.h"
+#include "../table_stats.h"
+
+using namespace IcarusPyro;
+
+TEST_CASE("1: Lookup counters are summed over threads.", "[TableStats]") {
+
+    std::vector<double> x = {300.0, 1000.0, 2000.0, 3000.0, 4000.0};
+    std::vector<double> y = {1.0e3, 1.0e5};
+    TableStats stats(x, y, 2);
+    REQUIRE(stats.binsX() == 2);
+    REQUIRE(stats.binsY() == 1);
+
+    TableEntry<double> table(5, 2, "temperature", "pressure", "linear", "log10");
+    std::copy(x.begin(), x.end(), table.x);
+    std::copy(y.begin(), y.end(), table.y);
+
+    auto work = [&]() { 
+        for (int k = 0; k < 100; k++) { 
+            stats.recordLookup(500.0, 1.0e4, table.locate(500.0, 1.0e4));
+        }
+        stats.recordLookup(5000.0, 10.0, table.locate(5000.0, 10.0));
+        stats.recordFallback();
+    };
+    std::thread t1(work), t2(work);
+    t1.join();
+    t2.join();
+
+    LookupCounters sum = stats.total();
+    REQUIRE(sum.lookups == 202);
+    REQUIRE(sum.fallbacks == 2);
+    REQUIRE(sum.x_above == 2);
+    REQUIRE(sum.x_below == 0);
+    REQUIRE(sum.y_below == 2);
+    REQUIRE(sum.cells[0] == 200);
+    REQUIRE(sum.cells[1] == 2);
+
+    std::ostringstream json;
+    stats.writeJson(json);
+    REQUIRE(json.str().find("\"lookups\": 202") != std::string::npos);
+    REQUIRE(json.str().find("\"temperature\": {\"below\": 0, \"above\": 2}") != std::string::npos);
+    REQUIRE(json.str().find("\"temperature_edges\": [300, 2000, 4000]") != std::string::npos);
+
+    stats.reset();
+    REQUIRE(stats.total().lookups == 0);
+
+    // Totals may be taken while other threads record.
+    std::thread t3([&]() { 
+        for (int k = 0; k < 10000; k++) stats.recordLookup(500.0, 1.0e4, table.locate(500.0, 1.0e4));
+    });
+    uint64_t seen = 0;
+    for (int k = 0; k < 100; k++) { 
+        uint64_t n = stats.total().lookups;
+        REQUIRE(n >= seen);
+        seen = n;
+    }
+    t3.join();
+    REQUIRE(stats.total().lookups == 10000);
+}
+
+TEST_CASE("3: Threads drop the counters of destroyed tables.", "[TableStats]") {
+
+    std::vector<double> x = {300.0, 1000.0};
+    std::vector<double> y = {1.0e3, 1.0e5};
+    TableEntry<double> table(2, 2, "temperature", "pressure", "linear", "log10");
+    std::copy(x.begin(), x.end(), table.x);
+    std::copy(y.begin(), y.end(), table.y);
+
+    // Catch assertions are not thread safe: the worker only records.
+    size_t most_tables = 0, tables_alive = 0;
+    uint64_t fallbacks = 0;
+    std::thread worker([&]() { 
+        for (int k = 0; k < 100; k++) { 
+            TableStats stats(x, y);
+            stats.recordLookup(500.0, 1.0e4, table.locate(500.0, 1.0e4));
+            most_tables = std::max(most_tables, TableStats::threadTables());
+        }
+        TableStats kept(x, y);
+        kept.recordFallback();
+        {
+            TableStats other(x, y);
+            other.recordFallback();
+            tables_alive = TableStats::threadTables();
+        }
+        fallbacks = kept.total().fallbacks;
+    });
+    worker.join();
+    REQUIRE(most_tables == 1);
+    REQUIRE(tables_alive == 2);
+    REQUIRE(fallbacks == 1);
+}
+
+TEST_CASE("2: Gas table lookups are instrumented on request.", "[GasTable]") {
+
+    GasTable table("24sp-tacot-pyro", "gas_table.h5");
+    GasProperties props;
+    table.lookup(1000.0, 101325.0, props);
+    table.lookup(1.0e5, 101325.0, props);
+
+#ifdef ICARUSPYRO_INSTRUMENT
+    REQUIRE(table.statistics() != nullptr);
+    REQUIRE(table.statistics()->total().lookups == 2);
+    REQUIRE(table.statistics()->total().x_above == 1);
+#else
+    REQUIRE(table.statistics() == nullptr);
+#endif
+}
@@ -0,0 +1,110 @@
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "../pyrolysis_gas.h"
+#include "../table_validation.h"
+
+using namespace IcarusPyro;
+
+TEST_CASE("1: Validation points are cell midpoints followed by random points.", "[TableValidation]") {
+
+    TableEntry<double> table(3, 2, "temperature", "pressure", "linear", "log10");
+    table.x[0] = 300.0;
+    table.x[1] = 1000.0;
+    table.x[2] = 2000.0;
+    table.y[0] = 1.0e2;
+    table.y[1] = 1.0e4;
+
+    std::vector<std::pair<double, double>> points = validationPoints(table, 10, 7);
+    REQUIRE(points.size() == 12);
+    REQUIRE(points[0].first == Approx(650.0));
+    REQUIRE(points[1].first == Approx(1500.0));
+    REQUIRE(points[0].second == Approx(1.0e3));
+    for (size_t k = 2; k < points.size(); k++) {
+        REQUIRE(points[k].first >= 300.0);
+        REQUIRE(points[k].first <= 2000.0);
+        REQUIRE(points[k].second >= 1.0e2);
+        REQUIRE(points[k].second <= 1.0e4);
+    }
+
+    std::vector<std::pair<double, double>> again = validationPoints(table, 10, 7);
+    REQUIRE(again == points);
+}
+
+TEST_CASE("2: Validate a generated table against direct equilibrium.", "[TableValidation]") {
+
+    // A grid fine enough for linear interpolation to be accurate to well 
+    // under 1% in every property.
+    std::string gas_mixture = "tacot24";
+    GasMixture TACOT(gas_mixture, 1000, 2000, 101, "linear", 1.0e4, 1.0e5, 21, "log10", "Wilke");
+    TACOT.write("validate_gas_table.h5");
+
+    GasTable table(gas_mixture, "validate_gas_table.h5");
+    const double tolerance = 1.0e-2;
+    ValidationReport report = validateTable(table, gas_mixture, "Wilke", "Wilke", 50, 4);
+    REQUIRE(report.points == 100 * 20 + 50);
+    REQUIRE(report.properties.size() == 9);
+    for (size_t k = 0; k < report.properties.size(); k++) {
+        const PropertyError& e = report.properties[k];
+        REQUIRE(e.rms_error <= e.max_error);
+        REQUIRE(e.max_error < tolerance);
+    }
+    REQUIRE(report.passed(tolerance));
+
+    // A table 5% off in density must fail.
+    for (int j = 0; j < table.density->ny; j++) {
+        for (int i = 0; i < table.density->nx; i++) (*table.density->z)(i, j) *= 1.05;
+    }
+    ValidationReport off = validateTable(table, gas_mixture, "Wilke", "Wilke", 50, 4);
+    REQUIRE_FALSE(off.passed(tolerance));
+    for (size_t k = 0; k < off.properties.size(); k++) {
+        const PropertyError& e = off.properties[k];
+        if (e.name == "density") {
+            REQUIRE(e.max_error > 0.04);
+            REQUIRE(e.max_error < 0.06);
+        } else {
+            REQUIRE(e.max_error == report.properties[k].max_error);
+        }
+    }
+
+    std::ostringstream out;
+    off.print(out, tolerance);
+    REQUIRE(out.str().find("density") != std::string::npos);
+    REQUIRE(out.str().find("FAIL") != std::string::npos);
+}
+
+TEST_CASE("3: Errors are relative to the reference above the error floor.", "[TableValidation]") {
+
+    TableEntry<double> table(2, 1, "temperature", "pressure", "linear", "linear");
+    (*table.z)(0, 0) = -2.0e6;
+    (*table.z)(1, 0) = 1.0e6;
+    REQUIRE(errorFloor(table) == Approx(2.0));
+
+    std::vector<std::pair<double, double>> points = {{300.0, 1.0e5}, {400.0, 1.0e5}, {500.0, 1.0e4}};
+    std::vector<double> references = {100.0, 0.0, -50.0};
+    std::vector<double> values = references;
+    PropertyError exact = compareTables("enthalpy", points, values.data(), references.data(), 2.0);
+    REQUIRE(exact.name == "enthalpy");
+    REQUIRE(exact.max_error == 0.0);
+    REQUIRE(exact.rms_error == 0.0);
+
+    // 1% off at the first point, 1 below a zero reference (floor 2) and 
+    // 10% off at the last point.
+    values = {101.0, 1.0, -55.0};
+    PropertyError e = compareTables("enthalpy", points, values.data(), references.data(), 2.0);
+    REQUIRE(e.max_error == Approx(0.5));
+    REQUIRE(e.rms_error == Approx(std::sqrt((0.01 * 0.01 + 0.25 + 0.01) / 3.0)));
+    REQUIRE(e.worst_temperature == 400.0);
+    REQUIRE(e.worst_table == 1.0);
+    REQUIRE(e.worst_reference == 0.0);
+
+    ValidationReport report;
+    report.points = 3;
+    report.properties = {exact, e};
+    REQUIRE(report.passed(0.5));
+    REQUIRE_FALSE(report.passed(0.49));
+}